@@ -7,7 +7,7 @@
 QT       -= core gui
 TEMPLATE = lib
 
-CONFIG += static warn_on
+CONFIG += static warn_on thread
 
 DESTDIR = ../../generated/lib
 
@@ -190,6 +190,17 @@ public:
      */
     virtual void addPlotSettings(const DRW_PlotSettings *data) = 0;
 
+    /**
+     * Called now and then while reading, with the work done so far out of
+     * total: bytes of a DXF file, objects of a DWG file.
+     *
+     * @return false to cancel reading, the read then fails
+     */
+    virtual bool progress(unsigned long long done, unsigned long long total) {
+        (void)done; (void)total;
+        return true;
+    }
+
     virtual void writeHeader(DRW_Header& data) = 0;
     virtual void writeBlocks() = 0;
     virtual void writeBlockRecords() = 0;
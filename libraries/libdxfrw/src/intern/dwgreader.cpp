@@ -16,10 +16,16 @@
 #include <string>
 #include <sstream>
 #include <map>
+#include <future>
 #include "dwgreader.h"
 #include "drw_textcodec.h"
 #include "drw_dbg.h"
 namespace {
+//! lists with less entities are read by a single thread
+constexpr size_t minParallelEntities = 256;
+//! entities decoded per thread in a batch
+constexpr size_t objectsPerThread = 1024;
+
 //helper function to cleanup pointers in Look Up Tables
 template<typename T>
 void mapCleanUp(std::map<duint32, T*>& table)
@@ -777,21 +783,8 @@ bool dwgReader::readDwgBlocks(DRW_Interface& intfa, dwgBuffer* dbuf){
                         nextH = nextEntLink;
                 }
             } else {//2004+
-                for (std::vector<duint32>::iterator it = bkr->entMap.begin() ; it != bkr->entMap.end(); ++it){
-                    duint32 nextH = *it;
-                    mit = ObjectMap.find(nextH);
-                    if (mit==ObjectMap.end()) {
-                        DRW_DBG("\nWARNING: Entity of block not found\n");
-                        ret = false;
-                        continue;
-                    } else {//foud entity reads it
-                        oc = mit->second;
-                        ObjectMap.erase(mit);
-                        DRW_DBG("\nBlocks, parsing entity: "); DRW_DBGH(oc.handle); DRW_DBG(", pos: "); DRW_DBG(oc.loc); DRW_DBG("\n");
-                        ret2 = readDwgEntity(dbuf, oc, intfa);
-                        ret = ret && ret2;
-                    }
-                }
+                ret2 = readDwgEntityList(bkr->entMap, true, intfa, dbuf);
+                ret = ret && ret2;
             }//end 2004+
         }
 
@@ -908,20 +901,124 @@ bool dwgReader::readPlineVertex(DRW_Polyline& pline, dwgBuffer* dbuf){
     return ret;
 }
 
+bool dwgReader::reportProgress(DRW_Interface& intfa){
+    if (objectCount < ObjectMap.size())
+        objectCount = ObjectMap.size();
+    if (!cancelled && !intfa.progress(objectCount - ObjectMap.size(), objectCount))
+        cancelled = true;
+    return !cancelled;
+}
+
 bool dwgReader::readDwgEntities(DRW_Interface& intfa, dwgBuffer* dbuf){
+    DRW_DBG("\nobject map total size= "); DRW_DBG(ObjectMap.size());
+
+    std::vector<duint32> handles;
+    handles.reserve(ObjectMap.size());
+    for (std::map<duint32, objHandle>::iterator it=ObjectMap.begin(); it != ObjectMap.end(); ++it)
+        handles.push_back(it->first);
+    //vertices of polylines are read with their polyline and not found
+    return readDwgEntityList(handles, false, intfa, dbuf);
+}
+
+/**
+ * Reads the entities in handles from ObjectMap and sends them to the
+ * interface in this order. Entities not in ObjectMap are skipped, if
+ * reportMissing is set as failure.
+ *
+ * Long lists are read in batches: the data of a batch are copied from dbuf,
+ * then decoded by several threads while the previous batch is sent.
+ */
+bool dwgReader::readDwgEntityList(const std::vector<duint32>& handles, bool reportMissing,
+                                  DRW_Interface& intfa, dwgBuffer* dbuf){
     bool ret = true;
     bool ret2 = true;
+    unsigned int threads = dwgThreads::count();
 
-    DRW_DBG("\nobject map total size= "); DRW_DBG(ObjectMap.size());
+    if (threads < 2 || handles.size() < minParallelEntities) {
+        for (std::vector<duint32>::const_iterator it = handles.begin(); it != handles.end(); ++it){
+            std::map<duint32, objHandle>::iterator mit = ObjectMap.find(*it);
+            if (mit==ObjectMap.end()) {
+                if (reportMissing) {
+                    DRW_DBG("\nWARNING: Entity not found: "); DRW_DBGH(*it); DRW_DBG("\n");
+                    ret = false;
+                }
+                continue;
+            }
+            objHandle oc = mit->second;
+            ObjectMap.erase(mit);
+            DRW_DBG("\nParsing entity: "); DRW_DBGH(oc.handle); DRW_DBG(", pos: "); DRW_DBG(oc.loc); DRW_DBG("\n");
+            ret2 = readDwgEntity(dbuf, oc, intfa);
+            ret = ret && ret2;
+            if ((it - handles.begin()) % objectsPerThread == 0 && !reportProgress(intfa))
+                return false;
+        }
+        return ret && reportProgress(intfa);
+    }
 
-    std::map<duint32, objHandle>::iterator itB=ObjectMap.begin();
-    std::map<duint32, objHandle>::iterator itE=ObjectMap.end();
-    while (itB != itE){
-        ret2 = readDwgEntity(dbuf, itB->second, intfa);
-        ObjectMap.erase(itB);
-        itB=ObjectMap.begin();
-        if (ret)
-            ret = ret2;
+    struct Decoded {
+        objHandle obj;
+        std::vector<duint8> data;
+        duint32 bs = 0;
+        bool read = false;
+        bool ok = false;
+        std::unique_ptr<DRW_Entity> entity;
+    };
+    size_t next = 0;
+
+    //copies the data of the next batch, dbuf may read from the file
+    auto gather = [&](std::vector<Decoded>& batch) {
+        batch.clear();
+        while (next < handles.size() && batch.size() < objectsPerThread * threads) {
+            batch.emplace_back();
+            Decoded& d = batch.back();
+            std::map<duint32, objHandle>::iterator mit = ObjectMap.find(handles[next]);
+            if (mit==ObjectMap.end()) {
+                d.obj.handle = handles[next];
+            } else {
+                d.obj = mit->second;
+                d.read = readObjectData(dbuf, d.obj, d.data, d.bs);
+            }
+            ++next;
+        }
+    };
+    auto decode = [this](std::vector<Decoded>& batch) {
+        dwgThreads::forEach(batch.size(), [this, &batch](duint32 i) {
+            Decoded& d = batch[i];
+            if (d.read)
+                d.entity = decodeDwgEntity(d.data, d.bs, d.obj, d.ok);
+            std::vector<duint8>().swap(d.data);
+        });
+    };
+    //the entities may have been removed by polylines sent before
+    auto send = [&](std::vector<Decoded>& batch) {
+        for (Decoded& d: batch) {
+            std::map<duint32, objHandle>::iterator mit = ObjectMap.find(d.obj.handle);
+            if (mit==ObjectMap.end()) {
+                if (reportMissing) {
+                    DRW_DBG("\nWARNING: Entity not found: "); DRW_DBGH(d.obj.handle); DRW_DBG("\n");
+                    ret = false;
+                }
+                continue;
+            }
+            ObjectMap.erase(mit);
+            ret2 = d.read && sendDwgEntity(d.entity.get(), d.obj, d.ok, intfa, dbuf);
+            ret = ret && ret2;
+        }
+        batch.clear();
+    };
+
+    std::vector<Decoded> current;
+    std::vector<Decoded> following;
+    gather(current);
+    decode(current);
+    while (!current.empty()) {
+        gather(following);
+        std::future<void> decoded = std::async(std::launch::async, decode, std::ref(following));
+        send(current);
+        decoded.get();
+        std::swap(current, following);
+        if (!reportProgress(intfa))
+            return false;
     }
     return ret;
 }
@@ -930,216 +1027,253 @@ bool dwgReader::readDwgEntities(DRW_Interface& intfa, dwgBuffer* dbuf){
  * Reads a dwg drawing entity (dwg object entity) given its offset in the file
  */
 bool dwgReader::readDwgEntity(dwgBuffer* dbuf, objHandle& obj, DRW_Interface& intfa){
-    bool ret = true;
     duint32 bs = 0;
-
-#define ENTRY_PARSE(e) \
-    ret = e.parseDwg(version, &buff, bs); \
-    parseAttribs(&e); \
-    nextEntLink = e.nextEntLink; \
-    prevEntLink = e.prevEntLink;
+    std::vector<duint8> data;
 
     nextEntLink = prevEntLink = 0;// set to 0 to skip unimplemented entities
-        dbuf->setPosition(obj.loc);
-        //verify if position is ok:
-        if (!dbuf->isGood()){
-            DRW_DBG(" Warning: readDwgEntity, bad location\n");
-            return false;
-        }
-        int size = dbuf->getModularShort();
-        if (version > DRW::AC1021) {//2010+
-            bs = dbuf->getUModularChar();
-        }
-		std::vector<duint8> tmpByteStr(size);
-		dbuf->getBytes(tmpByteStr.data(), size);
-        //verify if getBytes is ok:
-        if (!dbuf->isGood()){
-            DRW_DBG(" Warning: readDwgEntity, bad size\n");
-            return false;
-        }
-		dwgBuffer buff(tmpByteStr.data(), size, &decoder);
-        dint16 oType = buff.getObjType(version);
-        buff.resetPosition();
+    if (!readObjectData(dbuf, obj, data, bs))
+        return false;
+    bool ret = true;
+    std::unique_ptr<DRW_Entity> e = decodeDwgEntity(data, bs, obj, ret);
+    return sendDwgEntity(e.get(), obj, ret, intfa, dbuf);
+}
 
-        if (oType > 499){
-            std::map<duint32, DRW_Class*>::iterator it = classesmap.find(oType);
-            if (it == classesmap.end()){//fail, not found in classes set error
-                DRW_DBG("Class "); DRW_DBG(oType);DRW_DBG("not found, handle: "); DRW_DBG(obj.handle); DRW_DBG("\n");
-                return false;
-            } else {
-                DRW_Class *cl = it->second;
-                if (cl->dwgType != 0)
-                    oType = cl->dwgType;
-            }
+/**
+ * Copies the data of a dwg object given its offset in the file
+ * @param bs size of the data in bits, 2010+
+ */
+bool dwgReader::readObjectData(dwgBuffer* dbuf, const objHandle& obj, std::vector<duint8>& data, duint32& bs){
+    bs = 0;
+    dbuf->setPosition(obj.loc);
+    //verify if position is ok:
+    if (!dbuf->isGood()){
+        DRW_DBG(" Warning: readDwgEntity, bad location\n");
+        return false;
+    }
+    int size = dbuf->getModularShort();
+    if (version > DRW::AC1021) {//2010+
+        bs = dbuf->getUModularChar();
+    }
+    data.resize(size);
+    dbuf->getBytes(data.data(), size);
+    //verify if getBytes is ok:
+    if (!dbuf->isGood()){
+        DRW_DBG(" Warning: readDwgEntity, bad size\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Decodes a dwg drawing entity from the data read by readObjectData(), sets
+ * the type of obj. Only reads the classes and tables, so entities may be
+ * decoded by several threads at once.
+ * @return the entity, NULL for objects and not supported entities
+ * @param ok set to false, if the data are bad
+ */
+std::unique_ptr<DRW_Entity> dwgReader::decodeDwgEntity(std::vector<duint8>& data, duint32 bs,
+                                                       objHandle& obj, bool& ok){
+    std::unique_ptr<DRW_Entity> e;
+    ok = true;
+    dwgBuffer buff(data.data(), data.size(), &decoder);
+    dint16 oType = buff.getObjType(version);
+    buff.resetPosition();
+
+    if (oType > 499){
+        std::map<duint32, DRW_Class*>::iterator it = classesmap.find(oType);
+        if (it == classesmap.end()){//fail, not found in classes set error
+            DRW_DBG("Class "); DRW_DBG(oType);DRW_DBG("not found, handle: "); DRW_DBG(obj.handle); DRW_DBG("\n");
+            ok = false;
+            return e;
+        } else {
+            DRW_Class *cl = it->second;
+            if (cl->dwgType != 0)
+                oType = cl->dwgType;
         }
+    }
 
-        obj.type = oType;
-        switch (oType){
-        case 17: {
-            DRW_Arc e;
-            ENTRY_PARSE(e)
-            intfa.addArc(e);
-            break; }
-        case 18: {
-            DRW_Circle e;
-            ENTRY_PARSE(e)
-            intfa.addCircle(e);
-            break; }
-        case 19:{
-            DRW_Line e;
-            ENTRY_PARSE(e)
-            intfa.addLine(e);
-            break;}
-        case 27: {
-            DRW_Point e;
-            ENTRY_PARSE(e)
-            intfa.addPoint(e);
-            break; }
-        case 35: {
-            DRW_Ellipse e;
-            ENTRY_PARSE(e)
-            intfa.addEllipse(e);
-            break; }
-        case 7:
-        case 8: {//minsert = 8
-            DRW_Insert e;
-            ENTRY_PARSE(e)
-            e.name = findTableName(DRW::BLOCK_RECORD, e.blockRecH.ref);//RLZ: find as block or blockrecord (ps & ps0)
-            intfa.addInsert(e);
-            break; }
-        case 77: {
-            DRW_LWPolyline e;
-            ENTRY_PARSE(e)
-            intfa.addLWPolyline(e);
-            break; }
-        case 1: {
-            DRW_Text e;
-            ENTRY_PARSE(e)
-            e.style = findTableName(DRW::STYLE, e.styleH.ref);
-            intfa.addText(e);
-            break; }
-        case 44: {
-            DRW_MText e;
-            ENTRY_PARSE(e)
-            e.style = findTableName(DRW::STYLE, e.styleH.ref);
-            intfa.addMText(e);
-            break; }
-        case 28: {
-            DRW_3Dface e;
-            ENTRY_PARSE(e)
-            intfa.add3dFace(e);
-            break; }
-        case 20: {
-            DRW_DimOrdinate e;
-            ENTRY_PARSE(e)
-            e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-            intfa.addDimOrdinate(&e);
-            break; }
-        case 21: {
-            DRW_DimLinear e;
-            ENTRY_PARSE(e)
-            e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-            intfa.addDimLinear(&e);
-            break; }
-        case 22: {
-            DRW_DimAligned e;
-            ENTRY_PARSE(e)
-            e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-            intfa.addDimAlign(&e);
-            break; }
-        case 23: {
-            DRW_DimAngular3p e;
-            ENTRY_PARSE(e)
-            e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-            intfa.addDimAngular3P(&e);
-            break; }
-        case 24: {
-            DRW_DimAngular e;
-            ENTRY_PARSE(e)
-            e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-            intfa.addDimAngular(&e);
-            break; }
-        case 25: {
-            DRW_DimRadial e;
-            ENTRY_PARSE(e)
-            e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-            intfa.addDimRadial(&e);
-            break; }
-        case 26: {
-            DRW_DimDiametric e;
-            ENTRY_PARSE(e)
-            e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-            intfa.addDimDiametric(&e);
-            break; }
-        case 45: {
-            DRW_Leader e;
-            ENTRY_PARSE(e)
-            e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-            intfa.addLeader(&e);
-            break; }
-        case 31: {
-            DRW_Solid e;
-            ENTRY_PARSE(e)
-            intfa.addSolid(e);
-            break; }
-        case 78: {
-            DRW_Hatch e;
-            ENTRY_PARSE(e)
-            intfa.addHatch(&e);
-            break; }
-        case 32: {
-            DRW_Trace e;
-            ENTRY_PARSE(e)
-            intfa.addTrace(e);
-            break; }
-        case 34: {
-            DRW_Viewport e;
-            ENTRY_PARSE(e)
-            intfa.addViewport(e);
-            break; }
-        case 36: {
-            DRW_Spline e;
-            ENTRY_PARSE(e)
-            intfa.addSpline(&e);
-            break; }
-        case 40: {
-            DRW_Ray e;
-            ENTRY_PARSE(e)
-            intfa.addRay(e);
-            break; }
-        case 15:    // pline 2D
-        case 16:    // pline 3D
-        case 29: {  // pline PFACE
-            DRW_Polyline e;
-            ENTRY_PARSE(e)
-            readPlineVertex(e, dbuf);
-            intfa.addPolyline(e);
-            break; }
-//        case 30: {
-//            DRW_Polyline e;// MESH (not pline)
-//            ENTRY_PARSE(e)
-//            intfa.addRay(e);
-//            break; }
-        case 41: {
-            DRW_Xline e;
-            ENTRY_PARSE(e)
-            intfa.addXline(e);
-            break; }
-        case 101: {
-            DRW_Image e;
-            ENTRY_PARSE(e)
-            intfa.addImage(&e);
-            break; }
+    obj.type = oType;
+    switch (oType){
+    case 17: e.reset(new DRW_Arc); break;
+    case 18: e.reset(new DRW_Circle); break;
+    case 19: e.reset(new DRW_Line); break;
+    case 27: e.reset(new DRW_Point); break;
+    case 35: e.reset(new DRW_Ellipse); break;
+    case 7:
+    case 8: e.reset(new DRW_Insert); break;//minsert = 8
+    case 77: e.reset(new DRW_LWPolyline); break;
+    case 1: e.reset(new DRW_Text); break;
+    case 44: e.reset(new DRW_MText); break;
+    case 28: e.reset(new DRW_3Dface); break;
+    case 20: e.reset(new DRW_DimOrdinate); break;
+    case 21: e.reset(new DRW_DimLinear); break;
+    case 22: e.reset(new DRW_DimAligned); break;
+    case 23: e.reset(new DRW_DimAngular3p); break;
+    case 24: e.reset(new DRW_DimAngular); break;
+    case 25: e.reset(new DRW_DimRadial); break;
+    case 26: e.reset(new DRW_DimDiametric); break;
+    case 45: e.reset(new DRW_Leader); break;
+    case 31: e.reset(new DRW_Solid); break;
+    case 78: e.reset(new DRW_Hatch); break;
+    case 32: e.reset(new DRW_Trace); break;
+    case 34: e.reset(new DRW_Viewport); break;
+    case 36: e.reset(new DRW_Spline); break;
+    case 40: e.reset(new DRW_Ray); break;
+    case 15:    // pline 2D
+    case 16:    // pline 3D
+    case 29:    // pline PFACE
+        e.reset(new DRW_Polyline); break;
+//    case 30: // MESH (not pline)
+    case 41: e.reset(new DRW_Xline); break;
+    case 101: e.reset(new DRW_Image); break;
+    default:
+        //not supported or are object
+        return e;
+    }
 
-        default:
-            //not supported or are object add to remaining map
+    ok = e->parseDwg(version, &buff, bs);
+    parseAttribs(e.get());
+    switch (oType){
+    case 7:
+    case 8: {
+        DRW_Insert* ins = static_cast<DRW_Insert*>(e.get());
+        ins->name = findTableName(DRW::BLOCK_RECORD, ins->blockRecH.ref);//RLZ: find as block or blockrecord (ps & ps0)
+        break; }
+    case 1:
+    case 44: {
+        DRW_Text* txt = static_cast<DRW_Text*>(e.get());
+        txt->style = findTableName(DRW::STYLE, txt->styleH.ref);
+        break; }
+    case 20:
+    case 21:
+    case 22:
+    case 23:
+    case 24:
+    case 25:
+    case 26: {
+        DRW_Dimension* dim = static_cast<DRW_Dimension*>(e.get());
+        dim->style = findTableName(DRW::DIMSTYLE, dim->dimStyleH.ref);
+        break; }
+    case 45: {
+        DRW_Leader* ld = static_cast<DRW_Leader*>(e.get());
+        ld->style = findTableName(DRW::DIMSTYLE, ld->dimStyleH.ref);
+        break; }
+    default:
+        break;
+    }
+    if (!ok){
+        DRW_DBG("Warning: Entity type "); DRW_DBG(oType);DRW_DBG("has failed, handle: "); DRW_DBG(obj.handle); DRW_DBG("\n");
+    }
+    return e;
+}
+
+/**
+ * Sends an entity decoded by decodeDwgEntity() to the interface, reads the
+ * vertices of polylines. Objects are kept in objObjectMap for
+ * readDwgObjects().
+ * @return ok, the result of decoding
+ */
+bool dwgReader::sendDwgEntity(DRW_Entity* e, objHandle& obj, bool ok, DRW_Interface& intfa, dwgBuffer* dbuf){
+    if (!e){
+        //not supported or are object add to remaining map
+        if (ok)
             objObjectMap[obj.handle]= obj;
-            break;
-        }
-        if (!ret){
-            DRW_DBG("Warning: Entity type "); DRW_DBG(oType);DRW_DBG("has failed, handle: "); DRW_DBG(obj.handle); DRW_DBG("\n");
-        }
-    return ret;
+        return ok;
+    }
+    nextEntLink = e->nextEntLink;
+    prevEntLink = e->prevEntLink;
+
+    switch (obj.type){
+    case 17:
+        intfa.addArc(*static_cast<DRW_Arc*>(e));
+        break;
+    case 18:
+        intfa.addCircle(*static_cast<DRW_Circle*>(e));
+        break;
+    case 19:
+        intfa.addLine(*static_cast<DRW_Line*>(e));
+        break;
+    case 27:
+        intfa.addPoint(*static_cast<DRW_Point*>(e));
+        break;
+    case 35:
+        intfa.addEllipse(*static_cast<DRW_Ellipse*>(e));
+        break;
+    case 7:
+    case 8:
+        intfa.addInsert(*static_cast<DRW_Insert*>(e));
+        break;
+    case 77:
+        intfa.addLWPolyline(*static_cast<DRW_LWPolyline*>(e));
+        break;
+    case 1:
+        intfa.addText(*static_cast<DRW_Text*>(e));
+        break;
+    case 44:
+        intfa.addMText(*static_cast<DRW_MText*>(e));
+        break;
+    case 28:
+        intfa.add3dFace(*static_cast<DRW_3Dface*>(e));
+        break;
+    case 20:
+        intfa.addDimOrdinate(static_cast<DRW_DimOrdinate*>(e));
+        break;
+    case 21:
+        intfa.addDimLinear(static_cast<DRW_DimLinear*>(e));
+        break;
+    case 22:
+        intfa.addDimAlign(static_cast<DRW_DimAligned*>(e));
+        break;
+    case 23:
+        intfa.addDimAngular3P(static_cast<DRW_DimAngular3p*>(e));
+        break;
+    case 24:
+        intfa.addDimAngular(static_cast<DRW_DimAngular*>(e));
+        break;
+    case 25:
+        intfa.addDimRadial(static_cast<DRW_DimRadial*>(e));
+        break;
+    case 26:
+        intfa.addDimDiametric(static_cast<DRW_DimDiametric*>(e));
+        break;
+    case 45:
+        intfa.addLeader(static_cast<DRW_Leader*>(e));
+        break;
+    case 31:
+        intfa.addSolid(*static_cast<DRW_Solid*>(e));
+        break;
+    case 78:
+        intfa.addHatch(static_cast<DRW_Hatch*>(e));
+        break;
+    case 32:
+        intfa.addTrace(*static_cast<DRW_Trace*>(e));
+        break;
+    case 34:
+        intfa.addViewport(*static_cast<DRW_Viewport*>(e));
+        break;
+    case 36:
+        intfa.addSpline(static_cast<DRW_Spline*>(e));
+        break;
+    case 40:
+        intfa.addRay(*static_cast<DRW_Ray*>(e));
+        break;
+    case 15:    // pline 2D
+    case 16:    // pline 3D
+    case 29: {  // pline PFACE
+        DRW_Polyline* pl = static_cast<DRW_Polyline*>(e);
+        readPlineVertex(*pl, dbuf);
+        intfa.addPolyline(*pl);
+        break; }
+    case 41:
+        intfa.addXline(*static_cast<DRW_Xline*>(e));
+        break;
+    case 101:
+        intfa.addImage(static_cast<DRW_Image*>(e));
+        break;
+    default:
+        break;
+    }
+    return ok;
 }
 
 bool dwgReader::readDwgObjects(DRW_Interface& intfa, dwgBuffer*  dbuf){
@@ -15,6 +15,8 @@
 
 #include <map>
 #include <list>
+#include <memory>
+#include <vector>
 #include "drw_textcodec.h"
 #include "dwgutil.h"
 #include "dwgbuffer.h"
@@ -147,6 +149,12 @@ protected:
 	virtual bool readDwgObjects(DRW_Interface& intfa) = 0;
 
 	virtual bool readDwgEntity(dwgBuffer* dbuf, objHandle& obj, DRW_Interface& intfa);
+	bool readObjectData(dwgBuffer* dbuf, const objHandle& obj, std::vector<duint8>& data, duint32& bs);
+	std::unique_ptr<DRW_Entity> decodeDwgEntity(std::vector<duint8>& data, duint32 bs, objHandle& obj, bool& ok);
+	bool sendDwgEntity(DRW_Entity* e, objHandle& obj, bool ok, DRW_Interface& intfa, dwgBuffer* dbuf);
+	bool readDwgEntityList(const std::vector<duint32>& handles, bool reportMissing, DRW_Interface& intfa, dwgBuffer* dbuf);
+	//! reports the objects read from ObjectMap to intfa, false if it cancels reading
+	bool reportProgress(DRW_Interface& intfa);
 	bool readDwgObject(dwgBuffer* dbuf, objHandle& obj, DRW_Interface& intfa);
 	void parseAttribs(DRW_Entity* e);
 	std::string findTableName(DRW::TTYPE table, dint32 handle);
@@ -197,6 +205,9 @@ protected:
 //    duint32 blockCtrl;
 	duint32 nextEntLink;
 	duint32 prevEntLink;
+	//! size of ObjectMap before the first entity was read
+	duint64 objectCount = 0;
+	bool cancelled = false;
 };
 
 
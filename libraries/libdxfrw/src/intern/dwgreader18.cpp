@@ -18,6 +18,7 @@
 #include <vector>
 #include <map>
 #include <list>
+#include <set>
 #include "drw_dbg.h"
 #include "dwgreader18.h"
 #include "dwgutil.h"
@@ -110,6 +111,15 @@ bool dwgReader18::parseDataPage(dwgSectionInfo si/*, duint8 *dData*/){
     DRW_DBG("\nparseDataPage\n ");
 	objData.resize(si.pageCount * si.maxSize);
 
+    //compressed data of the pages, read serially from the file and
+    //decompressed in parallel
+    struct Page {
+        duint32 startOffset;
+        std::vector<duint8> cData;
+    };
+    std::vector<Page> pages;
+    pages.reserve(si.pages.size());
+    std::set<duint32> offsets;//start offsets of the pages
     for (std::map<duint32, dwgPageInfo>::iterator it=si.pages.begin(); it!=si.pages.end(); ++it){
         dwgPageInfo pi = it->second;
         if (!fileBuf->setPosition(pi.address))
@@ -147,25 +157,53 @@ bool dwgReader18::parseDataPage(dwgSectionInfo si/*, duint8 *dData*/){
         DRW_DBG("\n      header checksum= "); DRW_DBGH(bufHdr.getRawLong32());
         DRW_DBG("\n      data checksum= "); DRW_DBGH(bufHdr.getRawLong32()); DRW_DBG("\n");
 
+        //pages are decompressed in place, must fit in objData
+        if (pi.startOffset + si.maxSize > objData.size())
+            objData.resize(pi.startOffset + si.maxSize);
+
         //get compresed data
-		std::vector<duint8> cData(pi.cSize);
+        Page page;
+        page.startOffset = pi.startOffset;
+        page.cData.resize(pi.cSize);
         if (!fileBuf->setPosition(pi.address+32))
             return false;
-		fileBuf->getBytes(cData.data(), pi.cSize);
+		fileBuf->getBytes(page.cData.data(), pi.cSize);
 
         //calculate checksum
-		duint32 calcsD = checksum(0, cData.data(), pi.cSize);
-        for (duint8 i= 24; i<28; ++i)
-            hdrData[i]=0;
-        duint32 calcsH = checksum(calcsD, hdrData, 32);
-        DRW_DBG("Calc header checksum= "); DRW_DBGH(calcsH);
-        DRW_DBG("\nCalc data checksum= "); DRW_DBGH(calcsD); DRW_DBG("\n");
-
-		duint8* oData = &objData[pi.startOffset];
-        pi.uSize = si.maxSize;
-        DRW_DBG("decompresing "); DRW_DBG(pi.cSize); DRW_DBG(" bytes in "); DRW_DBG(pi.uSize); DRW_DBG(" bytes\n");
+        if (DRW_DBGGL == DRW_dbg::DEBUG) {
+            duint32 calcsD = checksum(0, page.cData.data(), pi.cSize);
+            for (duint8 i= 24; i<28; ++i)
+                hdrData[i]=0;
+            duint32 calcsH = checksum(calcsD, hdrData, 32);
+            DRW_DBG("Calc header checksum= "); DRW_DBGH(calcsH);
+            DRW_DBG("\nCalc data checksum= "); DRW_DBGH(calcsD); DRW_DBG("\n");
+        }
+
+        DRW_DBG("decompresing "); DRW_DBG(pi.cSize); DRW_DBG(" bytes in "); DRW_DBG(si.maxSize); DRW_DBG(" bytes\n");
+        offsets.insert(page.startOffset);
+        pages.push_back(std::move(page));
+    }
+
+    //pages of damaged files may overlap, decompress them in file order then
+    bool overlap = offsets.size() != pages.size();
+    duint32 end = 0;
+    for (std::set<duint32>::iterator it=offsets.begin(); it!=offsets.end() && !overlap; ++it){
+        overlap = *it < end;
+        end = *it + si.maxSize;
+    }
+
+    auto decompress = [this, &pages, &si](duint32 i) {
+        Page& page = pages[i];
         dwgCompressor comp;
-		comp.decompress18(cData.data(), oData, pi.cSize, pi.uSize);
+        comp.decompress18(page.cData.data(), &objData[page.startOffset],
+                          page.cData.size(), si.maxSize);
+        std::vector<duint8>().swap(page.cData);
+    };
+    if (overlap) {
+        for (duint32 i = 0; i < pages.size(); ++i)
+            decompress(i);
+    } else {
+        dwgThreads::forEach(pages.size(), decompress);
     }
     return true;
 }
@@ -10,6 +10,7 @@
 **  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
 ******************************************************************************/
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
@@ -76,17 +77,46 @@ bool dwgReader21::parseSysPage(duint64 sizeCompressed, duint64 sizeUncompressed,
 
 bool dwgReader21::parseDataPage(dwgSectionInfo si, duint8 *dData){
     DRW_DBG("parseDataPage, section size: "); DRW_DBG(si.size);
+    //raw data of the pages, read serially from the file and decoded in
+    //parallel
+    struct Page {
+        dwgPageInfo pi;
+        std::vector<duint8> raw;
+    };
+    std::vector<Page> pages;
+    pages.reserve(si.pages.size());
     for (std::map<duint32, dwgPageInfo>::iterator it=si.pages.begin(); it!=si.pages.end(); ++it){
-        dwgPageInfo pi = it->second;
-        if (!fileBuf->setPosition(pi.address))
+        Page page;
+        page.pi = it->second;
+        if (!fileBuf->setPosition(page.pi.address))
             return false;
 
-		std::vector<duint8> tmpPageRaw(pi.size);
-		fileBuf->getBytes(&tmpPageRaw.front(), pi.size);
+		page.raw.resize(page.pi.size);
+		fileBuf->getBytes(&page.raw.front(), page.pi.size);
+        pages.push_back(std::move(page));
+    }
+
+    //pages of damaged files may overlap, decode them in file order then
+    std::map<duint64, duint64> ranges;//start offset, end in dData
+    for (const Page& page: pages){
+        duint64& end = ranges[page.pi.startOffset];
+        end = std::max(end, page.pi.startOffset + page.pi.uSize);
+    }
+    bool overlap = false;
+    duint64 end = 0;
+    for (std::map<duint64, duint64>::iterator it=ranges.begin(); it!=ranges.end() && !overlap; ++it){
+        overlap = it->first < end;
+        end = it->second;
+    }
+    overlap = overlap || ranges.size() != pages.size();
+
+    auto decode = [&pages, dData](duint32 i) {
+        Page& page = pages[i];
+        const dwgPageInfo& pi = page.pi;
     #ifdef DRW_DBG_DUMP
         DRW_DBG("\nSection OBJECTS raw data=\n");
         for (unsigned int i=0, j=0; i< pi.size;i++) {
-            DRW_DBGH( (unsigned char)tmpPageRaw[i]);
+            DRW_DBGH( (unsigned char)page.raw[i]);
             if (j == 7) { DRW_DBG("\n"); j = 0;
             } else { DRW_DBG(", "); j++; }
         } DRW_DBG("\n");
@@ -95,7 +125,8 @@ bool dwgReader21::parseDataPage(dwgSectionInfo si, duint8 *dData){
 		std::vector<duint8> tmpPageRS(pi.size);
 
         duint8 chunks =pi.size / 255;
-		dwgRSCodec::decode251I(&tmpPageRaw.front(), &tmpPageRS.front(), chunks);
+		dwgRSCodec::decode251I(&page.raw.front(), &tmpPageRS.front(), chunks);
+		std::vector<duint8>().swap(page.raw);
     #ifdef DRW_DBG_DUMP
         DRW_DBG("\nSection OBJECTS RS data=\n");
         for (unsigned int i=0, j=0; i< pi.size;i++) {
@@ -118,7 +149,12 @@ bool dwgReader21::parseDataPage(dwgSectionInfo si, duint8 *dData){
             } else { DRW_DBG(", "); j++; }
         } DRW_DBG("\n");
     #endif
-
+    };
+    if (overlap) {
+        for (duint32 i = 0; i < pages.size(); ++i)
+            decode(i);
+    } else {
+        dwgThreads::forEach(pages.size(), decode);
     }
     DRW_DBG("\n");
     return true;
@@ -10,7 +10,12 @@
 **  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
 ******************************************************************************/
 
+#include <atomic>
+#include <exception>
+#include <mutex>
 #include <sstream>
+#include <thread>
+#include <vector>
 #include "drw_dbg.h"
 #include "dwgutil.h"
 #include "rscodec.h"
@@ -33,6 +38,46 @@ std::string toHexStr(int n){
 }
 }
 
+unsigned int dwgThreads::count(){
+    //keeps the debug output in order
+    if (DRW_DBGGL == DRW_dbg::DEBUG)
+        return 1;
+    unsigned int n = std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+}
+
+void dwgThreads::forEach(duint32 n, const std::function<void(duint32)>& job){
+    duint32 threads = count() < n ? count() : n;
+    if (threads < 2) {
+        for (duint32 i = 0; i < n; ++i)
+            job(i);
+        return;
+    }
+
+    std::atomic<duint32> next{0};
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    auto run = [&]() {
+        try {
+            for (duint32 i = next++; i < n; i = next++)
+                job(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error)
+                error = std::current_exception();
+            next = n;
+        }
+    };
+    std::vector<std::thread> pool;
+    for (duint32 t = 1; t < threads; ++t)
+        pool.emplace_back(run);
+    run();
+    for (std::thread& t: pool)
+        t.join();
+    if (error)
+        std::rethrow_exception(error);
+}
+
 /**
  * @brief dwgRSCodec::decode239I
  * @param in : input data (at least 255*blk bytes)
@@ -13,12 +13,24 @@
 #ifndef DWGUTIL_H
 #define DWGUTIL_H
 
+#include <functional>
 #include "../drw_base.h"
 
 namespace DRW {
 std::string toHexStr(int n);
 }
 
+namespace dwgThreads {
+//! number of threads used to decode, 1 while debug output is enabled
+unsigned int count();
+/**
+ * Calls job(i) for every i in [0, n), spread over count() threads.
+ * Returns when all jobs are done, an exception thrown by a job is
+ * rethrown in the calling thread.
+ */
+void forEach(duint32 n, const std::function<void(duint32)>& job);
+}
+
 namespace dwgRSCodec {
 void decode239I(duint8 *in, duint8 *out, duint32 blk);
 void decode251I(duint8 *in, duint8 *out, duint32 blk);
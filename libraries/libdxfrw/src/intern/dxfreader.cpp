@@ -10,18 +10,48 @@
 **  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
 ******************************************************************************/
 
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <clocale>
+#include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <string>
 #include <sstream>
 #include "dxfreader.h"
 #include "drw_textcodec.h"
 #include "drw_dbg.h"
+#include "../drw_interface.h"
+
+namespace {
+//! records read between two progress reports
+constexpr unsigned int progressInterval = 8192;
+}
+
+void dxfReader::setProgress(DRW_Interface *iface, unsigned long long fileSize) {
+    progressIface = iface;
+    progressTotal = fileSize;
+    progressRecords = 0;
+}
+
+unsigned long long dxfReader::position() {
+    std::streamoff pos = filestr->tellg();
+    return pos < 0 ? progressTotal : pos;
+}
 
 bool dxfReader::readRec(int *codeData) {
 //    std::string text;
     int code;
 
+    if (progressIface != nullptr && ++progressRecords >= progressInterval) {
+        progressRecords = 0;
+        if (!progressIface->progress(std::min(position(), progressTotal), progressTotal))
+            cancelled = true;
+    }
+    if (cancelled)
+        return false;
     if (!readCode(&code))
         return false;
     *codeData = code;
@@ -89,7 +119,7 @@ bool dxfReader::readRec(int *codeData) {
         //break in binary files because the conduct is unpredictable
         return false;
 
-    return (filestr->good());
+    return good();
 }
 int dxfReader::getHandleString(){
     int res;
@@ -105,6 +135,10 @@ int dxfReader::getHandleString(){
     return res;
 }
 
+bool dxfReader::good() {
+    return filestr->good();
+}
+
 bool dxfReaderBinary::readCode(int *code) {
     unsigned short *int16p;
     char buffer[2];
@@ -266,3 +300,251 @@ bool dxfReaderAscii::readBool() {
         return false;
 }
 
+namespace {
+//! bytes read from the file at once
+const size_t readChunkSize = 1 << 20;
+
+//! powers of ten which are exact as double
+const double exactPowers[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline bool isSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+inline bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+//! same as atoi() for the text in [s, e), saturated to long like strtol()
+int parseInt(const char *s, const char *e) {
+    while (s != e && isSpace(*s))
+        ++s;
+    bool negative = false;
+    if (s != e && (*s == '-' || *s == '+'))
+        negative = (*s++ == '-');
+    const unsigned long long limit = negative ? (unsigned long long)LONG_MAX + 1 : LONG_MAX;
+    unsigned long long value = 0;
+    bool overflow = false;
+    for (; s != e && isDigit(*s); ++s) {
+        unsigned int digit = *s - '0';
+        if (overflow || value > (limit - digit) / 10)
+            overflow = true;
+        else
+            value = value * 10 + digit;
+    }
+    long result;
+    if (overflow)
+        result = negative ? LONG_MIN : LONG_MAX;
+    else
+        result = negative ? (long)(0 - value) : (long)value;
+    return (int)result;
+}
+
+/**
+ * Same as reading a double with std::istringstream in the classic locale
+ * from the text in [s, e), 0 if the text is no number. Numbers of up to 15
+ * digits with a small exponent are exact with one multiplication or
+ * division, the others are passed to strtod().
+ */
+double parseDouble(const char *s, const char *e) {
+    while (s != e && isSpace(*s))
+        ++s;
+    const char *start = s;
+    bool negative = false;
+    if (s != e && (*s == '-' || *s == '+'))
+        negative = (*s++ == '-');
+
+    unsigned long long mantissa = 0;
+    int digits = 0; //significant digits in mantissa
+    int scale = 0;
+    bool found = false;
+    for (; s != e && isDigit(*s); ++s) {
+        found = true;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (*s - '0');
+            if (mantissa > 0)
+                ++digits;
+        } else
+            ++scale;
+    }
+    if (s != e && *s == '.') {
+        for (++s; s != e && isDigit(*s); ++s) {
+            found = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*s - '0');
+                if (mantissa > 0)
+                    ++digits;
+                --scale;
+            }
+        }
+    }
+    if (!found)
+        return 0.0;
+
+    int exponent = 0;
+    if (s != e && (*s == 'e' || *s == 'E')) {
+        ++s;
+        bool negExp = false;
+        if (s != e && (*s == '-' || *s == '+'))
+            negExp = (*s++ == '-');
+        //an exponent without digits fails the stream
+        if (s == e || !isDigit(*s))
+            return 0.0;
+        for (; s != e && isDigit(*s); ++s) {
+            if (exponent < 100000)
+                exponent = exponent * 10 + (*s - '0');
+        }
+        if (negExp)
+            exponent = -exponent;
+    }
+
+    if (mantissa == 0)
+        return negative ? -0.0 : 0.0;
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    int const power = scale + exponent;
+    if (digits <= 15 && power >= -22 && power <= 22) {
+        double value = (double)mantissa;
+        value = (power < 0) ? value / exactPowers[-power] : value * exactPowers[power];
+        return negative ? -value : value;
+    }
+#endif
+
+    //strtod() uses the decimal point of the C locale
+    std::string text(start, s);
+    const char *point = localeconv()->decimal_point;
+    if (point[0] != '.') {
+        std::string::size_type i = text.find('.');
+        if (i != std::string::npos)
+            text.replace(i, 1, point);
+    }
+    double value = strtod(text.c_str(), NULL);
+    //the stream gives the largest double on overflow
+    if (std::isinf(value))
+        value = value < 0 ? -DBL_MAX : DBL_MAX;
+    return value;
+}
+}
+
+dxfReaderAsciiChunked::dxfReaderAsciiChunked(std::ifstream *stream):
+    dxfReader(stream),
+    buffer(readChunkSize),
+    pos(0),
+    last(0),
+    bytesRead(0),
+    atEnd(false),
+    lineGood(true) {
+    skip = true;
+}
+
+unsigned long long dxfReaderAsciiChunked::position() {
+    return bytesRead - (last - pos);
+}
+
+bool dxfReaderAsciiChunked::fill() {
+    if (atEnd)
+        return false;
+    //keep the unread part, grow for lines longer than the buffer
+    if (pos > 0) {
+        std::memmove(buffer.data(), buffer.data() + pos, last - pos);
+        last -= pos;
+        pos = 0;
+    }
+    if (last == buffer.size())
+        buffer.resize(buffer.size() * 2);
+    filestr->read(buffer.data() + last, buffer.size() - last);
+    std::streamsize count = filestr->gcount();
+    last += count;
+    bytesRead += count;
+    if (!filestr->good())
+        atEnd = true;
+    return count > 0;
+}
+
+bool dxfReaderAsciiChunked::nextLine(const char **begin, const char **end) {
+    size_t searched = pos;
+    const char *lineEnd = NULL;
+    for (;;) {
+        const void *found = memchr(buffer.data() + searched, '\n', last - searched);
+        if (found != NULL) {
+            lineEnd = static_cast<const char*>(found);
+            lineGood = true;
+            break;
+        }
+        size_t scanned = last - pos;
+        if (!fill()) {
+            //last line without line end, or nothing left
+            lineEnd = buffer.data() + last;
+            lineGood = false;
+            break;
+        }
+        searched = scanned;
+    }
+    *begin = buffer.data() + pos;
+    pos = std::min<size_t>(lineEnd - buffer.data() + 1, last);
+    if (lineEnd != *begin && lineEnd[-1] == '\r')
+        --lineEnd;
+    *end = lineEnd;
+    return lineGood;
+}
+
+bool dxfReaderAsciiChunked::readCode(int *code) {
+    const char *begin, *end;
+    nextLine(&begin, &end);
+    *code = parseInt(begin, end);
+    return lineGood;
+}
+
+bool dxfReaderAsciiChunked::readString(std::string *text) {
+    type = STRING;
+    const char *begin, *end;
+    nextLine(&begin, &end);
+    text->assign(begin, end);
+    return lineGood;
+}
+
+bool dxfReaderAsciiChunked::readString() {
+    return readString(&strData);
+}
+
+bool dxfReaderAsciiChunked::readInt16() {
+    type = INT32;
+    const char *begin, *end;
+    if (nextLine(&begin, &end)) {
+        intData = parseInt(begin, end);
+        return true;
+    } else
+        return false;
+}
+
+bool dxfReaderAsciiChunked::readInt32() {
+    type = INT32;
+    return readInt16();
+}
+
+bool dxfReaderAsciiChunked::readInt64() {
+    type = INT64;
+    return readInt16();
+}
+
+bool dxfReaderAsciiChunked::readDouble() {
+    type = DOUBLE;
+    const char *begin, *end;
+    if (nextLine(&begin, &end)) {
+        doubleData = parseDouble(begin, end);
+        return true;
+    } else
+        return false;
+}
+
+bool dxfReaderAsciiChunked::readBool() {
+    type = BOOL;
+    const char *begin, *end;
+    if (nextLine(&begin, &end)) {
+        intData = parseInt(begin, end);
+        return true;
+    } else
+        return false;
+}
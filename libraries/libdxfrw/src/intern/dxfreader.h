@@ -13,8 +13,11 @@
 #ifndef DXFREADER_H
 #define DXFREADER_H
 
+#include <vector>
 #include "drw_textcodec.h"
 
+class DRW_Interface;
+
 class dxfReader {
 public:
     enum TYPE {
@@ -47,6 +50,12 @@ public:
     void setCodePage(std::string *c){decoder.setCodePage(c, true);}
     std::string getCodePage(){ return decoder.getCodePage();}
     void setIgnoreComments( const bool bValue) { m_bIgnoreComments = bValue;};
+    /**
+     * Reports the position in a file of fileSize bytes to iface every few
+     * records. readRec() fails once iface cancels.
+     */
+    void setProgress(DRW_Interface *iface, unsigned long long fileSize);
+    bool isCancelled() const {return cancelled;}
 
 protected:
     virtual bool readCode(int *code) = 0; //return true if sucesful (not EOF)
@@ -57,6 +66,10 @@ protected:
     virtual bool readInt64() = 0;
     virtual bool readDouble() = 0;
     virtual bool readBool() = 0;
+    //! state of the input after the last read
+    virtual bool good();
+    //! bytes of the file consumed so far
+    virtual unsigned long long position();
 
 protected:
     std::ifstream *filestr;
@@ -68,6 +81,10 @@ protected:
 private:
     DRW_TextCodec decoder;
     bool m_bIgnoreComments {false};
+    DRW_Interface *progressIface {nullptr};
+    unsigned long long progressTotal {0};
+    unsigned int progressRecords {0};
+    bool cancelled {false};
 };
 
 class dxfReaderBinary : public dxfReader {
@@ -98,4 +115,39 @@ public:
     virtual bool readBool();
 };
 
+/**
+ * ASCII reader with the same results as dxfReaderAscii, which reads the
+ * file in large chunks and scans the lines in place. Numbers are parsed
+ * from the buffer without temporary strings or streams, independent of
+ * the locale. The stream must be opened in binary mode.
+ */
+class dxfReaderAsciiChunked : public dxfReader {
+public:
+    dxfReaderAsciiChunked(std::ifstream *stream);
+    virtual ~dxfReaderAsciiChunked(){}
+    virtual bool readCode(int *code);
+    virtual bool readString(std::string *text);
+    virtual bool readString();
+    virtual bool readInt16();
+    virtual bool readDouble();
+    virtual bool readInt32();
+    virtual bool readInt64();
+    virtual bool readBool();
+    virtual bool good() {return lineGood;}
+    virtual unsigned long long position();
+
+private:
+    //! next line without line end, false at end of file like std::getline
+    bool nextLine(const char **begin, const char **end);
+    bool fill();
+
+    std::vector<char> buffer;
+    size_t pos;
+    size_t last;
+    //! bytes read from the file into the buffer
+    unsigned long long bytesRead;
+    bool atEnd;
+    bool lineGood;
+};
+
 #endif // DXFREADER_H
@@ -10,7 +10,9 @@
 **  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
 ******************************************************************************/
 
+#include <cstdio>
 #include <cstdlib>
+#include <clocale>
 #include <fstream>
 #include <string>
 #include <algorithm>
@@ -103,6 +105,10 @@ bool dxfWriter::writeUtf8Caps(int code, std::string text) {
     return writeString(code, t);
 }
 
+bool dxfWriter::flush() {
+    return filestr->good();
+}
+
 bool dxfWriterBinary::writeString(int code, std::string text) {
     char bufcode[2];
     bufcode[0] =code & 0xFF;
@@ -268,3 +274,85 @@ bool dxfWriterAscii::writeBool(int code, bool data) {
     return (filestr->good());
 }
 
+namespace {
+//! bytes collected before they are written to the stream
+const size_t writeBufferSize = 1 << 20;
+}
+
+dxfWriterAsciiBuffered::dxfWriterAsciiBuffered(std::ofstream *stream):dxfWriter(stream){
+    buffer.reserve(writeBufferSize + 256);
+}
+
+dxfWriterAsciiBuffered::~dxfWriterAsciiBuffered(){
+    flush();
+}
+
+bool dxfWriterAsciiBuffered::flush() {
+    if (!buffer.empty()) {
+        filestr->write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+    return (filestr->good());
+}
+
+bool dxfWriterAsciiBuffered::append(const char *data, size_t size) {
+    buffer.append(data, size);
+    if (buffer.size() >= writeBufferSize)
+        return flush();
+    return true;
+}
+
+bool dxfWriterAsciiBuffered::writeCode(int code) {
+    char line[16];
+    int n = snprintf(line, sizeof(line), "%3d\n", code);
+    return append(line, n);
+}
+
+bool dxfWriterAsciiBuffered::writeString(int code, std::string text) {
+    writeCode(code);
+    text.push_back('\n');
+    return append(text.data(), text.size());
+}
+
+bool dxfWriterAsciiBuffered::writeInt16(int code, int data) {
+    char line[32];
+    writeCode(code);
+    int n = snprintf(line, sizeof(line), "%5d\n", data);
+    return append(line, n);
+}
+
+bool dxfWriterAsciiBuffered::writeInt32(int code, int data) {
+    return writeInt16(code, data);
+}
+
+bool dxfWriterAsciiBuffered::writeInt64(int code, unsigned long long int data) {
+    char line[32];
+    writeCode(code);
+    int n = snprintf(line, sizeof(line), "%5llu\n", data);
+    return append(line, n);
+}
+
+bool dxfWriterAsciiBuffered::writeDouble(int code, double data) {
+    char line[48];
+    writeCode(code);
+    //use the fewest digits which read back to the same value, printf and
+    //strtod follow the C locale, so both agree on the decimal point
+    int n = 0;
+    for (int prec = 15; prec <= 17; ++prec) {
+        n = snprintf(line, sizeof(line), "%.*g", prec, data);
+        if (strtod(line, NULL) == data)
+            break;
+    }
+    const char point = *localeconv()->decimal_point;
+    if (point != '.')
+        std::replace(line, line + n, point, '.');
+    line[n++] = '\n';
+    return append(line, n);
+}
+
+//saved as int like dxfWriterAscii
+bool dxfWriterAsciiBuffered::writeBool(int code, bool data) {
+    char line[32];
+    int n = snprintf(line, sizeof(line), "%d\n%d\n", code, data ? 1 : 0);
+    return append(line, n);
+}
@@ -28,6 +28,8 @@ public:
     virtual bool writeInt64(int code, unsigned long long int data) = 0;
     virtual bool writeDouble(int code, double data) = 0;
     virtual bool writeBool(int code, bool data) = 0;
+    //! writes out pending buffered data, if any
+    virtual bool flush();
     void setVersion(std::string *v, bool dxfFormat){encoder.setVersion(v, dxfFormat);}
     void setCodePage(std::string *c){encoder.setCodePage(c, true);}
     std::string getCodePage(){return encoder.getCodePage();}
@@ -61,4 +63,27 @@ public:
     virtual bool writeBool(int code, bool data);
 };
 
+/**
+ * ASCII writer with the same output as dxfWriterAscii, but every line is
+ * formatted into a large buffer, which is written to the stream in one
+ * call when full or on flush(). Doubles are written with the shortest
+ * precision which reads back to the same value.
+ */
+class dxfWriterAsciiBuffered : public dxfWriter {
+public:
+    dxfWriterAsciiBuffered(std::ofstream *stream);
+    virtual ~dxfWriterAsciiBuffered();
+    virtual bool writeString(int code, std::string text);
+    virtual bool writeInt16(int code, int data);
+    virtual bool writeInt32(int code, int data);
+    virtual bool writeInt64(int code, unsigned long long int data);
+    virtual bool writeDouble(int code, double data);
+    virtual bool writeBool(int code, bool data);
+    virtual bool flush();
+private:
+    bool writeCode(int code);
+    bool append(const char *data, size_t size);
+    std::string buffer;
+};
+
 #endif // DXFWRITER_H
@@ -303,6 +303,9 @@ bool dwgR::processDwg() {
         error = DRW::BAD_READ_ENTITIES;
         ret = ret2;
     }
+    //cancelled by the interface
+    if (reader->cancelled)
+        return false;
 
     ret2 = reader->readDwgObjects(*iface);
     if (ret && !ret2) {
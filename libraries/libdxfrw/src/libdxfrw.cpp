@@ -38,6 +38,8 @@ dxfRW::dxfRW(const char* name){
     reader = NULL;
     writer = NULL;
     applyExt = false;
+    bufferedRead = true;
+    bufferedWrite = true;
     elParts = 128; //parts munber when convert ellipse to polyline
 }
 dxfRW::~dxfRW(){
@@ -80,6 +82,9 @@ bool dxfRW::read(DRW_Interface *interface_, bool ext){
     line2[20] = (char)26;
     line2[21] = '\0';
     filestr.read (line, 22);
+    filestr.clear();
+    filestr.seekg (0, std::ios::end);
+    std::streamoff fileSize = filestr.tellg();
     filestr.close();
     iface = interface_;
     DRW_DBG("dxfRW::read 2\n");
@@ -92,11 +97,17 @@ bool dxfRW::read(DRW_Interface *interface_, bool ext){
         DRW_DBG("dxfRW::read binary file\n");
     } else {
         binFile = false;
-        filestr.open (fileName.c_str(), std::ios_base::in);
-        reader = new dxfReaderAscii(&filestr);
+        if (bufferedRead) {
+            filestr.open (fileName.c_str(), std::ios_base::in | std::ios::binary);
+            reader = new dxfReaderAsciiChunked(&filestr);
+        } else {
+            filestr.open (fileName.c_str(), std::ios_base::in);
+            reader = new dxfReaderAscii(&filestr);
+        }
     }
 
-    isOk = processDxf();
+    reader->setProgress(iface, fileSize > 0 ? fileSize : 0);
+    isOk = processDxf() && !reader->isCancelled();
     filestr.close();
     delete reader;
     reader = NULL;
@@ -117,7 +128,10 @@ bool dxfRW::write(DRW_Interface *interface_, DRW::Version ver, bool bin){
         DRW_DBG("dxfRW::read binary file\n");
     } else {
         filestr.open (fileName.c_str(), std::ios_base::out | std::ios::trunc);
-        writer = new dxfWriterAscii(&filestr);
+        if (bufferedWrite)
+            writer = new dxfWriterAsciiBuffered(&filestr);
+        else
+            writer = new dxfWriterAscii(&filestr);
         std::string comm = std::string("dxfrw ") + std::string(DRW_VERSION);
         writer->writeString(999, comm);
     }
@@ -153,6 +167,7 @@ bool dxfRW::write(DRW_Interface *interface_, DRW::Version ver, bool bin){
         writer->writeString(0, "ENDSEC");
     }
     writer->writeString(0, "EOF");
+    writer->flush();
     filestr.flush();
     filestr.close();
     isOk = true;
@@ -2217,7 +2232,7 @@ bool dxfRW::processEntities(bool isblock) {
                 return false; //end of file without ENDSEC
         }
 
-    } while (next);
+    } while (next && !reader->isCancelled());
     return true;
 }
 
@@ -2766,7 +2781,7 @@ bool dxfRW::processObjects() {
                 return false; //end of file without ENDSEC
         }
 
-    } while (next);
+    } while (next && !reader->isCancelled());
     return true;
 }
 
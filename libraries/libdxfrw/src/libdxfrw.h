@@ -38,6 +38,16 @@ public:
      */
     bool read(DRW_Interface *interface_, bool ext);
     void setBinary(bool b) {binFile = b;}
+    /**
+     * Selects the ASCII reader, chunked (default), which scans large
+     * blocks of the file in place, or the plain line by line reader.
+     */
+    void setBufferedRead(bool b) {bufferedRead = b;}
+    /**
+     * Selects the ASCII writer, buffered (default) or the plain stream
+     * writer, which flushes every line.
+     */
+    void setBufferedWrite(bool b) {bufferedWrite = b;}
 
     bool write(DRW_Interface *interface_, DRW::Version ver, bool bin);
     bool writeLineType(DRW_LType *ent);
@@ -128,6 +138,8 @@ private:
     std::string fileName;
     std::string codePage;
     bool binFile;
+    bool bufferedRead;
+    bool bufferedWrite;
     dxfReader *reader;
     dxfWriter *writer;
     DRW_Interface *iface;
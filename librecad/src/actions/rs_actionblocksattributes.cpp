@@ -28,6 +28,7 @@
 
 #include <QAction>
 #include "rs_graphic.h"
+#include "rs_insert.h"
 #include "rs_dialogfactory.h"
 #include "rs_debug.h"
 
@@ -60,6 +61,17 @@ void RS_ActionBlocksAttributes::trigger() {
 
                 // update the name of all inserts:
                 graphic->renameInserts(oldName, newName);
+                // and of undone inserts kept by the undo lists
+                for (RS_Entity* e: graphic->getAllDetachedEntities()) {
+                    if (e->rtti()==RS2::EntityInsert) {
+                        RS_Insert* i = static_cast<RS_Insert*>(e);
+                        if (i->getName()==oldName) {
+                            i->setName(newName);
+                        }
+                    } else if (e->isContainer()) {
+                        static_cast<RS_EntityContainer*>(e)->renameInserts(oldName, newName);
+                    }
+                }
 
                 graphic->addBlockNotification();
             }
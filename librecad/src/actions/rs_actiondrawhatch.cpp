@@ -143,6 +143,8 @@ void RS_ActionDrawHatch::trigger() {
 			document->endUndoCycle();
 		}
 		hatch->update();
+		// report errors of the pattern fill as well
+		hatch->ensureUpdated();
 
 		graphicView->redraw(RS2::RedrawDrawing);
 
@@ -0,0 +1,54 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#include "lc_bulkedit.h"
+#include "rs_document.h"
+
+LC_BulkEdit::LC_BulkEdit(RS_Document* doc, bool handleUndo):
+	document(doc)
+  ,undo(doc, handleUndo)
+{
+	if (document) {
+		document->startBulkEdit();
+	}
+}
+
+LC_BulkEdit::~LC_BulkEdit()
+{
+	// the consolidated updates are done before the undo cycle ends
+	if (document) {
+		document->endBulkEdit();
+	}
+}
+
+void LC_BulkEdit::addUndoable(RS_Undoable* undoable)
+{
+	undo.addUndoable(undoable);
+}
+
+void LC_BulkEdit::addUndoRecord(LC_UndoRecord* record)
+{
+	undo.addUndoRecord(record);
+}
@@ -0,0 +1,63 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#ifndef LC_BULKEDIT_H
+#define LC_BULKEDIT_H
+
+#include "lc_undosection.h"
+
+class LC_UndoRecord;
+class RS_Document;
+class RS_Undoable;
+
+/**
+ * \brief Scoped bulk edit of a document as one undo step.
+ *
+ * Starts an undo cycle and a bulk edit of the document on construction
+ * and ends both on destruction. While it lasts, borders are not updated,
+ * updates of inserts and dimensions are deferred and the drawing isn't
+ * redrawn. All of this is done once when the outermost bulk edit ends.
+ *
+ * Used for edits of many entities at once, e.g. by plugins.
+ *
+ * @see RS_Document::startBulkEdit()
+ * @see LC_UndoSection
+ */
+class LC_BulkEdit
+{
+public:
+	LC_BulkEdit(RS_Document* doc, bool handleUndo = true);
+	~LC_BulkEdit();
+
+	void addUndoable(RS_Undoable* undoable);
+	//! takes ownership of record, which is deleted without undo handling
+	void addUndoRecord(LC_UndoRecord* record);
+
+private:
+	RS_Document* document {nullptr};
+	LC_UndoSection undo;
+};
+
+#endif // LC_BULKEDIT_H
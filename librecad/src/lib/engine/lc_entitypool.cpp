@@ -0,0 +1,191 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <new>
+
+#include "lc_entitypool.h"
+
+namespace {
+//! slot sizes are multiples of the granularity, which keeps slots aligned
+constexpr std::size_t granularity = 16;
+//! larger objects come from the general heap
+constexpr std::size_t maxSlotSize = 512;
+constexpr std::size_t chunkSize = 64 * 1024;
+constexpr std::size_t classCount = maxSlotSize / granularity;
+
+struct FreeSlot {
+	FreeSlot* next;
+};
+
+struct Chunk {
+	char* begin = nullptr;
+	//! unused part of the chunk, slots below next have been handed out
+	char* next = nullptr;
+	char* end = nullptr;
+	//! slots handed out and not freed
+	std::size_t used = 0;
+	FreeSlot* freeSlots = nullptr;
+	//! links of SizeClass::partial, the chunks with free slots
+	Chunk* prevPartial = nullptr;
+	Chunk* nextPartial = nullptr;
+};
+
+struct SizeClass {
+	std::mutex mutex;
+	//! chunks by address, to find the chunk of a freed slot
+	std::map<char*, Chunk> chunks;
+	//! chunk slots are cut from, kept when its slots are freed
+	Chunk* current = nullptr;
+	Chunk* partial = nullptr;
+
+	void link(Chunk* c)
+	{
+		c->prevPartial = nullptr;
+		c->nextPartial = partial;
+		if (partial) {
+			partial->prevPartial = c;
+		}
+		partial = c;
+	}
+
+	void unlink(Chunk* c)
+	{
+		(c->prevPartial ? c->prevPartial->nextPartial : partial) = c->nextPartial;
+		if (c->nextPartial) {
+			c->nextPartial->prevPartial = c->prevPartial;
+		}
+		c->prevPartial = c->nextPartial = nullptr;
+	}
+};
+
+struct Pool {
+	std::array<SizeClass, classCount> classes;
+	std::atomic<std::size_t> reserved{0};
+};
+
+//! never destroyed, entities may outlive static objects
+Pool& pool()
+{
+	static Pool* p = new Pool;
+	return *p;
+}
+
+std::size_t classIndex(std::size_t size)
+{
+	return (std::max<std::size_t>(size, 1) + granularity - 1) / granularity - 1;
+}
+}
+
+void* LC_EntityPool::allocate(std::size_t size)
+{
+	if (size > maxSlotSize) {
+		return ::operator new(size);
+	}
+	std::size_t const index = classIndex(size);
+	std::size_t const slot = (index + 1) * granularity;
+	Pool& p = pool();
+	SizeClass& sc = p.classes[index];
+
+	std::lock_guard<std::mutex> lock(sc.mutex);
+	if (Chunk* c = sc.partial) {
+		FreeSlot* ret = c->freeSlots;
+		c->freeSlots = ret->next;
+		if (!c->freeSlots) {
+			sc.unlink(c);
+		}
+		++c->used;
+		return ret;
+	}
+	if (!sc.current || sc.current->next + slot > sc.current->end) {
+		// the rest of a chunk smaller than a slot is left unused,
+		// operator new aligns chunks for any type
+		char* begin = static_cast<char*>(::operator new(chunkSize));
+		Chunk& c = sc.chunks[begin];
+		c.begin = c.next = begin;
+		c.end = begin + chunkSize;
+		sc.current = &c;
+		p.reserved += chunkSize;
+	}
+	Chunk* c = sc.current;
+	void* ret = c->next;
+	c->next += slot;
+	++c->used;
+	return ret;
+}
+
+void LC_EntityPool::deallocate(void* ptr, std::size_t size)
+{
+	if (!ptr) {
+		return;
+	}
+	if (size > maxSlotSize) {
+		::operator delete(ptr);
+		return;
+	}
+	Pool& p = pool();
+	SizeClass& sc = p.classes[classIndex(size)];
+	std::lock_guard<std::mutex> lock(sc.mutex);
+	auto it = --sc.chunks.upper_bound(static_cast<char*>(ptr));
+	Chunk* c = &it->second;
+	bool const partial = c->freeSlots != nullptr;
+	if (--c->used == 0) {
+		if (partial) {
+			sc.unlink(c);
+		}
+		if (c == sc.current) {
+			// start over instead of allocating a new chunk for the next slot
+			c->next = c->begin;
+			c->freeSlots = nullptr;
+		} else {
+			// return empty chunks, e.g. after a drawing was closed
+			::operator delete(c->begin);
+			sc.chunks.erase(it);
+			p.reserved -= chunkSize;
+		}
+		return;
+	}
+	FreeSlot* slot = static_cast<FreeSlot*>(ptr);
+	slot->next = c->freeSlots;
+	c->freeSlots = slot;
+	if (!partial) {
+		sc.link(c);
+	}
+}
+
+std::size_t LC_EntityPool::slotSize(std::size_t size)
+{
+	return size > maxSlotSize ? size : (classIndex(size) + 1) * granularity;
+}
+
+std::size_t LC_EntityPool::reservedBytes()
+{
+	return pool().reserved;
+}
@@ -0,0 +1,58 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+
+#ifndef LC_ENTITYPOOL_H
+#define LC_ENTITYPOOL_H
+
+#include <cstddef>
+
+/**
+ * \brief Memory for entities, allocated from chunks of equally sized slots.
+ *
+ * Drawings consist of millions of small entities. The pool rounds their
+ * sizes up to a multiple of 16 bytes and hands out slots of large chunks,
+ * which saves the bookkeeping and padding of the general heap for every
+ * entity and keeps entities of a kind close together. Freed slots are
+ * reused for objects of the same size class, chunks are returned to the
+ * general heap when all their slots are free. Larger objects, e.g.
+ * graphics and blocks, are allocated from the general heap.
+ *
+ * Thread safe, entities are created on several threads while importing.
+ */
+class LC_EntityPool
+{
+public:
+	static void* allocate(std::size_t size);
+	//! size has to be the size passed to allocate()
+	static void deallocate(void* p, std::size_t size);
+
+	//! @return bytes taken by an object of size, without the chunk overhead
+	static std::size_t slotSize(std::size_t size);
+	//! @return bytes in chunks, used or free
+	static std::size_t reservedBytes();
+};
+
+#endif // LC_ENTITYPOOL_H
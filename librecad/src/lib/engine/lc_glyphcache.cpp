@@ -0,0 +1,173 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+
+#include <algorithm>
+#include <cmath>
+
+#include "lc_glyphcache.h"
+#include "rs_arc.h"
+#include "rs_block.h"
+#include "rs_circle.h"
+#include "rs_font.h"
+#include "rs_math.h"
+
+namespace {
+//! maximum angle between the vertices of tessellated arcs
+constexpr double arcStep = M_PI / 36.;
+
+/**
+ * Appends a polyline to the glyph, joined to the previous polyline if
+ * that ends where this one starts.
+ */
+void addPolyline(LC_Glyph& glyph, const std::vector<RS_Vector>& vertices)
+{
+	if (vertices.size() < 2) {
+		return;
+	}
+	auto it = vertices.begin();
+	bool joined = false;
+	if (!glyph.points.empty()) {
+		const QPointF& last = glyph.points.back();
+		joined = std::abs(last.x() - it->x) < RS_TOLERANCE
+				&& std::abs(last.y() - it->y) < RS_TOLERANCE;
+	}
+	if (joined) {
+		++it;
+	} else {
+		glyph.runs.push_back(glyph.points.size());
+	}
+	for (; it != vertices.end(); ++it) {
+		glyph.points.emplace_back(it->x, it->y);
+	}
+}
+
+//! @return vertices along the arc from a1 over the angle length da
+std::vector<RS_Vector> tessellateArc(const RS_Vector& center, double radius,
+									 double a1, double da)
+{
+	int const n = std::max(1, (int) std::ceil(std::abs(da) / arcStep));
+	std::vector<RS_Vector> vertices;
+	vertices.reserve(n + 1);
+	for (int i = 0; i <= n; ++i) {
+		vertices.push_back(center + RS_Vector::polar(radius, a1 + da * i / n));
+	}
+	return vertices;
+}
+
+/**
+ * Tessellates lines, arcs and circles of the container and of the
+ * containers (polylines, composed letters) within it.
+ */
+void addEntities(LC_Glyph& glyph, const RS_EntityContainer* container)
+{
+	for (const RS_Entity* e: *container) {
+		switch (e->rtti()) {
+		case RS2::EntityLine:
+			addPolyline(glyph, {e->getStartpoint(), e->getEndpoint()});
+			break;
+
+		case RS2::EntityArc: {
+			const RS_Arc* arc = static_cast<const RS_Arc*>(e);
+			double const da = arc->isReversed() ? -arc->getAngleLength() : arc->getAngleLength();
+			std::vector<RS_Vector> vertices = tessellateArc(arc->getCenter(), arc->getRadius(),
+															arc->getAngle1(), da);
+			// exact ends, so neighbours are joined
+			vertices.front() = arc->getStartpoint();
+			vertices.back() = arc->getEndpoint();
+			addPolyline(glyph, vertices);
+			break;
+		}
+
+		case RS2::EntityCircle: {
+			std::vector<RS_Vector> vertices = tessellateArc(e->getCenter(), e->getRadius(),
+															0., 2. * M_PI);
+			vertices.back() = vertices.front();
+			addPolyline(glyph, vertices);
+			break;
+		}
+
+		default:
+			if (e->isContainer()) {
+				addEntities(glyph, static_cast<const RS_EntityContainer*>(e));
+			}
+			break;
+		}
+	}
+}
+}
+
+LC_GlyphCache* LC_GlyphCache::instance()
+{
+	static LC_GlyphCache cache;
+	return &cache;
+}
+
+std::shared_ptr<const LC_Glyph> LC_GlyphCache::find(RS_Font* font, const QString& letter)
+{
+	if (!font) {
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	auto& glyphs = fonts[font];
+	auto it = glyphs.constFind(letter);
+	if (it != glyphs.constEnd()) {
+		return it.value();
+	}
+
+	std::shared_ptr<LC_Glyph> glyph;
+	if (RS_Block* block = font->findLetter(letter)) {
+		glyph = std::make_shared<LC_Glyph>();
+		glyph->name = letter;
+		glyph->minV = block->getMin();
+		glyph->maxV = block->getMax();
+		addEntities(*glyph, block);
+		glyph->points.shrink_to_fit();
+		glyph->runs.shrink_to_fit();
+	}
+	glyphs.insert(letter, glyph);
+	return glyph;
+}
+
+size_t LC_GlyphCache::count() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	size_t ret = 0;
+	for (const auto& f: fonts) {
+		for (const auto& glyph: f.second) {
+			if (glyph) {
+				++ret;
+			}
+		}
+	}
+	return ret;
+}
+
+void LC_GlyphCache::clear()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	fonts.clear();
+}
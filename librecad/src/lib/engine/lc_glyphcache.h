@@ -0,0 +1,99 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+
+#ifndef LC_GLYPHCACHE_H
+#define LC_GLYPHCACHE_H
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <QHash>
+#include <QPointF>
+#include <QString>
+#include "rs_vector.h"
+
+class RS_Font;
+
+#define LC_GLYPHCACHE LC_GlyphCache::instance()
+
+/**
+ * \brief Geometry of a letter of a font, tessellated into polylines.
+ *
+ * Glyphs are shared by all texts using the letter and never change once
+ * created.
+ */
+struct LC_Glyph {
+	//! name of the letter block
+	QString name;
+	//! vertices of all polylines, in font units (letter height 9)
+	std::vector<QPointF> points;
+	//! index of the first vertex of every polyline in points
+	std::vector<size_t> runs;
+	//! borders of the letter block
+	RS_Vector minV;
+	RS_Vector maxV;
+
+	//! @return the index behind the last vertex of polyline i
+	size_t runEnd(size_t i) const {
+		return i + 1 < runs.size() ? runs[i + 1] : points.size();
+	}
+};
+
+/**
+ * \brief Cache of glyphs, keyed by font and letter.
+ *
+ * Every letter is tessellated once, when a text first uses it. Fonts
+ * create letters on demand, so the cache takes its lock around the font
+ * lookups as well, texts may be updated by the threads of a file import.
+ */
+class LC_GlyphCache
+{
+public:
+	static LC_GlyphCache* instance();
+
+	/**
+	 * @return the glyph of letter in font or nullptr, if the font has no
+	 * such letter
+	 */
+	std::shared_ptr<const LC_Glyph> find(RS_Font* font, const QString& letter);
+
+	//! number of glyphs cached
+	size_t count() const;
+	//! removes all glyphs, e.g. before the fonts are deleted
+	void clear();
+
+private:
+	LC_GlyphCache() = default;
+	LC_GlyphCache(const LC_GlyphCache&) = delete;
+	LC_GlyphCache& operator = (const LC_GlyphCache&) = delete;
+
+	mutable std::mutex mutex;
+	//! glyphs of every font, nullptr for letters missing in the font
+	std::unordered_map<const RS_Font*, QHash<QString, std::shared_ptr<const LC_Glyph>>> fonts;
+};
+
+#endif // LC_GLYPHCACHE_H
@@ -0,0 +1,218 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+
+#include <algorithm>
+#include <cmath>
+
+#include "lc_hatchscanline.h"
+#include "rs_entitycontainer.h"
+#include "rs_information.h"
+#include "rs_line.h"
+
+/**
+ * A boundary edge with its range of offsets across the scanlines.
+ */
+struct LC_HatchScanline::Edge {
+	double v0;
+	double v1;
+	RS_Entity* entity;
+};
+
+namespace {
+//! collects the edges of the loops in container
+void collectEdges(RS_EntityContainer* container, std::vector<RS_Entity*>& edges)
+{
+	for (RS_Entity* e: *container) {
+		if (e->isContainer()) {
+			collectEdges(static_cast<RS_EntityContainer*>(e), edges);
+		} else {
+			edges.push_back(e);
+		}
+	}
+}
+
+//! @return the range of dotP(n, p) over the corners of the box v1, v2
+std::pair<double, double> project(const RS_Vector& n, const RS_Vector& v1, const RS_Vector& v2)
+{
+	double const a = n.x * v1.x, b = n.x * v2.x;
+	double const c = n.y * v1.y, d = n.y * v2.y;
+	return {std::min(a, b) + std::min(c, d), std::max(a, b) + std::max(c, d)};
+}
+}
+
+LC_HatchScanline::LC_HatchScanline(RS_EntityContainer* contour):
+	contour(contour)
+{
+	for (RS_Entity* loop: *contour) {
+		if (loop->isContainer()) {
+			collectEdges(static_cast<RS_EntityContainer*>(loop), edges);
+		}
+	}
+}
+
+std::vector<std::pair<RS_Vector, RS_Vector>> LC_HatchScanline::clip(const RS_Vector& p1, const RS_Vector& p2,
+																	const RS_Vector& dvx, const RS_Vector& dvy,
+																	int i0, int i1, int j0, int j1) const
+{
+	std::vector<std::pair<RS_Vector, RS_Vector>> ret;
+	RS_Vector const dir = p2 - p1;
+	double const length = dir.magnitude();
+	if (length < RS_TOLERANCE || i0 >= i1 || j0 >= j1) {
+		return ret;
+	}
+	// u along the family, n across it
+	RS_Vector const u = dir / length;
+	RS_Vector const n(-u.y, u.x);
+
+	// offset and start of every copy, grouped by scanline
+	std::vector<std::pair<double, double>> copies;
+	copies.reserve(size_t(i1 - i0) * size_t(j1 - j0));
+	for (int i = i0; i < i1; ++i) {
+		for (int j = j0; j < j1; ++j) {
+			RS_Vector const p = p1 + dvx * i + dvy * j;
+			copies.emplace_back(RS_Vector::dotP(n, p), RS_Vector::dotP(u, p));
+		}
+	}
+	std::sort(copies.begin(), copies.end());
+
+	// sorted edge table
+	std::vector<Edge> table;
+	table.reserve(edges.size());
+	for (RS_Entity* e: edges) {
+		std::pair<double, double> range;
+		if (e->rtti() == RS2::EntityLine) {
+			double const va = RS_Vector::dotP(n, e->getStartpoint());
+			double const vb = RS_Vector::dotP(n, e->getEndpoint());
+			range = std::minmax(va, vb);
+		} else {
+			range = project(n, e->getMin(), e->getMax());
+		}
+		table.push_back({range.first, range.second, e});
+	}
+	std::sort(table.begin(), table.end(), [](const Edge& a, const Edge& b) {
+		return a.v0 < b.v0;
+	});
+
+	std::vector<const Edge*> active;
+	size_t next = 0;
+	for (size_t k = 0; k < copies.size(); ) {
+		double const v = copies[k].first;
+		size_t end = k + 1;
+		while (end < copies.size() && copies[end].first - v < RS_TOLERANCE) {
+			++end;
+		}
+
+		// edges reaching the scanline
+		while (next < table.size() && table[next].v0 <= v + RS_TOLERANCE) {
+			active.push_back(&table[next++]);
+		}
+		active.erase(std::remove_if(active.begin(), active.end(), [v](const Edge* e) {
+			return e->v1 < v - RS_TOLERANCE;
+		}), active.end());
+
+		std::vector<std::pair<double, double>> const inside = insideIntervals(v, u, n, active);
+		RS_Vector const base = n * v;
+		for (; k < end; ++k) {
+			double const s0 = copies[k].second;
+			double const s1 = s0 + length;
+			auto it = std::lower_bound(inside.begin(), inside.end(), s0,
+									   [](const std::pair<double, double>& in, double s) {
+				return in.second < s;
+			});
+			for (; it != inside.end() && it->first < s1; ++it) {
+				double const a = std::max(s0, it->first);
+				double const b = std::min(s1, it->second);
+				if (b - a > RS_TOLERANCE) {
+					ret.emplace_back(base + u * a, base + u * b);
+				}
+			}
+		}
+	}
+	return ret;
+}
+
+std::vector<std::pair<double, double>> LC_HatchScanline::insideIntervals(double v, const RS_Vector& u,
+																		 const RS_Vector& n,
+																		 const std::vector<const Edge*>& active) const
+{
+	std::vector<double> crossings;
+	bool curved = false;
+	RS_Vector const base = n * v;
+	for (const Edge* edge: active) {
+		RS_Entity* e = edge->entity;
+		if (e->rtti() == RS2::EntityLine) {
+			RS_Vector const a = e->getStartpoint();
+			RS_Vector const b = e->getEndpoint();
+			double const va = RS_Vector::dotP(n, a);
+			double const vb = RS_Vector::dotP(n, b);
+			// half open, vertices shared by two edges count once
+			if ((va <= v && v < vb) || (vb <= v && v < va)) {
+				double const t = (v - va) / (vb - va);
+				crossings.push_back(RS_Vector::dotP(u, a + (b - a) * t));
+			}
+			continue;
+		}
+
+		// arcs, circles, ellipses
+		curved = true;
+		std::pair<double, double> const range = project(u, e->getMin(), e->getMax());
+		double const margin = range.second - range.first + 1.;
+		RS_Line scan{base + u * (range.first - margin), base + u * (range.second + margin)};
+		for (const RS_Vector& vp: RS_Information::getIntersection(&scan, e, true)) {
+			if (vp.valid) {
+				crossings.push_back(RS_Vector::dotP(u, vp));
+			}
+		}
+	}
+	std::sort(crossings.begin(), crossings.end());
+
+	std::vector<std::pair<double, double>> ret;
+	if (!curved) {
+		for (size_t i = 0; i + 1 < crossings.size(); i += 2) {
+			ret.emplace_back(crossings[i], crossings[i + 1]);
+		}
+		return ret;
+	}
+
+	// crossings of curves at their ends or tangents may be doubled or
+	// single, the midpoint of every interval decides
+	crossings.erase(std::unique(crossings.begin(), crossings.end(), [](double a, double b) {
+		return b - a < RS_TOLERANCE;
+	}), crossings.end());
+	for (size_t i = 0; i + 1 < crossings.size(); ++i) {
+		double const a = crossings[i];
+		double const b = crossings[i + 1];
+		if (!RS_Information::isPointInsideContour(base + u * ((a + b) * 0.5), contour)) {
+			continue;
+		}
+		if (!ret.empty() && ret.back().second >= a) {
+			ret.back().second = b;
+		} else {
+			ret.emplace_back(a, b);
+		}
+	}
+	return ret;
+}
@@ -0,0 +1,83 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+
+#ifndef LC_HATCHSCANLINE_H
+#define LC_HATCHSCANLINE_H
+
+#include <utility>
+#include <vector>
+#include "rs_vector.h"
+
+class RS_Entity;
+class RS_EntityContainer;
+
+/**
+ * \brief Clips the lines of a hatch pattern to the loops of a hatch.
+ *
+ * A pattern line repeated over the tiles of the hatch lies on a family of
+ * parallel lines. Every distinct line of the family is a scanline: its
+ * crossings with the boundary are computed once, from a table of the
+ * boundary edges sorted by their offset across the family, and all
+ * pattern lines on it are clipped against the inside intervals.
+ *
+ * Inside is decided by the even-odd rule, as by
+ * RS_Information::isPointInsideContour().
+ */
+class LC_HatchScanline
+{
+public:
+	/**
+	 * @param contour container of the boundary loops, the hatch without
+	 * its pattern entities
+	 */
+	explicit LC_HatchScanline(RS_EntityContainer* contour);
+
+	/**
+	 * Clips the copies of the line p1, p2 moved by i * dvx + j * dvy for
+	 * i0 <= i < i1 and j0 <= j < j1.
+	 *
+	 * @return start and end points of the pieces inside the boundary
+	 */
+	std::vector<std::pair<RS_Vector, RS_Vector>> clip(const RS_Vector& p1, const RS_Vector& p2,
+													   const RS_Vector& dvx, const RS_Vector& dvy,
+													   int i0, int i1, int j0, int j1) const;
+
+private:
+	struct Edge;
+
+	/**
+	 * @return the sorted, disjoint intervals of the scanline at offset v
+	 * inside the boundary, as positions along u
+	 */
+	std::vector<std::pair<double, double>> insideIntervals(double v, const RS_Vector& u,
+														   const RS_Vector& n,
+														   const std::vector<const Edge*>& active) const;
+
+	RS_EntityContainer* contour;
+	std::vector<RS_Entity*> edges;
+};
+
+#endif // LC_HATCHSCANLINE_H
@@ -0,0 +1,51 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#ifndef LC_LOOKUPSTATS_H
+#define LC_LOOKUPSTATS_H
+
+/**
+ * \brief Counters of the lookups by name in a list of named objects.
+ *
+ * Lists with a hash index compare about one name per lookup, a linear
+ * search compares up to one name per object in the list.
+ */
+struct LC_LookupStats
+{
+	//! number of lookups
+	unsigned long long lookups = 0;
+	//! lookups which found an object
+	unsigned long long hits = 0;
+	//! names compared
+	unsigned long long comparisons = 0;
+	//! times the index was rebuilt from the list
+	unsigned long long rebuilds = 0;
+
+	void reset() {
+		*this = LC_LookupStats();
+	}
+};
+
+#endif // LC_LOOKUPSTATS_H
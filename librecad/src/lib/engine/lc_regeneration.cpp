@@ -0,0 +1,350 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+
+#include "lc_regeneration.h"
+#include "rs_block.h"
+#include "rs_debug.h"
+#include "rs_dimension.h"
+#include "rs_entitycontainer.h"
+#include "rs_information.h"
+#include "rs_insert.h"
+#include "rs_spline.h"
+
+namespace {
+//! fewer updates are run on the calling thread
+constexpr size_t minParallelUpdates = 16;
+//! parallelFor() calls running updates on several threads
+std::atomic<int> parallelUpdates{0};
+
+//! updates of one parallelFor(), shared by the workers and the caller
+struct Job {
+	std::function<void(size_t)> update;
+	size_t count = 0;
+	std::atomic<size_t> next{0};
+	std::mutex mutex;
+	std::condition_variable finished;
+	size_t done = 0;
+};
+
+//! runs updates of a job until none is left
+void work(Job& job)
+{
+	size_t n = 0;
+	for (size_t i = job.next++; i < job.count; i = job.next++) {
+		job.update(i);
+		++n;
+	}
+	if (n > 0) {
+		std::lock_guard<std::mutex> lock(job.mutex);
+		job.done += n;
+		if (job.done == job.count) {
+			job.finished.notify_all();
+		}
+	}
+}
+
+class UpdateTask: public QRunnable
+{
+public:
+	explicit UpdateTask(std::shared_ptr<Job> job):
+		job(std::move(job))
+	{}
+
+	void run() override
+	{
+		work(*job);
+	}
+
+private:
+	std::shared_ptr<Job> job;
+};
+
+//! true, if parallelFor() uses other threads for count updates
+bool isParallel(size_t count)
+{
+	return count >= minParallelUpdates && QThread::idealThreadCount() > 1;
+}
+
+/**
+ * Drops the spatial indexes of the parents of entities. Updated entities
+ * report their new borders to their parent, which must not change its
+ * index from several threads. The indexes are rebuilt on demand.
+ */
+template<class T>
+void invalidateParents(const std::vector<T*>& entities)
+{
+	if (!isParallel(entities.size())) {
+		return;
+	}
+	std::unordered_set<RS_EntityContainer*> parents;
+	for (RS_Entity* e: entities) {
+		if (e->getParent()) {
+			parents.insert(e->getParent());
+		}
+	}
+	for (RS_EntityContainer* parent: parents) {
+		parent->invalidateSpatialIndex();
+	}
+}
+
+/**
+ * Calls update for every index below count, on the threads of the global
+ * QThreadPool and on the calling thread. Returns when all calls are done.
+ * Tasks starting later find no updates left. The calling thread takes
+ * part, so a caller running on the pool itself does not starve.
+ */
+void parallelFor(size_t count, const std::function<void(size_t)>& update)
+{
+	if (!isParallel(count)) {
+		for (size_t i = 0; i < count; ++i) {
+			update(i);
+		}
+		return;
+	}
+
+	int const threads = (int) std::min(size_t(QThread::idealThreadCount()), count);
+	++parallelUpdates;
+	auto job = std::make_shared<Job>();
+	job->update = update;
+	job->count = count;
+	for (int i = 1; i < threads; ++i) {
+		QThreadPool::globalInstance()->start(new UpdateTask(job));
+	}
+	work(*job);
+
+	std::unique_lock<std::mutex> lock(job->mutex);
+	job->finished.wait(lock, [&job]() {
+		return job->done == job->count;
+	});
+	--parallelUpdates;
+}
+
+/**
+ * Updates inserts on the current thread without updating the inserts
+ * within their blocks, see RS_Insert::setBlockInsertsUpdated().
+ */
+class BlockInsertsUpdated
+{
+public:
+	BlockInsertsUpdated():
+		previous(RS_Insert::setBlockInsertsUpdated(true))
+	{}
+	~BlockInsertsUpdated()
+	{
+		RS_Insert::setBlockInsertsUpdated(previous);
+	}
+
+private:
+	bool const previous;
+};
+
+//! appends the inserts in container, but not those in inserts or hatches
+void collectInserts(RS_EntityContainer* container, std::vector<RS_Insert*>& inserts)
+{
+	for (RS_Entity* e: *container) {
+		if (e->rtti() == RS2::EntityInsert) {
+			inserts.push_back(static_cast<RS_Insert*>(e));
+		} else if (e->isContainer() && e->rtti() != RS2::EntityHatch) {
+			collectInserts(static_cast<RS_EntityContainer*>(e), inserts);
+		}
+	}
+}
+
+/**
+ * Blocks referenced by inserts, directly or through other blocks, with
+ * their depth of nesting.
+ */
+class BlockLevels
+{
+public:
+	/**
+	 * @return the level of block: 0 without inserts, otherwise one more
+	 * than the highest level of the blocks its inserts reference
+	 */
+	int add(RS_Block* block)
+	{
+		auto it = blocks.find(block);
+		if (it != blocks.end()) {
+			// -1 while visited, the block references itself
+			return std::max(it->second.level, 0);
+		}
+
+		Info& info = blocks[block];
+		collectInserts(block, info.inserts);
+		int level = 0;
+		for (RS_Insert* insert: info.inserts) {
+			if (RS_Block* b = insert->getBlockForInsert()) {
+				level = std::max(level, add(b) + 1);
+			}
+		}
+		info.level = level;
+		maxLevel = std::max(maxLevel, level);
+		return level;
+	}
+
+	//! updates the inserts of all blocks, the lowest levels first
+	void update()
+	{
+		std::vector<std::pair<RS_Block*, Info*>> wave;
+		for (int level = 1; level <= maxLevel; ++level) {
+			wave.clear();
+			std::vector<RS_Block*> waveBlocks;
+			for (auto& b: blocks) {
+				if (b.second.level == level) {
+					wave.emplace_back(b.first, &b.second);
+					waveBlocks.push_back(b.first);
+				}
+			}
+			invalidateParents(waveBlocks);
+			RS_DEBUG->print("LC_Regeneration: %d blocks of level %d", (int) wave.size(), level);
+			parallelFor(wave.size(), [&wave](size_t i) {
+				BlockInsertsUpdated updated;
+				for (RS_Insert* insert: wave[i].second->inserts) {
+					insert->update();
+				}
+				wave[i].first->calculateBorders();
+			});
+		}
+	}
+
+private:
+	struct Info {
+		std::vector<RS_Insert*> inserts;
+		int level = -1;
+	};
+
+	std::unordered_map<RS_Block*, Info> blocks;
+	int maxLevel = 0;
+};
+
+//! appends the dimensions and leaders in container
+void collectDimensions(RS_EntityContainer* container, std::vector<RS_Entity*>& dimensions)
+{
+	for (RS_Entity* e: *container) {
+		if (RS_Information::isDimension(e->rtti()) || e->rtti() == RS2::EntityDimLeader) {
+			dimensions.push_back(e);
+		} else if (e->isContainer()) {
+			collectDimensions(static_cast<RS_EntityContainer*>(e), dimensions);
+		}
+	}
+}
+
+//! appends the splines in container, but not those in hatches
+void collectSplines(RS_EntityContainer* container, std::vector<RS_Spline*>& splines)
+{
+	for (RS_Entity* e: *container) {
+		if (e->rtti() == RS2::EntitySpline) {
+			splines.push_back(static_cast<RS_Spline*>(e));
+		} else if (e->isContainer() && e->rtti() != RS2::EntityHatch) {
+			collectSplines(static_cast<RS_EntityContainer*>(e), splines);
+		}
+	}
+}
+}
+
+void LC_Regeneration::updateInserts(RS_EntityContainer* container)
+{
+	std::vector<RS_Insert*> inserts;
+	collectInserts(container, inserts);
+
+	BlockLevels levels;
+	for (RS_Insert* insert: inserts) {
+		if (!insert->isUndone()) {
+			if (RS_Block* block = insert->getBlockForInsert()) {
+				levels.add(block);
+			}
+		}
+	}
+	levels.update();
+
+	RS_DEBUG->print("LC_Regeneration::updateInserts: %d inserts", (int) inserts.size());
+	invalidateParents(inserts);
+	parallelFor(inserts.size(), [&inserts](size_t i) {
+		BlockInsertsUpdated updated;
+		inserts[i]->update();
+	});
+}
+
+void LC_Regeneration::updateDimensions(RS_EntityContainer* container, bool autoText)
+{
+	std::vector<RS_Entity*> dimensions;
+	collectDimensions(container, dimensions);
+
+	// the updates only read the variables of the graphic, missing ones
+	// are added here, see isUpdating()
+	for (RS_Entity* e: dimensions) {
+		if (RS_Information::isDimension(e->rtti())) {
+			static_cast<RS_Dimension*>(e)->addDefaultGraphicVariables();
+			break;
+		}
+	}
+
+	invalidateParents(dimensions);
+	parallelFor(dimensions.size(), [&dimensions, autoText](size_t i) {
+		RS_Entity* e = dimensions[i];
+		if (RS_Information::isDimension(e->rtti())) {
+			auto dimension = static_cast<RS_Dimension*>(e);
+			// a pending update reads the changed variables later on
+			if (dimension->isUpdatePending() && !autoText) {
+				return;
+			}
+			dimension->ensureUpdated();
+			// update and reposition label:
+			dimension->updateDim(autoText);
+		} else {
+			e->update();
+		}
+	});
+}
+
+void LC_Regeneration::updateSplines(RS_EntityContainer* container)
+{
+	std::vector<RS_Spline*> splines;
+	collectSplines(container, splines);
+	invalidateParents(splines);
+	parallelFor(splines.size(), [&splines](size_t i) {
+		splines[i]->update();
+	});
+}
+
+bool LC_Regeneration::isUpdating()
+{
+	return parallelUpdates > 0;
+}
@@ -0,0 +1,64 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+
+#ifndef LC_REGENERATION_H
+#define LC_REGENERATION_H
+
+class RS_EntityContainer;
+
+/**
+ * \brief Regenerates inserts, dimensions and splines of a container on
+ * several threads.
+ *
+ * The updates of these entities only write to the entity itself, so
+ * independent entities are updated on the threads of the global
+ * QThreadPool. Inserts depend on the blocks they reference: the inserts
+ * within nested blocks are updated first, one level of nesting at a time,
+ * and the inserts of the container last. The updates then only read the
+ * blocks they reference.
+ *
+ * The caller must not modify the entities meanwhile. Layers, blocks,
+ * fonts and patterns are looked up under the locks of their lists.
+ */
+class LC_Regeneration
+{
+public:
+	//! updates all inserts in container, nested blocks first
+	static void updateInserts(RS_EntityContainer* container);
+	//! updates all dimensions and leaders in container
+	static void updateDimensions(RS_EntityContainer* container, bool autoText);
+	//! updates all splines in container
+	static void updateSplines(RS_EntityContainer* container);
+
+	/**
+	 * @return true while entities are updated on several threads. The
+	 * graphic is shared by the updates, its variables must not be added
+	 * or changed meanwhile.
+	 */
+	static bool isUpdating();
+};
+
+#endif // LC_REGENERATION_H
@@ -0,0 +1,373 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <unordered_set>
+
+#include "lc_spatialindex.h"
+#include "rs_entity.h"
+
+namespace {
+//! average number of entities per grid cell
+constexpr double entitiesPerCell = 4.;
+//! maximum number of grid cells in each direction
+constexpr int maxCellsPerSide = 1024;
+//! entities covering more cells are kept in the list of large entities
+constexpr int maxCellsPerEntity = 64;
+
+struct QueueEntry {
+	double dist;
+	int order;
+	RS_Entity* entity;
+};
+
+struct QueueCompare {
+	bool operator()(const QueueEntry& a, const QueueEntry& b) const {
+		return a.dist > b.dist;
+	}
+};
+}
+
+int LC_SpatialIndex::minimumEntities()
+{
+	return 256;
+}
+
+bool LC_SpatialIndex::getExtent(const RS_Entity* entity, RS_Vector& vMin, RS_Vector& vMax)
+{
+	// infinite lines have no finite extent
+	if (entity->rtti() == RS2::EntityConstructionLine)
+		return false;
+
+	vMin = entity->getMin();
+	vMax = entity->getMax();
+	if (vMin.x > vMax.x || vMin.y > vMax.y)
+		return false;
+	if (vMin.x < RS_MINDOUBLE || vMin.y < RS_MINDOUBLE
+			|| vMax.x > RS_MAXDOUBLE || vMax.y > RS_MAXDOUBLE)
+		return false;
+
+	for (const RS_Vector& vp: entity->getRefPoints()) {
+		if (vp.valid) {
+			vMin = RS_Vector::minimum(vMin, vp);
+			vMax = RS_Vector::maximum(vMax, vp);
+		}
+	}
+	RS_Vector const center = entity->getCenter();
+	if (center.valid) {
+		vMin = RS_Vector::minimum(vMin, center);
+		vMax = RS_Vector::maximum(vMax, center);
+	}
+	return true;
+}
+
+void LC_SpatialIndex::build(const QList<RS_Entity*>& entities)
+{
+	clear();
+
+	RS_Vector vMin{RS_MAXDOUBLE, RS_MAXDOUBLE};
+	RS_Vector vMax{RS_MINDOUBLE, RS_MINDOUBLE};
+	items.reserve(entities.size());
+	int order = 0;
+	for (RS_Entity* e: entities) {
+		Item item;
+		item.entity = e;
+		item.order = order++;
+		item.large = false;
+		item.bounded = getExtent(e, item.vMin, item.vMax);
+		if (item.bounded) {
+			vMin = RS_Vector::minimum(vMin, item.vMin);
+			vMax = RS_Vector::maximum(vMax, item.vMax);
+		}
+		items[e] = item;
+	}
+	minOrder = 0;
+	maxOrder = order - 1;
+
+	setupGrid(vMin, vMax, items.size());
+	for (auto& p: items)
+		addItem(p.second);
+}
+
+void LC_SpatialIndex::clear()
+{
+	items.clear();
+	cells.clear();
+	unbounded.clear();
+	large.clear();
+	columns = 0;
+	rows = 0;
+	minOrder = 0;
+	maxOrder = -1;
+	outside = 0;
+}
+
+bool LC_SpatialIndex::isEmpty() const
+{
+	return items.empty();
+}
+
+bool LC_SpatialIndex::needsRebuild() const
+{
+	return outside > 64 && 4 * outside > items.size();
+}
+
+void LC_SpatialIndex::setupGrid(const RS_Vector& vMin, const RS_Vector& vMax, size_t count)
+{
+	if (vMin.x > vMax.x || vMin.y > vMax.y) {
+		// nothing with an extent yet, a single cell will do
+		origin = RS_Vector{0., 0.};
+		cellWidth = cellHeight = 1.;
+		columns = rows = 1;
+	} else {
+		double const width = std::max(vMax.x - vMin.x, RS_TOLERANCE);
+		double const height = std::max(vMax.y - vMin.y, RS_TOLERANCE);
+		double const cellCount = std::max(1., count / entitiesPerCell);
+		// square cells, as far as the aspect ratio allows
+		double const side = std::sqrt(width * height / cellCount);
+		columns = std::min(maxCellsPerSide, std::max(1, int(std::ceil(width / side))));
+		rows = std::min(maxCellsPerSide, std::max(1, int(std::ceil(height / side))));
+		origin = vMin;
+		cellWidth = width / columns;
+		cellHeight = height / rows;
+	}
+	cells.assign(columns * rows, std::vector<Item*>());
+}
+
+int LC_SpatialIndex::column(double x) const
+{
+	double const c = std::floor((x - origin.x) / cellWidth);
+	if (c < 0.) return 0;
+	if (c >= columns) return columns - 1;
+	return int(c);
+}
+
+int LC_SpatialIndex::row(double y) const
+{
+	double const r = std::floor((y - origin.y) / cellHeight);
+	if (r < 0.) return 0;
+	if (r >= rows) return rows - 1;
+	return int(r);
+}
+
+void LC_SpatialIndex::addItem(Item& item)
+{
+	if (!item.bounded) {
+		unbounded.push_back(&item);
+		return;
+	}
+	item.col0 = column(item.vMin.x);
+	item.col1 = column(item.vMax.x);
+	item.row0 = row(item.vMin.y);
+	item.row1 = row(item.vMax.y);
+	if (item.vMin.x < origin.x || item.vMin.y < origin.y
+			|| item.vMax.x > origin.x + columns * cellWidth
+			|| item.vMax.y > origin.y + rows * cellHeight)
+		++outside;
+
+	item.large = (item.col1 - item.col0 + 1) * (item.row1 - item.row0 + 1) > maxCellsPerEntity;
+	if (item.large) {
+		large.push_back(&item);
+		return;
+	}
+	for (int r = item.row0; r <= item.row1; ++r)
+		for (int c = item.col0; c <= item.col1; ++c)
+			cells[r * columns + c].push_back(&item);
+}
+
+void LC_SpatialIndex::removeItem(const Item& item)
+{
+	auto erase = [&item](std::vector<Item*>& list) {
+		auto it = std::find(list.begin(), list.end(), &item);
+		if (it != list.end()) {
+			*it = list.back();
+			list.pop_back();
+		}
+	};
+
+	if (!item.bounded) {
+		erase(unbounded);
+		return;
+	}
+	if (item.large) {
+		erase(large);
+		return;
+	}
+	for (int r = item.row0; r <= item.row1; ++r)
+		for (int c = item.col0; c <= item.col1; ++c)
+			erase(cells[r * columns + c]);
+}
+
+void LC_SpatialIndex::insert(RS_Entity* entity, bool prepend)
+{
+	if (!entity || columns == 0 || contains(entity))
+		return;
+	Item& item = items[entity];
+	item.entity = entity;
+	item.order = prepend ? --minOrder : ++maxOrder;
+	item.large = false;
+	item.bounded = getExtent(entity, item.vMin, item.vMax);
+	addItem(item);
+}
+
+void LC_SpatialIndex::remove(RS_Entity* entity)
+{
+	auto it = items.find(entity);
+	if (it == items.end())
+		return;
+	removeItem(it->second);
+	items.erase(it);
+}
+
+void LC_SpatialIndex::update(RS_Entity* entity)
+{
+	auto it = items.find(entity);
+	if (it == items.end())
+		return;
+	Item& item = it->second;
+	RS_Vector vMin, vMax;
+	bool const bounded = getExtent(entity, vMin, vMax);
+	if (bounded == item.bounded && (!bounded || (vMin == item.vMin && vMax == item.vMax)))
+		return;
+	removeItem(item);
+	item.bounded = bounded;
+	item.vMin = vMin;
+	item.vMax = vMax;
+	addItem(item);
+}
+
+bool LC_SpatialIndex::contains(RS_Entity* entity) const
+{
+	return items.count(entity) > 0;
+}
+
+double LC_SpatialIndex::distanceTo(const Item& item, const RS_Vector& coord)
+{
+	if (!item.bounded)
+		return 0.;
+	double const dx = std::max({item.vMin.x - coord.x, 0., coord.x - item.vMax.x});
+	double const dy = std::max({item.vMin.y - coord.y, 0., coord.y - item.vMax.y});
+	return std::hypot(dx, dy);
+}
+
+void LC_SpatialIndex::visitNearest(const RS_Vector& coord, const NearestVisitor& visitor) const
+{
+	if (items.empty())
+		return;
+
+	std::priority_queue<QueueEntry, std::vector<QueueEntry>, QueueCompare> queue;
+	for (const Item* item: unbounded)
+		queue.push({0., item->order, item->entity});
+	for (const Item* item: large)
+		queue.push({distanceTo(*item, coord), item->order, item->entity});
+
+	std::unordered_set<const Item*> seen;
+	int const col = column(coord.x);
+	int const rw = row(coord.y);
+	double best = RS_MAXDOUBLE;
+
+	for (int k = 0; ; ++k) {
+		int const c0 = col - k, c1 = col + k;
+		int const r0 = rw - k, r1 = rw + k;
+
+		// collect the ring of cells at distance k around the cell of coord
+		for (int r = std::max(r0, 0); r <= std::min(r1, rows - 1); ++r) {
+			bool const edgeRow = (r == r0 || r == r1);
+			for (int c = std::max(c0, 0); c <= std::min(c1, columns - 1); ++c) {
+				if (!edgeRow && c != c0 && c != c1)
+					continue;
+				for (const Item* item: cells[r * columns + c]) {
+					if (seen.insert(item).second)
+						queue.push({distanceTo(*item, coord), item->order, item->entity});
+				}
+			}
+		}
+
+		// lower bound for the distance to entities in cells not visited yet
+		double safe = RS_MAXDOUBLE;
+		if (c0 > 0)
+			safe = std::min(safe, coord.x - (origin.x + c0 * cellWidth));
+		if (c1 < columns - 1)
+			safe = std::min(safe, origin.x + (c1 + 1) * cellWidth - coord.x);
+		if (r0 > 0)
+			safe = std::min(safe, coord.y - (origin.y + r0 * cellHeight));
+		if (r1 < rows - 1)
+			safe = std::min(safe, origin.y + (r1 + 1) * cellHeight - coord.y);
+		safe = std::max(safe, 0.);
+		bool const complete = c0 <= 0 && r0 <= 0 && c1 >= columns - 1 && r1 >= rows - 1;
+
+		while (!queue.empty() && (complete || queue.top().dist <= safe)) {
+			QueueEntry const entry = queue.top();
+			if (entry.dist > best)
+				return;
+			queue.pop();
+			best = visitor(entry.entity, entry.order);
+		}
+		if (complete || best < safe)
+			return;
+	}
+}
+
+std::vector<RS_Entity*> LC_SpatialIndex::entitiesInWindow(const RS_Vector& v1,
+														  const RS_Vector& v2) const
+{
+	std::vector<const Item*> found;
+	if (items.empty())
+		return {};
+
+	RS_Vector const vMin = RS_Vector::minimum(v1, v2);
+	RS_Vector const vMax = RS_Vector::maximum(v1, v2);
+	auto overlaps = [&vMin, &vMax](const Item* item) {
+		return item->vMin.x <= vMax.x && item->vMax.x >= vMin.x
+				&& item->vMin.y <= vMax.y && item->vMax.y >= vMin.y;
+	};
+
+	found.insert(found.end(), unbounded.begin(), unbounded.end());
+	for (const Item* item: large) {
+		if (overlaps(item))
+			found.push_back(item);
+	}
+
+	std::unordered_set<const Item*> seen;
+	for (int r = row(vMin.y); r <= row(vMax.y); ++r) {
+		for (int c = column(vMin.x); c <= column(vMax.x); ++c) {
+			for (const Item* item: cells[r * columns + c]) {
+				if (overlaps(item) && seen.insert(item).second)
+					found.push_back(item);
+			}
+		}
+	}
+
+	std::sort(found.begin(), found.end(), [](const Item* a, const Item* b) {
+		return a->order < b->order;
+	});
+	std::vector<RS_Entity*> ret;
+	ret.reserve(found.size());
+	for (const Item* item: found)
+		ret.push_back(item->entity);
+	return ret;
+}
@@ -0,0 +1,142 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#ifndef LC_SPATIALINDEX_H
+#define LC_SPATIALINDEX_H
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include <QList>
+#include "rs_vector.h"
+
+class RS_Entity;
+
+/**
+ * \brief Uniform grid over the direct children of an entity container.
+ *
+ * Every entity is stored with its extent, which is the bounding box
+ * (getMin()/getMax()) extended by its reference points and its center.
+ * All snap points of an entity lie within this extent, so the distance
+ * from a coordinate to the extent is a lower bound for every nearest-point
+ * query on the entity.
+ *
+ * Entities without a usable extent (construction lines, empty containers)
+ * and entities spanning many cells are kept in separate lists which are
+ * visited by every query.
+ *
+ * The index does not own the entities. It keeps for every entity its
+ * position in the container order, so callers can break ties the same way
+ * as a linear walk over the container.
+ */
+class LC_SpatialIndex
+{
+public:
+	/**
+	 * Visitor for nearest queries. Called with the entity and its
+	 * position in the container order. Returns the distance of the best
+	 * match found so far, entities with an extent further away are skipped.
+	 */
+	typedef std::function<double(RS_Entity*, int)> NearestVisitor;
+
+	LC_SpatialIndex() = default;
+	~LC_SpatialIndex() = default;
+
+	//! minimum number of children before a container keeps an index
+	static int minimumEntities();
+
+	//! (re)builds the grid from the entities in container order
+	void build(const QList<RS_Entity*>& entities);
+	void clear();
+	bool isEmpty() const;
+	//! true, if too many entities were added outside of the grid
+	bool needsRebuild() const;
+
+	/**
+	 * Adds an entity after (or with prepend before) all other entities
+	 * in the container order.
+	 */
+	void insert(RS_Entity* entity, bool prepend = false);
+	void remove(RS_Entity* entity);
+	//! re-reads the extent of an entity after its geometry changed
+	void update(RS_Entity* entity);
+	bool contains(RS_Entity* entity) const;
+
+	/**
+	 * Calls visitor for entities in order of increasing distance of their
+	 * extent to coord, until no remaining extent is closer than the
+	 * distance returned by the visitor.
+	 */
+	void visitNearest(const RS_Vector& coord, const NearestVisitor& visitor) const;
+
+	/**
+	 * @return all entities whose extent overlaps the window v1, v2
+	 * including entities without extent, in container order.
+	 */
+	std::vector<RS_Entity*> entitiesInWindow(const RS_Vector& v1,
+											 const RS_Vector& v2) const;
+
+	/**
+	 * @brief getExtent bounding box including reference points and center
+	 * @return false, if the entity has no usable extent
+	 */
+	static bool getExtent(const RS_Entity* entity, RS_Vector& vMin, RS_Vector& vMax);
+
+private:
+	struct Item {
+		RS_Entity* entity;
+		RS_Vector vMin;
+		RS_Vector vMax;
+		int order;
+		bool bounded;
+		bool large;
+		int col0, row0, col1, row1;
+	};
+
+	void setupGrid(const RS_Vector& vMin, const RS_Vector& vMax, size_t count);
+	void addItem(Item& item);
+	void removeItem(const Item& item);
+	int column(double x) const;
+	int row(double y) const;
+	static double distanceTo(const Item& item, const RS_Vector& coord);
+
+	std::unordered_map<RS_Entity*, Item> items;
+	std::vector<std::vector<Item*>> cells;
+	//! entities without extent
+	std::vector<Item*> unbounded;
+	//! entities spanning too many cells
+	std::vector<Item*> large;
+
+	RS_Vector origin{0., 0.};
+	double cellWidth = 1.;
+	double cellHeight = 1.;
+	int columns = 0;
+	int rows = 0;
+	int minOrder = 0;
+	int maxOrder = -1;
+	size_t outside = 0;
+};
+
+#endif // LC_SPATIALINDEX_H
@@ -614,6 +614,12 @@ void LC_SplinePoints::UpdateQuadExtent(const RS_Vector& x1, const RS_Vector& c1,
 }
 
 void LC_SplinePoints::calculateBorders()
+{
+	UpdateExtent();
+	notifyBordersChanged();
+}
+
+void LC_SplinePoints::UpdateExtent()
 {
 	minV = RS_Vector(false);
 	maxV = RS_Vector(false);
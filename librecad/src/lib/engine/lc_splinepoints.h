@@ -76,6 +76,7 @@ private:
 	void drawSimple(RS_Painter* painter, RS_GraphicView* view);
 	void UpdateControlPoints();
 	void UpdateQuadExtent(const RS_Vector& x1, const RS_Vector& c1, const RS_Vector& x2);
+	void UpdateExtent();
 	int GetNearestQuad(const RS_Vector& coord, double* dist, double* dt) const;
 	RS_Vector GetSplinePointAtDist(double dDist, int iStartSeg, double dStartT,
 		int *piSeg, double *pdt) const;
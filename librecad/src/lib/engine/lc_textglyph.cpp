@@ -0,0 +1,261 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+
+#include <algorithm>
+#include <QBrush>
+#include <QPainterPath>
+
+#include "lc_textglyph.h"
+#include "lc_glyphcache.h"
+#include "rs_font.h"
+#include "rs_graphicview.h"
+#include "rs_insert.h"
+#include "rs_painter.h"
+
+LC_TextGlyph::LC_TextGlyph(RS_EntityContainer* parent,
+						   std::shared_ptr<const LC_Glyph> glyph,
+						   const RS_Vector& pos):
+	RS_AtomicEntity(parent)
+  ,glyph(std::move(glyph))
+  ,origin(pos)
+{
+	calculateBorders();
+}
+
+RS_Entity* LC_TextGlyph::clone() const
+{
+	LC_TextGlyph* g = new LC_TextGlyph(*this);
+	g->initId();
+	return g;
+}
+
+RS_Entity* LC_TextGlyph::createLetter(RS_EntityContainer* parent, RS_Font* font,
+									  const QString& letter, const RS_Vector& pos,
+									  bool materialized)
+{
+	std::shared_ptr<const LC_Glyph> glyph = LC_GLYPHCACHE->find(font, letter);
+	if (!glyph) {
+		return nullptr;
+	}
+
+	if (!materialized) {
+		LC_TextGlyph* ret = new LC_TextGlyph(parent, glyph, pos);
+		ret->setPen(RS_Pen(RS2::FlagInvalid));
+		ret->setLayer(nullptr);
+		return ret;
+	}
+
+	RS_InsertData d(letter,
+					pos,
+					RS_Vector(1.0, 1.0),
+					0.0,
+					1,1, RS_Vector(0.0,0.0),
+					font->getLetterList(), RS2::NoUpdate);
+	RS_Insert* ret = new RS_Insert(parent, d);
+	ret->setPen(RS_Pen(RS2::FlagInvalid));
+	ret->setLayer(nullptr);
+	ret->update();
+	ret->forcedCalculateBorders();
+	return ret;
+}
+
+QString LC_TextGlyph::getName() const
+{
+	return glyph->name;
+}
+
+RS_Vector LC_TextGlyph::toWorld(double x, double y) const
+{
+	return origin + axisX * x + axisY * y;
+}
+
+RS_Vector LC_TextGlyph::toWorld(const QPointF& p) const
+{
+	return toWorld(p.x(), p.y());
+}
+
+RS_VectorSolutions LC_TextGlyph::getRefPoints() const
+{
+	return RS_VectorSolutions{origin};
+}
+
+RS_Vector LC_TextGlyph::getNearestEndpoint(const RS_Vector& /*coord*/, double* dist) const
+{
+	if (dist) {
+		*dist = RS_MAXDOUBLE;
+	}
+	return RS_Vector(false);
+}
+
+RS_Vector LC_TextGlyph::getNearestPointOnEntity(const RS_Vector& coord,
+												bool /*onEntity*/,
+												double* dist,
+												RS_Entity** entity) const
+{
+	if (entity) {
+		*entity = const_cast<LC_TextGlyph*>(this);
+	}
+
+	double minDist = RS_MAXDOUBLE;
+	RS_Vector ret(false);
+	for (size_t i = 0; i < glyph->runs.size(); ++i) {
+		size_t const end = glyph->runEnd(i);
+		RS_Vector p1 = toWorld(glyph->points[glyph->runs[i]]);
+		for (size_t j = glyph->runs[i] + 1; j < end; ++j) {
+			RS_Vector const p2 = toWorld(glyph->points[j]);
+			RS_Vector const d = p2 - p1;
+			double const l2 = d.squared();
+			double t = 0.;
+			if (l2 > RS_TOLERANCE2) {
+				t = std::min(1., std::max(0., RS_Vector::dotP(coord - p1, d) / l2));
+			}
+			RS_Vector const p = p1 + d * t;
+			double const pd = p.distanceTo(coord);
+			if (pd < minDist) {
+				minDist = pd;
+				ret = p;
+			}
+			p1 = p2;
+		}
+	}
+
+	if (dist) {
+		*dist = minDist;
+	}
+	return ret;
+}
+
+RS_Vector LC_TextGlyph::getNearestCenter(const RS_Vector& /*coord*/, double* dist) const
+{
+	if (dist) {
+		*dist = RS_MAXDOUBLE;
+	}
+	return RS_Vector(false);
+}
+
+RS_Vector LC_TextGlyph::getNearestMiddle(const RS_Vector& /*coord*/,
+										 double* dist,
+										 int /*middlePoints*/) const
+{
+	if (dist) {
+		*dist = RS_MAXDOUBLE;
+	}
+	return RS_Vector(false);
+}
+
+RS_Vector LC_TextGlyph::getNearestDist(double /*distance*/,
+									   const RS_Vector& /*coord*/,
+									   double* dist) const
+{
+	if (dist) {
+		*dist = RS_MAXDOUBLE;
+	}
+	return RS_Vector(false);
+}
+
+void LC_TextGlyph::move(const RS_Vector& offset)
+{
+	origin.move(offset);
+	calculateBorders();
+}
+
+void LC_TextGlyph::rotate(const RS_Vector& center, const double& angle)
+{
+	rotate(center, RS_Vector(angle));
+}
+
+void LC_TextGlyph::rotate(const RS_Vector& center, const RS_Vector& angleVector)
+{
+	origin.rotate(center, angleVector);
+	axisX.rotate(angleVector);
+	axisY.rotate(angleVector);
+	calculateBorders();
+}
+
+void LC_TextGlyph::scale(const RS_Vector& center, const RS_Vector& factor)
+{
+	origin.scale(center, factor);
+	axisX.scale(factor);
+	axisY.scale(factor);
+	calculateBorders();
+}
+
+void LC_TextGlyph::mirror(const RS_Vector& axisPoint1, const RS_Vector& axisPoint2)
+{
+	RS_Vector const axis = axisPoint2 - axisPoint1;
+	origin.mirror(axisPoint1, axisPoint2);
+	axisX.mirror(RS_Vector(0., 0.), axis);
+	axisY.mirror(RS_Vector(0., 0.), axis);
+	calculateBorders();
+}
+
+void LC_TextGlyph::calculateBorders()
+{
+	if (glyph->minV.x > glyph->maxV.x || glyph->minV.y > glyph->maxV.y) {
+		// empty letter, leaves the borders of the text alone
+		minV = RS_Vector(RS_MAXDOUBLE, RS_MAXDOUBLE);
+		maxV = RS_Vector(RS_MINDOUBLE, RS_MINDOUBLE);
+	} else if (axisX.y == 0. && axisY.x == 0.) {
+		// not rotated, the borders of the letter block are exact
+		RS_Vector const v1 = toWorld(glyph->minV.x, glyph->minV.y);
+		RS_Vector const v2 = toWorld(glyph->maxV.x, glyph->maxV.y);
+		minV = RS_Vector::minimum(v1, v2);
+		maxV = RS_Vector::maximum(v1, v2);
+	} else {
+		minV = RS_Vector(RS_MAXDOUBLE, RS_MAXDOUBLE);
+		maxV = RS_Vector(RS_MINDOUBLE, RS_MINDOUBLE);
+		for (const QPointF& p: glyph->points) {
+			RS_Vector const v = toWorld(p);
+			minV = RS_Vector::minimum(minV, v);
+			maxV = RS_Vector::maximum(maxV, v);
+		}
+	}
+	notifyBordersChanged();
+}
+
+void LC_TextGlyph::draw(RS_Painter* painter, RS_GraphicView* view, double& /*patternOffset*/)
+{
+	if (!(painter && view) || glyph->runs.empty()) {
+		return;
+	}
+
+	QPainterPath path;
+	for (size_t i = 0; i < glyph->runs.size(); ++i) {
+		size_t const end = glyph->runEnd(i);
+		RS_Vector p = view->toGui(toWorld(glyph->points[glyph->runs[i]]));
+		path.moveTo(p.x, p.y);
+		for (size_t j = glyph->runs[i] + 1; j < end; ++j) {
+			p = view->toGui(toWorld(glyph->points[j]));
+			path.lineTo(p.x, p.y);
+		}
+	}
+
+	// outlines only
+	const QBrush brush(painter->brush());
+	painter->setBrush(QBrush());
+	painter->drawPath(path);
+	painter->setBrush(brush);
+}
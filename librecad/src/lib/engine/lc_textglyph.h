@@ -0,0 +1,115 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+
+#ifndef LC_TEXTGLYPH_H
+#define LC_TEXTGLYPH_H
+
+#include <memory>
+#include "rs_atomicentity.h"
+
+class QPointF;
+class RS_Font;
+struct LC_Glyph;
+
+/**
+ * \brief A letter of a text, drawn from a shared glyph.
+ *
+ * The glyph is mapped into the drawing by p' = origin + p.x * axisX
+ * + p.y * axisY, the text moves, scales and rotates its letters by
+ * changing this mapping. Letters are no snap targets, like the inserts
+ * of letter blocks they replace.
+ */
+class LC_TextGlyph : public RS_AtomicEntity {
+public:
+	LC_TextGlyph(RS_EntityContainer* parent,
+				 std::shared_ptr<const LC_Glyph> glyph,
+				 const RS_Vector& pos);
+
+	RS_Entity* clone() const override;
+
+	/**	@return RS2::EntityGlyph */
+	RS2::EntityType rtti() const override {
+		return RS2::EntityGlyph;
+	}
+
+	/**
+	 * Creates a letter of a text at pos with height 9, as used by
+	 * RS_Text and RS_MText: a glyph or, for materialized texts, an
+	 * insert of the letter block.
+	 *
+	 * @return nullptr, if the font has no such letter
+	 */
+	static RS_Entity* createLetter(RS_EntityContainer* parent, RS_Font* font,
+								   const QString& letter, const RS_Vector& pos,
+								   bool materialized);
+
+	//! @return the letter
+	QString getName() const;
+	RS_Vector getInsertionPoint() const {
+		return origin;
+	}
+	double getAngle() const {
+		return axisX.angle();
+	}
+
+	RS_VectorSolutions getRefPoints() const override;
+	RS_Vector getNearestEndpoint(const RS_Vector& coord,
+								 double* dist = nullptr) const override;
+	RS_Vector getNearestPointOnEntity(const RS_Vector& coord,
+									  bool onEntity = true,
+									  double* dist = nullptr,
+									  RS_Entity** entity = nullptr) const override;
+	RS_Vector getNearestCenter(const RS_Vector& coord,
+							   double* dist = nullptr) const override;
+	RS_Vector getNearestMiddle(const RS_Vector& coord,
+							   double* dist = nullptr,
+							   int middlePoints = 1) const override;
+	RS_Vector getNearestDist(double distance,
+							 const RS_Vector& coord,
+							 double* dist = nullptr) const override;
+
+	void move(const RS_Vector& offset) override;
+	void rotate(const RS_Vector& center, const double& angle) override;
+	void rotate(const RS_Vector& center, const RS_Vector& angleVector) override;
+	void scale(const RS_Vector& center, const RS_Vector& factor) override;
+	void mirror(const RS_Vector& axisPoint1, const RS_Vector& axisPoint2) override;
+
+	void draw(RS_Painter* painter, RS_GraphicView* view, double& patternOffset) override;
+
+	void calculateBorders() override;
+
+private:
+	//! maps a point of the glyph into the drawing
+	RS_Vector toWorld(double x, double y) const;
+	RS_Vector toWorld(const QPointF& p) const;
+
+	std::shared_ptr<const LC_Glyph> glyph;
+	RS_Vector origin;
+	RS_Vector axisX{1., 0.};
+	RS_Vector axisY{0., 1.};
+};
+
+#endif // LC_TEXTGLYPH_H
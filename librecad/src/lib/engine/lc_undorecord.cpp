@@ -0,0 +1,256 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#include <algorithm>
+
+#include "lc_undorecord.h"
+#include "rs_arc.h"
+#include "rs_circle.h"
+#include "rs_ellipse.h"
+#include "rs_insert.h"
+#include "rs_line.h"
+#include "rs_mtext.h"
+#include "rs_point.h"
+#include "rs_polyline.h"
+#include "rs_text.h"
+
+namespace {
+template<class E>
+void saveData(RS_Entity* entity, std::vector<std::function<void()>>& state)
+{
+	E* e = static_cast<E*>(entity);
+	auto const data = e->getData();
+	state.push_back([e, data]() {
+		e->setData(data);
+	});
+}
+}
+
+bool LC_UndoTransform::canRestore(const RS_Entity* entity)
+{
+	switch (entity->rtti()) {
+	case RS2::EntityLine:
+	case RS2::EntityArc:
+	case RS2::EntityCircle:
+	case RS2::EntityEllipse:
+	case RS2::EntityPoint:
+	case RS2::EntityInsert:
+	case RS2::EntityText:
+	case RS2::EntityMText:
+		return true;
+	case RS2::EntityPolyline:
+		for (const RS_Entity* e: *static_cast<const RS_Polyline*>(entity)) {
+			if (!canRestore(e)) {
+				return false;
+			}
+		}
+		return true;
+	default:
+		return false;
+	}
+}
+
+void LC_UndoTransform::addEntity(RS_Entity* entity)
+{
+	if (entity) {
+		entities.push_back(entity);
+	}
+}
+
+const std::vector<RS_Entity*>& LC_UndoTransform::getEntities() const
+{
+	return entities;
+}
+
+void LC_UndoTransform::move(const RS_Vector& offset)
+{
+	steps.push_back({Step::Move, offset, RS_Vector{}, 0.});
+}
+
+void LC_UndoTransform::rotate(const RS_Vector& center, double angle)
+{
+	steps.push_back({Step::Rotate, center, RS_Vector{}, angle});
+}
+
+void LC_UndoTransform::scale(const RS_Vector& center, const RS_Vector& factor)
+{
+	steps.push_back({Step::Scale, center, factor, 0.});
+}
+
+void LC_UndoTransform::mirror(const RS_Vector& axisPoint1, const RS_Vector& axisPoint2)
+{
+	steps.push_back({Step::Mirror, axisPoint1, axisPoint2, 0.});
+}
+
+void LC_UndoTransform::undo()
+{
+	restore(before);
+}
+
+void LC_UndoTransform::redo()
+{
+	if (applied) {
+		restore(after);
+		return;
+	}
+	for (RS_Entity* e: entities) {
+		saveState(e, before);
+	}
+	for (const Step& step: steps) {
+		apply(step);
+	}
+	for (RS_Entity* e: entities) {
+		saveState(e, after);
+	}
+	applied = true;
+	entitiesChanged();
+}
+
+void LC_UndoTransform::apply(const Step& step)
+{
+	for (RS_Entity* e: entities) {
+		switch (step.type) {
+		case Step::Move:
+			e->move(step.v1);
+			break;
+		case Step::Rotate:
+			e->rotate(step.v1, step.angle);
+			break;
+		case Step::Scale:
+			e->scale(step.v1, step.v2);
+			break;
+		case Step::Mirror:
+			e->mirror(step.v1, step.v2);
+			break;
+		}
+	}
+}
+
+void LC_UndoTransform::saveState(RS_Entity* entity, State& state)
+{
+	switch (entity->rtti()) {
+	case RS2::EntityLine:
+		saveData<RS_Line>(entity, state);
+		break;
+	case RS2::EntityArc:
+		saveData<RS_Arc>(entity, state);
+		break;
+	case RS2::EntityCircle:
+		saveData<RS_Circle>(entity, state);
+		break;
+	case RS2::EntityEllipse:
+		saveData<RS_Ellipse>(entity, state);
+		break;
+	case RS2::EntityPoint:
+		saveData<RS_Point>(entity, state);
+		break;
+	case RS2::EntityInsert:
+		saveData<RS_Insert>(entity, state);
+		break;
+	case RS2::EntityText:
+		saveData<RS_Text>(entity, state);
+		break;
+	case RS2::EntityMText:
+		saveData<RS_MText>(entity, state);
+		break;
+	case RS2::EntityPolyline:
+		for (RS_Entity* e: *static_cast<RS_Polyline*>(entity)) {
+			saveState(e, state);
+		}
+		saveData<RS_Polyline>(entity, state);
+		break;
+	default:
+		break;
+	}
+}
+
+void LC_UndoTransform::restore(const State& state)
+{
+	for (auto const& setData: state) {
+		setData();
+	}
+	entitiesChanged();
+}
+
+void LC_UndoTransform::entitiesChanged()
+{
+	std::vector<RS_EntityContainer*> parents;
+	for (RS_Entity* e: entities) {
+		switch (e->rtti()) {
+		case RS2::EntityInsert:
+		case RS2::EntityText:
+		case RS2::EntityMText:
+			// the sub-entities follow from the data
+			e->update();
+			break;
+		default:
+			e->calculateBorders();
+			break;
+		}
+		RS_EntityContainer* parent = e->getParent();
+		if (parent && std::find(parents.begin(), parents.end(), parent) == parents.end()) {
+			parents.push_back(parent);
+		}
+	}
+	// the borders of a parent may shrink
+	for (RS_EntityContainer* parent: parents) {
+		parent->adjustBordersToChildren();
+	}
+}
+
+void LC_UndoAttributes::addEntity(RS_Entity* entity, const RS_Pen& oldPen, RS_Layer* oldLayer)
+{
+	if (entity) {
+		changes.push_back({entity, oldPen, oldLayer,
+						   entity->getPen(false), entity->getLayer(false)});
+	}
+}
+
+bool LC_UndoAttributes::isEmpty() const
+{
+	return changes.empty();
+}
+
+void LC_UndoAttributes::undo()
+{
+	for (auto it = changes.rbegin(); it != changes.rend(); ++it) {
+		it->entity->setPen(it->oldPen);
+		it->entity->setLayer(it->oldLayer);
+		if (it->entity->rtti() == RS2::EntityInsert) {
+			static_cast<RS_Insert*>(it->entity)->update();
+		}
+	}
+}
+
+void LC_UndoAttributes::redo()
+{
+	for (const Change& change: changes) {
+		change.entity->setPen(change.newPen);
+		change.entity->setLayer(change.newLayer);
+		if (change.entity->rtti() == RS2::EntityInsert) {
+			static_cast<RS_Insert*>(change.entity)->update();
+		}
+	}
+}
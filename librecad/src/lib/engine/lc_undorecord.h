@@ -0,0 +1,139 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#ifndef LC_UNDORECORD_H
+#define LC_UNDORECORD_H
+
+#include <functional>
+#include <vector>
+#include "rs_pen.h"
+#include "rs_vector.h"
+
+class RS_Entity;
+class RS_Layer;
+
+/**
+ * \brief Change of existing entities, which can be undone in place.
+ *
+ * Unlike RS_Undoable entities, which are hidden and shown again, a record
+ * modifies its entities on undo and redo. Records are owned by the
+ * RS_UndoCycle they were added to.
+ *
+ * @see RS_UndoCycle
+ */
+class LC_UndoRecord
+{
+public:
+	virtual ~LC_UndoRecord() = default;
+
+	//! reverts the change
+	virtual void undo() = 0;
+	//! applies the change again
+	virtual void redo() = 0;
+};
+
+/**
+ * \brief Affine transformation of entities.
+ *
+ * Stores the steps of the transformation, the first redo applies them to
+ * the entities with their own move(), rotate(), scale() and mirror()
+ * methods. The defining data of the entities is kept from before and
+ * after the transformation, undo and redo restore it exactly.
+ */
+class LC_UndoTransform: public LC_UndoRecord
+{
+public:
+	//! true, if the data of entity can be restored, see addEntity()
+	static bool canRestore(const RS_Entity* entity);
+	//! entity must be restorable, see canRestore()
+	void addEntity(RS_Entity* entity);
+	const std::vector<RS_Entity*>& getEntities() const;
+
+	void move(const RS_Vector& offset);
+	void rotate(const RS_Vector& center, double angle);
+	void scale(const RS_Vector& center, const RS_Vector& factor);
+	void mirror(const RS_Vector& axisPoint1, const RS_Vector& axisPoint2);
+
+	void undo() override;
+	//! also applies the transformation the first time
+	void redo() override;
+
+private:
+	struct Step {
+		enum Type {
+			Move,
+			Rotate,
+			Scale,
+			Mirror
+		} type;
+		RS_Vector v1;
+		RS_Vector v2;
+		double angle;
+	};
+	//! setters restoring the data of the entities and their sub-entities
+	typedef std::vector<std::function<void()>> State;
+
+	void apply(const Step& step);
+	static void saveState(RS_Entity* entity, State& state);
+	void restore(const State& state);
+	//! updates inserts, spatial indices and borders of the parents
+	void entitiesChanged();
+
+	std::vector<RS_Entity*> entities;
+	std::vector<Step> steps;
+	bool applied = false;
+	State before;
+	State after;
+};
+
+/**
+ * \brief Change of layer and pen of entities.
+ */
+class LC_UndoAttributes: public LC_UndoRecord
+{
+public:
+	/**
+	 * Adds an entity, whose attributes were changed from oldPen and
+	 * oldLayer to its current ones.
+	 */
+	void addEntity(RS_Entity* entity, const RS_Pen& oldPen, RS_Layer* oldLayer);
+	bool isEmpty() const;
+
+	void undo() override;
+	void redo() override;
+
+private:
+	struct Change {
+		RS_Entity* entity;
+		RS_Pen oldPen;
+		RS_Layer* oldLayer;
+		RS_Pen newPen;
+		RS_Layer* newLayer;
+	};
+
+	std::vector<Change> changes;
+};
+
+#endif // LC_UNDORECORD_H
@@ -25,6 +25,7 @@
 
 #include "lc_undosection.h"
 #include "rs_document.h"
+#include "lc_undorecord.h"
 
 LC_UndoSection::LC_UndoSection(RS_Document *doc, const bool handleUndo /*= true*/) :
     document( doc),
@@ -48,3 +49,13 @@ void LC_UndoSection::addUndoable(RS_Undoable *undoable)
         document->addUndoable( undoable);
     }
 }
+
+void LC_UndoSection::addUndoRecord(LC_UndoRecord *record)
+{
+    if (valid) {
+        document->addUndoRecord( record);
+    }
+    else {
+        delete record;
+    }
+}
@@ -26,6 +26,7 @@
 #ifndef LC_UNDOSECTION_H
 #define LC_UNDOSECTION_H
 
+class LC_UndoRecord;
 class RS_Document;
 class RS_Undoable;
 
@@ -47,6 +48,8 @@ public:
     ~LC_UndoSection();
 
     void addUndoable(RS_Undoable * undoable);
+    //! takes ownership of record, which is deleted without undo handling
+    void addUndoRecord(LC_UndoRecord * record);
 
 private:
     RS_Document *document {nullptr};
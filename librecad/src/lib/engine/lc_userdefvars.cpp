@@ -0,0 +1,130 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+
+#include <mutex>
+#include <unordered_map>
+
+#include "lc_userdefvars.h"
+
+namespace {
+struct Table {
+	std::mutex mutex;
+	std::unordered_map<const LC_UserDefVars*, std::map<QString, QString>> vars;
+};
+
+//! never destroyed, entities may outlive static objects
+Table& table()
+{
+	static Table* t = new Table;
+	return *t;
+}
+}
+
+LC_UserDefVars::LC_UserDefVars(const LC_UserDefVars& other)
+{
+	*this = other;
+}
+
+LC_UserDefVars& LC_UserDefVars::operator = (const LC_UserDefVars& other)
+{
+	if (this == &other || (!used && !other.used)) {
+		return *this;
+	}
+	Table& t = table();
+	std::lock_guard<std::mutex> lock(t.mutex);
+	auto it = t.vars.find(&other);
+	if (it != t.vars.end()) {
+		// copy first, inserting may rehash
+		std::map<QString, QString> vars = it->second;
+		t.vars[this] = std::move(vars);
+		used = true;
+	} else if (used) {
+		t.vars.erase(this);
+		used = false;
+	}
+	return *this;
+}
+
+LC_UserDefVars::~LC_UserDefVars()
+{
+	if (used) {
+		Table& t = table();
+		std::lock_guard<std::mutex> lock(t.mutex);
+		t.vars.erase(this);
+	}
+}
+
+QString LC_UserDefVars::get(const QString& key) const
+{
+	if (!used) {
+		return QString();
+	}
+	Table& t = table();
+	std::lock_guard<std::mutex> lock(t.mutex);
+	auto it = t.vars.find(this);
+	if (it == t.vars.end()) {
+		return QString();
+	}
+	auto value = it->second.find(key);
+	return value == it->second.end() ? QString() : value->second;
+}
+
+void LC_UserDefVars::insert(const QString& key, const QString& value)
+{
+	Table& t = table();
+	std::lock_guard<std::mutex> lock(t.mutex);
+	t.vars[this].insert(std::make_pair(key, value));
+	used = true;
+}
+
+void LC_UserDefVars::remove(const QString& key)
+{
+	if (!used) {
+		return;
+	}
+	Table& t = table();
+	std::lock_guard<std::mutex> lock(t.mutex);
+	auto it = t.vars.find(this);
+	if (it == t.vars.end()) {
+		return;
+	}
+	it->second.erase(key);
+	if (it->second.empty()) {
+		t.vars.erase(it);
+		used = false;
+	}
+}
+
+std::map<QString, QString> LC_UserDefVars::getAll() const
+{
+	if (!used) {
+		return {};
+	}
+	Table& t = table();
+	std::lock_guard<std::mutex> lock(t.mutex);
+	auto it = t.vars.find(this);
+	return it == t.vars.end() ? std::map<QString, QString>() : it->second;
+}
@@ -0,0 +1,62 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+
+#ifndef LC_USERDEFVARS_H
+#define LC_USERDEFVARS_H
+
+#include <map>
+#include <QString>
+
+/**
+ * \brief User defined variables of an entity.
+ *
+ * Few entities have user defined variables, so the variables are kept in
+ * a table shared by all entities instead of a map in every entity. The
+ * table is keyed by the address of this object, which lives as long as
+ * its entity. Copies get their own copy of the variables.
+ */
+class LC_UserDefVars
+{
+public:
+	LC_UserDefVars() = default;
+	LC_UserDefVars(const LC_UserDefVars& other);
+	LC_UserDefVars& operator = (const LC_UserDefVars& other);
+	~LC_UserDefVars();
+
+	//! @return the value of key or a null string
+	QString get(const QString& key) const;
+	//! adds key with value, the value of an existing key is kept
+	void insert(const QString& key, const QString& value);
+	void remove(const QString& key);
+	//! @return all variables, sorted by key
+	std::map<QString, QString> getAll() const;
+
+private:
+	//! true, if the table may hold variables of this object
+	bool used = false;
+};
+
+#endif // LC_USERDEFVARS_H
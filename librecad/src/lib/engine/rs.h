@@ -152,7 +152,8 @@ public:
         EntityOverlayBox,    /**< OverlayBox */
         EntityPreview,    /**< Preview Container */
         EntityPattern,
-        EntityOverlayLine
+        EntityOverlayLine,
+        EntityGlyph         /**< Letter of a text, see LC_TextGlyph */
     };
 
 
@@ -932,6 +933,8 @@ public:
                 RedrawGrid = 1,
                 RedrawOverlay = 2,
                 RedrawDrawing = 4,
+                RedrawDirtyAreas = 8, // redraw the dirty areas of the drawing only
+                RedrawView = 16, // the view moved or zoomed, the drawing itself is unchanged
                 RedrawAll = 0xffff
         };
 
@@ -275,6 +275,7 @@ void RS_Arc::calculateBorders() {
 
     minV.set(minX, minY);
     maxV.set(maxX, maxY);
+    notifyBordersChanged();
 }
 
 
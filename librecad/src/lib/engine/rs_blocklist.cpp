@@ -24,7 +24,6 @@
 **
 **********************************************************************/
 
-#include <set>
 #include <iostream>
 #include <QString>
 #include <QRegExp>
@@ -53,11 +52,31 @@ RS_BlockList::RS_BlockList(bool owner) {
  */
 void RS_BlockList::clear() {
     blocks.clear();
+	blockIndex.clear();
 	activeBlock = nullptr;
 	setModified(true);
 }
 
 
+/**
+ * Replaces the blocks in this blocklist by the blocks of other, which is
+ * left empty. The active block is taken over. Listeners of this list are
+ * notified once about the added blocks.
+ */
+void RS_BlockList::take(RS_BlockList& other) {
+	blocks = other.blocks;
+	other.blocks.clear();
+	blockIndex = other.blockIndex;
+	other.blockIndex.clear();
+	activeBlock = other.activeBlock;
+	other.activeBlock = nullptr;
+	other.setModified(true);
+
+	addNotification();
+	setModified(true);
+}
+
+
 /**
  * Activates the given block.
  * Listeners are notified.
@@ -98,6 +117,7 @@ bool RS_BlockList::add(RS_Block* block, bool notify) {
     RS_Block* b = find(block->getName());
 	if (!b) {
         blocks.append(block);
+		blockIndex.insert(block->getName(), block);
 
         if (notify) {
             addNotification();
@@ -140,6 +160,9 @@ void RS_BlockList::remove(RS_Block* block) {
 
     // here the block is removed from the list but not deleted
     blocks.removeOne(block);
+	if (block && blockIndex.value(block->getName())==block) {
+		blockIndex.remove(block->getName());
+	}
 
 	for(auto l: blockListListeners){
 		l->blockRemoved(block);
@@ -173,6 +196,10 @@ void RS_BlockList::remove(RS_Block* block) {
 bool RS_BlockList::rename(RS_Block* block, const QString& name) {
 	if (block) {
 		if (!find(name)) {
+			if (blockIndex.value(block->getName())==block) {
+				blockIndex.remove(block->getName());
+				blockIndex.insert(name, block);
+			}
 			block->setName(name);
 			setModified(true);
 			return true;
@@ -205,36 +232,42 @@ void RS_BlockList::editBlock(RS_Block* block, const RS_Block& source) {
  * \p nullptr if no such block was found.
  */
 RS_Block* RS_BlockList::find(const QString& name) {
-    try {
-        RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_BlockList::find(): %s", name.toLatin1().constData());
-    }
-    catch(...) {
-        RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_BlockList::find(): wrong name to find");
-        return nullptr;
-    }
-	// Todo : reduce this from O(N) to O(log(N)) complexity based on sorted list or hash
-	//DFS
-	std::vector<RS_BlockList const*> nodes;
-	std::set<RS_BlockList const*> searched;
-	searched.insert(nullptr);
-	nodes.push_back(this);
-	while (nodes.size()) {
-		auto list = nodes.back();
-		nodes.pop_back();
-        for (RS_Block* blk: *list) {
-            if (blk->getName() == name) {
-                RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_BlockList::find(): OK");
-                return blk;
-            }
-            auto node = blk->getBlockList();
-			if (!searched.count(node)) {
-				searched.insert(list);
-                nodes.push_back(blk->getBlockList());
-			}
+	std::lock_guard<std::mutex> lock(lookupMutex);
+	++lookupStats.lookups;
+
+	RS_Block* b = blockIndex.value(name, nullptr);
+	if (b) {
+		++lookupStats.comparisons;
+		if (b->getName() != name) {
+			// renamed behind our back
+			rebuildIndex();
+			b = blockIndex.value(name, nullptr);
 		}
 	}
-    RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_BlockList::find(): bad");
-	return nullptr;
+
+	if (b) {
+		++lookupStats.hits;
+	}
+	return b;
+}
+
+/**
+ * Rebuilds the index of the blocks by name.
+ */
+void RS_BlockList::rebuildIndex() {
+	++lookupStats.rebuilds;
+	blockIndex.clear();
+	for (RS_Block* b: blocks) {
+		blockIndex.insert(b->getName(), b);
+	}
+}
+
+const LC_LookupStats& RS_BlockList::getLookupStats() const {
+	return lookupStats;
+}
+
+void RS_BlockList::resetLookupStats() {
+	lookupStats.reset();
 }
 
 /**
@@ -29,9 +29,12 @@
 #define RS_BLOCKLIST_H
 
 
+#include <mutex>
+#include <QHash>
 #include <QList>
+#include <QString>
+#include "lc_lookupstats.h"
 
-class QString;
 class RS_Block;
 class RS_BlockListListener;
 
@@ -48,6 +51,7 @@ public:
 	virtual ~RS_BlockList() = default;
 
     void clear();
+	void take(RS_BlockList& other);
     /**
      * @return Number of blocks available.
      */
@@ -95,13 +99,27 @@ public:
      */
 	bool isModified() const;
 
+	//! @return statistics of the lookups by name
+	const LC_LookupStats& getLookupStats() const;
+	void resetLookupStats();
+
     friend std::ostream& operator << (std::ostream& os, RS_BlockList& b);
 
 private:
+	void rebuildIndex();
+
     //! Is the list owning the blocks?
     bool owner;
     //! Blocks in the graphic
     QList<RS_Block*> blocks;
+	/**
+	 * Blocks by name. Blocks are renamed by rename() only, which keeps
+	 * the index up to date.
+	 */
+	QHash<QString, RS_Block*> blockIndex;
+	LC_LookupStats lookupStats;
+	//! blocks are looked up by regenerations on several threads
+	std::mutex lookupMutex;
     //! List of registered BlockListListeners
     QList<RS_BlockListListener*> blockListListeners;
     //! Currently active block
@@ -88,6 +88,7 @@ void RS_Circle::calculateBorders() {
 	RS_Vector r(data.radius,data.radius);
 	minV = data.center - r;
 	maxV = data.center + r;
+	notifyBordersChanged();
 }
 
 
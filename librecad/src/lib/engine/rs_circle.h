@@ -75,6 +75,10 @@ public:
 	const RS_CircleData& getData() const {
         return data;
     }
+    /** Sets new circle parameters. **/
+    void setData(const RS_CircleData& d) {
+        data = d;
+    }
 
 	RS_VectorSolutions getRefPoints() const override;
 
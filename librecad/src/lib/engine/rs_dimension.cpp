@@ -34,6 +34,7 @@
 #include "rs_math.h"
 #include "rs_filterdxfrw.h" //for int <-> rs_color conversion
 #include "rs_debug.h"
+#include "lc_regeneration.h"
 
 RS_DimensionData::RS_DimensionData():
 	definitionPoint(false),
@@ -681,8 +682,9 @@ double RS_Dimension::getTextHeight() {
 bool RS_Dimension::getInsideHorizontalText() {
     int v = getGraphicVariableInt("$DIMTIH", 1);
     if (v>0) {
-        addGraphicVariable("$DIMTIH", 1, 70);
-        getGraphicVariableInt("$DIMTIH", 1);
+        if (getGraphicVariableInt("$DIMTIH", 0)!=1
+                && !LC_Regeneration::isUpdating())
+            addGraphicVariable("$DIMTIH", 1, 70);
 		return true;
     }
 	return false;
@@ -695,8 +697,6 @@ bool RS_Dimension::getInsideHorizontalText() {
 bool RS_Dimension::getFixedLengthOn() {
     int v = getGraphicVariableInt("$DIMFXLON", 0);
     if (v == 1) {
-        addGraphicVariable("$DIMFXLON", 1, 70);
-        getGraphicVariableInt("$DIMFXLON", 0);
 		return true;
     }
 	return false;
@@ -761,23 +761,39 @@ QString RS_Dimension::getTextStyle() {
  * @return the given graphic variable or the default value given in mm
  * converted to the graphic unit.
  * If the variable is not found it is added with the given default
- * value converted to the local unit.
+ * value converted to the local unit, unless entities are updated on
+ * several threads.
  */
 double RS_Dimension::getGraphicVariable(const QString& key, double defMM,
                                         int code) {
 
     double v = getGraphicVariableDouble(key, RS_MINDOUBLE);
     if (v<=RS_MINDOUBLE) {
-        addGraphicVariable(
-            key,
-            RS_Units::convert(defMM, RS2::Millimeter, getGraphicUnit()),
-            code);
+        double const def = RS_Units::convert(defMM, RS2::Millimeter, getGraphicUnit());
+        if (LC_Regeneration::isUpdating()) {
+            // read only, see LC_Regeneration::updateDimensions()
+            return def;
+        }
+        addGraphicVariable(key, def, code);
         v = getGraphicVariableDouble(key, 1.0);
     }
 
     return v;
 }
 
+void RS_Dimension::addDefaultGraphicVariables() {
+    getGeneralFactor();
+    getGeneralScale();
+    getArrowSize();
+    getTickSize();
+    getExtensionLineExtension();
+    getExtensionLineOffset();
+    getDimensionLineGap();
+    getTextHeight();
+    getInsideHorizontalText();
+    getFixedLength();
+}
+
 /**
  * Removes zeros from angle string.
  *
@@ -856,6 +872,59 @@ QString RS_Dimension::stripZerosLinear(QString linear, int zeros){
 }
 
 
+void RS_Dimension::update() {
+    // angular dimensions compute their text position while updating
+    if (rtti()!=RS2::EntityDimAngular && postponeUpdate()) {
+        clear();
+        calculateBorders();
+        return;
+    }
+    updateDim();
+}
+
+
+/**
+ * Borders of a dimension whose update is pending are estimated from its
+ * reference points and the size of its label.
+ */
+void RS_Dimension::calculateBorders() {
+    if (!isUpdatePending()) {
+        RS_EntityContainer::calculateBorders();
+        return;
+    }
+
+    resetBorders();
+    for (const RS_Vector& vp: getRefPoints()) {
+        if (vp.valid) {
+            minV = RS_Vector::minimum(minV, vp);
+            maxV = RS_Vector::maximum(maxV, vp);
+        }
+    }
+    if (data.middleOfText.valid) {
+        minV = RS_Vector::minimum(minV, data.middleOfText);
+        maxV = RS_Vector::maximum(maxV, data.middleOfText);
+    }
+    if (minV.x<=maxV.x) {
+        double const scale = getGeneralScale();
+        double const margin = (getLabel().length()+2)*getTextHeight()*scale
+                + (getArrowSize()+getExtensionLineExtension())*scale;
+        minV.move(RS_Vector(-margin, -margin));
+        maxV.move(RS_Vector(margin, margin));
+    }
+    notifyBordersChanged();
+}
+
+
+void RS_Dimension::forcedCalculateBorders() {
+    if (isUpdatePending()) {
+        calculateBorders();
+        return;
+    }
+    RS_EntityContainer::forcedCalculateBorders();
+}
+
+
+
 void RS_Dimension::move(const RS_Vector& offset) {
 	data.definitionPoint.move(offset);
     data.middleOfText.move(offset);
@@ -124,9 +124,9 @@ public:
      * Must be overwritten by implementing dimension entity class
      * to update the subentities which make up the dimension entity.
      */
-	void update() override{
-            updateDim();
-        }
+	void update() override;
+	void calculateBorders() override;
+	void forcedCalculateBorders() override;
 
     virtual void updateDim(bool autoText=false) = 0;
 
@@ -188,6 +188,11 @@ public:
     QString getTextStyle();
 
         double getGraphicVariable(const QString& key, double defMM, int code);
+    /**
+     * Adds the dimension variables missing in the graphic with their
+     * defaults, so that updates only read the variables afterwards.
+     */
+    void addDefaultGraphicVariables();
         static QString stripZerosAngle(QString angle, int zeros=0);
         static QString stripZerosLinear(QString linear, int zeros=1);
 
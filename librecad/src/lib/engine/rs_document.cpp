@@ -28,6 +28,7 @@
 
 #include "rs_document.h"
 #include "rs_debug.h"
+#include "rs_graphicview.h"
 
 
 /**
@@ -51,6 +52,78 @@ RS_Document::RS_Document(RS_EntityContainer* parent)
     gv = NULL;//used to read/save current view
 }
 
+void RS_Document::removeUndoables(const std::vector<RS_Undoable*>& obsolete)
+{
+    std::vector<RS_Entity*> toRemove;
+    for (RS_Undoable* u: obsolete) {
+        if (u && u->undoRtti()==RS2::UndoableEntity && u->isUndone()) {
+            toRemove.push_back(static_cast<RS_Entity*>(u));
+        }
+    }
+    removeEntities(toRemove);
+}
+
+void RS_Document::startBulkEdit()
+{
+    if (0 < bulkEditCount++) {
+        return;
+    }
+
+    bulkAutoUpdateBorders = autoUpdateBorders;
+    setAutoUpdateBorders(false);
+}
+
+void RS_Document::endBulkEdit()
+{
+    if (0 == bulkEditCount) {
+        RS_DEBUG->print(RS_Debug::D_WARNING, "RS_Document::endBulkEdit() called without previous startBulkEdit()");
+        return;
+    }
+    if (0 < --bulkEditCount) {
+        return;
+    }
+
+    setAutoUpdateBorders(bulkAutoUpdateBorders);
+    if (bulkUpdateInserts) {
+        bulkUpdateInserts = false;
+        updateInserts();
+    }
+    if (bulkUpdateDimensions) {
+        bulkUpdateDimensions = false;
+        bool const autoText = bulkAutoText;
+        bulkAutoText = false;
+        updateDimensions(autoText);
+    }
+    calculateBorders();
+    if (gv) {
+        gv->redraw(RS2::RedrawDrawing);
+    }
+}
+
+bool RS_Document::isBulkEdit() const
+{
+    return 0 < bulkEditCount;
+}
+
+void RS_Document::updateInserts()
+{
+    if (isBulkEdit()) {
+        bulkUpdateInserts = true;
+        return;
+    }
+    RS_EntityContainer::updateInserts();
+}
+
+void RS_Document::updateDimensions(bool autoText)
+{
+    if (isBulkEdit()) {
+        bulkAutoText = bulkAutoText || autoText;
+        bulkUpdateDimensions = true;
+        return;
+    }
+    RS_EntityContainer::updateDimensions(autoText);
+}
+
 /**
  * Overwritten to set modified flag when undo cycle finished with undoable(s).
  */
@@ -76,6 +76,11 @@ public:
         }
     }
 
+    /**
+     * Removes several entities at once, see removeUndoable().
+     */
+    void removeUndoables(const std::vector<RS_Undoable*>& obsolete) override;
+
     /**
      * @return Currently active drawing pen.
      */
@@ -136,6 +141,23 @@ public:
     void setGraphicView(RS_GraphicView * g) {gv = g;}
     RS_GraphicView* getGraphicView() {return gv;}
 
+    /**
+     * Starts a bulk edit, which suspends border updates, updates of
+     * inserts and dimensions and redraws of the drawing. They are done
+     * once when the last nested bulk edit ends.
+     *
+     * @see LC_BulkEdit
+     */
+    void startBulkEdit();
+    void endBulkEdit();
+    bool isBulkEdit() const;
+
+    /**
+     * Overwritten to defer the update during a bulk edit.
+     */
+    void updateInserts() override;
+    void updateDimensions(bool autoText=true) override;
+
 protected:
     /** Flag set if the document was modified and not yet saved. */
     bool modified;
@@ -149,6 +171,15 @@ protected:
 	RS2::FormatType formatType;
     RS_GraphicView * gv;//used to read/save current view
 
+private:
+    //! nesting level of bulk edits
+    int bulkEditCount {0};
+    //! autoUpdateBorders before the bulk edit
+    bool bulkAutoUpdateBorders {true};
+    bool bulkUpdateInserts {false};
+    bool bulkUpdateDimensions {false};
+    bool bulkAutoText {false};
+
 };
 
 
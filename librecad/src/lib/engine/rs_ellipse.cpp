@@ -213,6 +213,7 @@ void RS_Ellipse::calculateBorders() {
 
     minV.set(minX, minY);
 	maxV.set(maxX, maxY);
+	notifyBordersChanged();
 }
 
 
@@ -1319,6 +1320,11 @@ const RS_EllipseData& RS_Ellipse::getData() const
 	return data;
 }
 
+void RS_Ellipse::setData(const RS_EllipseData& d)
+{
+	data = d;
+}
+
 
 
 /* Dongxu Li's Version, 19 Aug 2011
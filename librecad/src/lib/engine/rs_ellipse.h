@@ -108,6 +108,8 @@ public:
 
     /** @return Copy of data that defines the ellipse. **/
 	const RS_EllipseData& getData() const;
+    /** Sets new ellipse parameters. **/
+    void setData(const RS_EllipseData& d);
 
 	RS_VectorSolutions getRefPoints() const override;
 
@@ -26,6 +26,8 @@
 **********************************************************************/
 
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <utility>
 #include <QPolygon>
@@ -49,6 +51,20 @@
 #include "rs_information.h"
 #include "lc_quadratic.h"
 #include "rs_debug.h"
+#include "lc_entitypool.h"
+
+namespace {
+//! last version of the pens of entities and layers
+std::atomic<unsigned long long> penVersions{0};
+}
+
+void* RS_Entity::operator new(std::size_t size) {
+	return LC_EntityPool::allocate(size);
+}
+
+void RS_Entity::operator delete(void* p, std::size_t size) {
+	LC_EntityPool::deallocate(p, size);
+}
 
 /**
  * Default constructor.
@@ -96,7 +112,8 @@ void RS_Entity::init() {
  * Gives this entity a new unique id.
  */
 void RS_Entity::initId() {
-    static unsigned long int idCounter=0;
+    // entities are created on several threads during regeneration
+    static std::atomic<unsigned long int> idCounter{0};
     id = idCounter++;
 }
 
@@ -116,10 +133,12 @@ void RS_Entity::resetBorders() {
 void RS_Entity::moveBorders(const RS_Vector& offset){
 	minV.move(offset);
 	maxV.move(offset);
+	notifyBordersChanged();
 }
 void RS_Entity::scaleBorders(const RS_Vector& center, const RS_Vector& factor){
 	minV.scale(center,factor);
 	maxV.scale(center,factor);
+	notifyBordersChanged();
 }
 
 
@@ -461,7 +480,7 @@ bool RS_Entity::isHighlighted() const{
 
 
 RS_Vector RS_Entity::getSize() const {
-	return maxV-minV;
+	return getMax()-getMin();
 }
 
 /**
@@ -748,6 +767,7 @@ void RS_Entity::setLayer(const QString& name) {
     } else {
 		layer = nullptr;
     }
+    invalidateResolvedPen();
 }
 
 
@@ -757,6 +777,7 @@ void RS_Entity::setLayer(const QString& name) {
  */
 void RS_Entity::setLayer(RS_Layer* l) {
     layer = l;
+    invalidateResolvedPen();
 }
 
 
@@ -774,6 +795,7 @@ void RS_Entity::setLayerToActive() {
     } else {
 		layer = nullptr;
     }
+    invalidateResolvedPen();
 }
 
 
@@ -857,6 +879,56 @@ RS_Pen RS_Entity::getPen(bool resolve) const {
 
 
 
+const RS_Pen& RS_Entity::getResolvedPen() const {
+    unsigned long long const stamp = getPenStamp();
+    if (resolvedPenStamp != stamp) {
+        resolvedPen = getPen(true);
+        resolvedPenStamp = stamp;
+    }
+    return resolvedPen;
+}
+
+
+
+bool RS_Entity::isResolvedPenCached() const {
+    return resolvedPenStamp == getPenStamp();
+}
+
+
+
+void RS_Entity::notifyBordersChanged() {
+    if (parent) {
+        parent->updateSpatialIndex(this);
+    }
+}
+
+
+
+unsigned long long RS_Entity::nextPenVersion() {
+    return ++penVersions;
+}
+
+
+
+/**
+ * @return the latest version of everything getPen(true) depends on: the
+ * pen, layer and parent of this entity, the pen of its layer and the
+ * stamps of its parents. Versions only grow, so the stamp changes with
+ * any of them.
+ */
+unsigned long long RS_Entity::getPenStamp() const {
+    unsigned long long stamp = penVersion;
+    if (layer) {
+        stamp = std::max(stamp, layer->getPenVersion());
+    }
+    if (parent) {
+        stamp = std::max(stamp, parent->getPenStamp());
+    }
+    return stamp;
+}
+
+
+
 /**
  * Sets the pen of this entity to the current pen of
  * the graphic this entity is in. If this entity (and none
@@ -866,6 +938,7 @@ void RS_Entity::setPenToActive() {
     RS_Document* doc = getDocument();
     if (doc) {
         pen = doc->getActivePen();
+        invalidateResolvedPen();
     } else {
         //RS_DEBUG->print(RS_Debug::D_WARNING, "RS_Entity::setPenToActive(): "
         //                "No document / active pen linked to this entity.");
@@ -949,9 +1022,7 @@ double RS_Entity::getStyleFactor(RS_GraphicView* view) {
  * @return User defined variable connected to this entity or nullptr if not found.
  */
 QString RS_Entity::getUserDefVar(const QString& key) const {
-	auto it=varList.find(key);
-	if(it==varList.end()) return nullptr;
-	return varList.at(key);
+	return varList.get(key);
 }
 /*
  * @coord
@@ -970,14 +1041,14 @@ RS_Vector RS_Entity::getNearestOrthTan(const RS_Vector& /*coord*/,
  * Add a user defined variable to this entity.
  */
 void RS_Entity::setUserDefVar(QString key, QString val) {
-	varList.insert(std::make_pair(key, val));
+	varList.insert(key, val);
 }
 
 /**
  * Deletes the given user defined variable.
  */
 void RS_Entity::delUserDefVar(QString key) {
-	varList.erase(key);
+	varList.remove(key);
 }
 
 /**
@@ -985,7 +1056,7 @@ void RS_Entity::delUserDefVar(QString key) {
  */
 std::vector<QString> RS_Entity::getAllKeys() const{
 	std::vector<QString> ret(0);
-	for(auto const& v: varList){
+	for(auto const& v: varList.getAll()){
 		ret.push_back(v.first);
 	}
 	return ret;
@@ -1074,7 +1145,7 @@ std::ostream& operator << (std::ostream& os, RS_Entity& e) {
     os << e.pen << "\n";
 
         os << "variable list:\n";
-	for(auto const& v: e.varList){
+	for(auto const& v: e.varList.getAll()){
 		os << v.first.toLatin1().data()<< ": "
 		   << v.second.toLatin1().data()
 			   << ", ";
@@ -29,10 +29,13 @@
 #ifndef RS_ENTITY_H
 #define RS_ENTITY_H
 
+#include <cmath>
+#include <limits>
 #include <map>
 #include "rs_vector.h"
 #include "rs_pen.h"
 #include "rs_undoable.h"
+#include "lc_userdefvars.h"
 
 class RS_Arc;
 class RS_Block;
@@ -68,8 +71,16 @@ public:
 
 	virtual RS_Entity* clone() const = 0;
 
+	/**
+	 * Entities are allocated from LC_EntityPool. Objects allocated by the
+	 * global new, e.g. ::new, have to be deleted by the global delete.
+	 */
+	static void* operator new(std::size_t size);
+	static void operator delete(void* p, std::size_t size);
+
 	virtual void reparent(RS_EntityContainer* parent) {
 		this->parent = parent;
+		invalidateResolvedPen();
 	}
 
     void resetBorders();
@@ -131,6 +142,7 @@ public:
      */
     void setParent(RS_EntityContainer* p) {
         parent = p;
+        invalidateResolvedPen();
     }
     /** @return The center point (x) of this arc */
     //get center for entities: arc, circle and ellipse
@@ -153,11 +165,31 @@ public:
      */
     void setPen(const RS_Pen& pen) {
         this->pen = pen;
+        invalidateResolvedPen();
     }
 
 
     void setPenToActive();
     RS_Pen getPen(bool resolve = true) const;
+    /**
+     * @return getPen(true), kept until the pen, layer or parent of this
+     * entity, the pen of its layer or the pen of a parent changes.
+     * Not thread safe, for drawing only: an entity is never drawn by
+     * two threads at once.
+     */
+    const RS_Pen& getResolvedPen() const;
+    //! true, if getResolvedPen() returns the kept pen without resolving it
+    bool isResolvedPenCached() const;
+    /**
+     * Drops the pen kept by getResolvedPen() of this entity and of the
+     * entities resolving their pens through it. Called whenever the pen,
+     * layer or parent of this entity changes.
+     */
+    void invalidateResolvedPen() {
+        penVersion = nextPenVersion();
+    }
+    //! @return a version of pens greater than all versions before
+    static unsigned long long nextPenVersion();
 
     /**
      * Must be overwritten to return true if an entity type
@@ -559,12 +591,56 @@ m0 x + m1 y + m2 =0
 	virtual bool isArcCircleLine() const;
 
 protected:
+	/**
+	 * Tells the parent that the borders of this entity changed, which keeps
+	 * the spatial index of the parent up to date. Called at the end of
+	 * calculateBorders(), moveBorders() and scaleBorders().
+	 */
+	void notifyBordersChanged();
+
+	/**
+	 * Corner of the borders. Only 2D, unlike RS_Vector, to keep entities
+	 * small. Converts to and from RS_Vector, an invalid RS_Vector is kept
+	 * as NaN in x.
+	 */
+	struct BorderPoint {
+		BorderPoint() = default;
+		BorderPoint(double vx, double vy): x(vx), y(vy) {}
+		BorderPoint(const RS_Vector& v): x(v.valid ? v.x : invalid()), y(v.y) {}
+		operator RS_Vector() const {
+			return isValid() ? RS_Vector(x, y) : RS_Vector(false);
+		}
+		bool isValid() const {
+			return !std::isnan(x);
+		}
+		void set(double vx, double vy) {
+			x = vx;
+			y = vy;
+		}
+		void move(const RS_Vector& offset) {
+			x += offset.x;
+			y += offset.y;
+		}
+		void scale(const RS_Vector& center, const RS_Vector& factor) {
+			*this = RS_Vector(*this).scale(center, factor);
+		}
+		bool isInWindowOrdered(const RS_Vector& vLow, const RS_Vector& vHigh) const {
+			return RS_Vector(*this).isInWindowOrdered(vLow, vHigh);
+		}
+		static double invalid() {
+			return std::numeric_limits<double>::quiet_NaN();
+		}
+
+		double x = invalid();
+		double y = 0.;
+	};
+
 	//! Entity's parent entity or nullptr is this entity has no parent.
 	RS_EntityContainer* parent = nullptr;
     //! minimum coordinates
-    RS_Vector minV;
+    BorderPoint minV;
     //! maximum coordinates
-    RS_Vector maxV;
+    BorderPoint maxV;
 
     //! Pointer to layer
     RS_Layer* layer;
@@ -579,7 +655,14 @@ protected:
     bool updateEnabled;
 
 private:
-	std::map<QString, QString> varList;
+	LC_UserDefVars varList;
+	unsigned long long getPenStamp() const;
+
+	//! version of pen, layer and parent, see invalidateResolvedPen()
+	unsigned long long penVersion = 0;
+	//! getPenStamp() when resolvedPen was resolved, ~0 if never
+	mutable unsigned long long resolvedPenStamp = ~0ull;
+	mutable RS_Pen resolvedPen;
 };
 
 #endif
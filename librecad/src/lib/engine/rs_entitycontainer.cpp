@@ -24,9 +24,12 @@
 **
 **********************************************************************/
 
+#include <atomic>
 #include <iostream>
 #include <cmath>
+#include <mutex>
 #include <set>
+#include <unordered_set>
 #include <QObject>
 
 #include "rs_dialogfactory.h"
@@ -44,8 +47,175 @@
 #include "rs_solid.h"
 #include "rs_information.h"
 #include "rs_graphicview.h"
+#include "lc_regeneration.h"
+#include "lc_spatialindex.h"
 
 bool RS_EntityContainer::autoUpdateBorders = true;
+bool RS_EntityContainer::lazyUpdates = true;
+
+struct RS_EntityContainer::IntersectionCache {
+	RS_Entity* entity;
+	//! changes of the container when the cache was built
+	unsigned long long changes;
+	/**
+	 * containers below the container, which resolved candidates belong
+	 * to, with their changes. Outer containers come first, an inner one
+	 * is only checked while its outer ones are unchanged.
+	 */
+	std::vector<std::pair<const RS_EntityContainer*, unsigned long long>> resolved;
+	//! candidate entities and their intersections with entity
+	std::vector<std::pair<RS_Entity*, RS_VectorSolutions>> intersections;
+};
+
+namespace {
+//! containers with fewer children look up positions with a linear search
+constexpr int minimumPositions = 64;
+
+/**
+ * @brief resolveEntity collects an entity, or its sub-entities, the same way
+ * RS_EntityContainer::firstEntity()/nextEntity() resolve it for the given level
+ */
+void resolveEntity(RS_Entity* en, RS2::ResolveLevel level, std::vector<RS_Entity*>& result)
+{
+	bool resolve = false;
+	if (en->isContainer()) {
+		switch (level) {
+		case RS2::ResolveAllButInserts:
+			resolve = en->rtti() != RS2::EntityInsert;
+			break;
+		case RS2::ResolveAllButTextImage:
+		case RS2::ResolveAllButTexts:
+			resolve = en->rtti() != RS2::EntityText && en->rtti() != RS2::EntityMText;
+			break;
+		case RS2::ResolveAll:
+			resolve = true;
+			break;
+		default:
+			break;
+		}
+	}
+	if (!resolve) {
+		result.push_back(en);
+		return;
+	}
+	RS_EntityContainer* ec = static_cast<RS_EntityContainer*>(en);
+	for (RS_Entity* e = ec->firstEntity(level); e; e = ec->nextEntity(level)) {
+		result.push_back(e);
+	}
+}
+
+/**
+ * \brief Border of a window for crossing selections.
+ *
+ * An entity crosses the window, if it intersects one of the four border
+ * lines within the tolerance of RS_Information::getIntersection(). Lines
+ * are clipped against the border directly, entities and sub-entities
+ * whose borders lie apart from the border lines are skipped.
+ */
+class CrossingWindow {
+public:
+	CrossingWindow(const RS_Vector& v1, const RS_Vector& v2):
+		v1(v1)
+	  , v2(v2)
+	  , vLow(RS_Vector::minimum(v1, v2))
+	  , vHigh(RS_Vector::maximum(v1, v2))
+	{
+		border.addRectangle(v1, v2);
+	}
+
+	bool isCrossedBy(RS_Entity* e) const
+	{
+		if (e->isContainer()) {
+			return isCrossedBy(static_cast<RS_EntityContainer*>(e));
+		}
+		if (e->rtti() == RS2::EntitySolid) {
+			return static_cast<RS_Solid*>(e)->isInCrossWindow(v1, v2);
+		}
+		if (e->rtti() == RS2::EntityLine && !e->isConstruction()) {
+			return isCrossedBy(static_cast<RS_Line*>(e));
+		}
+		for (RS_Entity* line: border) {
+			if (RS_Information::getIntersection(e, line, true).hasValid()) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+private:
+	//! tolerance of RS_Information::getIntersection()
+	static constexpr double tolerance = 1.0e-4;
+
+	bool isCrossedBy(RS_EntityContainer* ec) const
+	{
+		ec->ensureUpdated();
+		for (RS_Entity* e: *ec) {
+			if (!mayCross(e)) {
+				continue;
+			}
+			if (isCrossedBy(e)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool isCrossedBy(const RS_Line* line) const
+	{
+		RS_Vector const p1 = line->getStartpoint();
+		RS_Vector const d = line->getEndpoint() - p1;
+		double const length = d.magnitude();
+		if (length < RS_TOLERANCE) {
+			return false;
+		}
+		// the intersection has to lie on the line and on the border line
+		double const tMin = -tolerance / length;
+		double const tMax = 1. + tolerance / length;
+		auto crosses = [&](double p, double dp, double edge, double q, double dq,
+				double qLow, double qHigh) {
+			if (fabs(dp) < RS_TOLERANCE) {
+				// parallel
+				return false;
+			}
+			double const t = (edge - p) / dp;
+			double const at = q + t * dq;
+			return t >= tMin && t <= tMax
+					&& at >= qLow - tolerance && at <= qHigh + tolerance;
+		};
+		return crosses(p1.x, d.x, vLow.x, p1.y, d.y, vLow.y, vHigh.y)
+				|| crosses(p1.x, d.x, vHigh.x, p1.y, d.y, vLow.y, vHigh.y)
+				|| crosses(p1.y, d.y, vLow.y, p1.x, d.x, vLow.x, vHigh.x)
+				|| crosses(p1.y, d.y, vHigh.y, p1.x, d.x, vLow.x, vHigh.x);
+	}
+
+	/**
+	 * false, if the borders of e lie apart from all border lines: outside
+	 * of the window or strictly within it. Invisible entities and
+	 * entities on frozen layers don't keep their borders up to date.
+	 */
+	bool mayCross(const RS_Entity* e) const
+	{
+		if (!e->isVisible() || (e->getLayer() && e->getLayer()->isFrozen())
+				|| e->isConstruction()) {
+			return true;
+		}
+		RS_Vector const vMin = e->getMin();
+		RS_Vector const vMax = e->getMax();
+		if (vMin.x > vHigh.x + RS_TOLERANCE || vMax.x < vLow.x - RS_TOLERANCE
+				|| vMin.y > vHigh.y + RS_TOLERANCE || vMax.y < vLow.y - RS_TOLERANCE) {
+			return false;
+		}
+		return !(vMin.x > vLow.x + RS_TOLERANCE && vMax.x < vHigh.x - RS_TOLERANCE
+				 && vMin.y > vLow.y + RS_TOLERANCE && vMax.y < vHigh.y - RS_TOLERANCE);
+	}
+
+	RS_Vector const v1;
+	RS_Vector const v2;
+	RS_Vector const vLow;
+	RS_Vector const vHigh;
+	RS_EntityContainer border;
+};
+}
 
 /**
  * Default constructor.
@@ -66,14 +236,39 @@ RS_EntityContainer::RS_EntityContainer(RS_EntityContainer* parent,
 
 
 /**
- * Copy constructor. Makes a deep copy of all entities.
+ * Copy constructor. Makes a shallow copy of the entity list,
+ * detach() creates the deep copies. The spatial index is not copied.
  */
-/*
 RS_EntityContainer::RS_EntityContainer(const RS_EntityContainer& ec)
- : RS_Entity(ec) {
+	: RS_Entity(ec)
+	, entities(ec.entities)
+	, subContainer(ec.subContainer)
+	, entIdx(ec.entIdx)
+	, autoDelete(ec.autoDelete)
+	, updatePending(ec.isUpdatePending())
+{
+}
 
+/**
+ * Assignment, a shallow copy as by the copy constructor. The spatial
+ * index and the caches are rebuilt on demand.
+ */
+RS_EntityContainer& RS_EntityContainer::operator = (const RS_EntityContainer& ec)
+{
+	if (this != &ec) {
+		RS_Entity::operator = (ec);
+		entities = ec.entities;
+		subContainer = ec.subContainer;
+		entIdx = ec.entIdx;
+		autoDelete = ec.autoDelete;
+		updatePending.store(ec.isUpdatePending(), std::memory_order_release);
+		spatialIndex.reset();
+		childrenChanged();
+		positions.clear();
+		positionsDirty = true;
+	}
+	return *this;
 }
-*/
 
 
 
@@ -128,6 +323,8 @@ void RS_EntityContainer::detach() {
 
     // clear shared pointers:
     entities.clear();
+	invalidateSpatialIndex();
+	positionsDirty = true;
     setOwner(autoDel);
 
     // point to new deep copies:
@@ -232,63 +429,35 @@ bool RS_EntityContainer::toggleSelected() {
 /**
  * Selects all entities within the given area.
  *
+ * Only entities whose extent overlaps the window can lie within or cross
+ * it, the spatial index finds them.
+ *
  * @param select True to select, False to deselect the entities.
+ * @param cross True to also select entities crossing the window border.
  */
 void RS_EntityContainer::selectWindow(RS_Vector v1, RS_Vector v2,
                                       bool select, bool cross) {
 
-    bool included;
-
-	for(auto e: entities){
-
-        included = false;
-
-        if (e->isVisible()) {
-            if (e->isInWindow(v1, v2)) {
-                //e->setSelected(select);
-                included = true;
-			} else if (cross) {
-				RS_EntityContainer l;
-				l.addRectangle(v1, v2);
-                RS_VectorSolutions sol;
-
-                if (e->isContainer()) {
-                    RS_EntityContainer* ec = (RS_EntityContainer*)e;
-                    for (RS_Entity* se=ec->firstEntity(RS2::ResolveAll);
-						 se && included==false;
-                         se=ec->nextEntity(RS2::ResolveAll)) {
-
-                        if (se->rtti() == RS2::EntitySolid){
-							included = static_cast<RS_Solid*>(se)->isInCrossWindow(v1,v2);
-                        } else {
-							for (auto line: l) {
-                                sol = RS_Information::getIntersection(
-											se, line, true);
-                                if (sol.hasValid()) {
-                                    included = true;
-                                    break;
-                                }
-                            }
-                        }
-                    }
-                } else if (e->rtti() == RS2::EntitySolid){
-					included = static_cast<RS_Solid*>(e)->isInCrossWindow(v1,v2);
-                } else {
-					for (auto line: l) {
-						sol = RS_Information::getIntersection(e, line, true);
-                        if (sol.hasValid()) {
-                            included = true;
-                            break;
-                        }
-                    }
-                }
-            }
-        }
+	RS_Vector const margin{RS_TOLERANCE, RS_TOLERANCE};
+	RS_Vector const vLow = RS_Vector::minimum(v1, v2) - margin;
+	RS_Vector const vHigh = RS_Vector::maximum(v1, v2) + margin;
+	std::unique_ptr<CrossingWindow> window;
+	if (cross) {
+		window.reset(new CrossingWindow(v1, v2));
+	}
 
-        if (included) {
-            e->setSelected(select);
-        }
-    }
+	for (RS_Entity* e: getEntitiesInWindow(vLow, vHigh)) {
+		if (!e->isVisible()) {
+			continue;
+		}
+		if (e->isContainer()) {
+			// the borders of a pending update are estimated
+			static_cast<RS_EntityContainer*>(e)->ensureUpdated();
+		}
+		if (e->isInWindow(v1, v2) || (window && window->isCrossedBy(e))) {
+			e->setSelected(select);
+		}
+	}
 }
 
 
@@ -312,8 +481,9 @@ void RS_EntityContainer::addEntity(RS_Entity* entity) {
 
 	if (!entity) return;
 
-    if (entity->rtti()==RS2::EntityImage ||
-            entity->rtti()==RS2::EntityHatch) {
+    bool const prepend = entity->rtti()==RS2::EntityImage ||
+            entity->rtti()==RS2::EntityHatch;
+    if (prepend) {
         entities.prepend(entity);
     } else {
         entities.append(entity);
@@ -321,6 +491,7 @@ void RS_EntityContainer::addEntity(RS_Entity* entity) {
     if (autoUpdateBorders) {
         adjustBorders(entity);
     }
+	entityAdded(entity, prepend);
 }
 
 
@@ -334,6 +505,7 @@ void RS_EntityContainer::appendEntity(RS_Entity* entity){
     entities.append(entity);
     if (autoUpdateBorders)
         adjustBorders(entity);
+	entityAdded(entity, false);
 }
 
 /**
@@ -345,6 +517,7 @@ void RS_EntityContainer::prependEntity(RS_Entity* entity){
     entities.prepend(entity);
     if (autoUpdateBorders)
         adjustBorders(entity);
+	entityAdded(entity, true);
 }
 
 /**
@@ -365,6 +538,7 @@ void RS_EntityContainer::moveEntity(int index, QList<RS_Entity *>& entList){
         mid = entities.at(index);
     }
 
+	positionsDirty = true;
     for (int i = 0; i < entList.size(); ++i) {
         RS_Entity *e = entList.at(i);
         ret = entities.removeOne(e);
@@ -380,6 +554,8 @@ void RS_EntityContainer::moveEntity(int index, QList<RS_Entity *>& entList){
 	for(auto e: entList){
             entities.insert(ci++, e);
     }
+	// the drawing order changed
+	invalidateSpatialIndex();
 }
 
 /**
@@ -390,6 +566,8 @@ void RS_EntityContainer::insertEntity(int index, RS_Entity* entity) {
 	if (!entity) return;
 
     entities.insert(index, entity);
+	invalidateSpatialIndex();
+	positionsDirty = true;
 
     if (autoUpdateBorders) {
         adjustBorders(entity);
@@ -427,16 +605,53 @@ bool RS_EntityContainer::removeEntity(RS_Entity* entity) {
 	//RLZ TODO: in Q3PtrList if 'entity' is nullptr remove the current item-> at.(entIdx)
     //    and sets 'entIdx' in next() or last() if 'entity' is the last item in the list.
 	//    in LibreCAD is never called with nullptr
-    bool ret;
-    ret = entities.removeOne(entity);
+	int const index = indexOf(entity);
+	if (index < 0) {
+		return false;
+	}
+
+	// only an entity touching the borders can shrink them
+	bool const onBorder = autoUpdateBorders
+			&& (entity->getMin().x <= minV.x + RS_TOLERANCE
+				|| entity->getMin().y <= minV.y + RS_TOLERANCE
+				|| entity->getMax().x >= maxV.x - RS_TOLERANCE
+				|| entity->getMax().y >= maxV.y - RS_TOLERANCE);
+
+	entities.removeAt(index);
+	positions.erase(entity);
+	if (index < entities.size()) {
+		positionsDirty = true;
+	}
+	childrenChanged();
+	if (spatialIndex) {
+		spatialIndex->remove(entity);
+	}
 
-    if (autoDelete && ret) {
+    if (autoDelete) {
         delete entity;
     }
-    if (autoUpdateBorders) {
+    if (onBorder) {
         calculateBorders();
     }
-    return ret;
+    return true;
+}
+
+
+
+/**
+ * Removes the given entities in one pass, see removeEntity().
+ */
+int RS_EntityContainer::removeEntities(const std::vector<RS_Entity*>& toRemove) {
+	auto const removed = takeEntities(toRemove);
+	if (autoDelete) {
+		for (auto const& p: removed) {
+			delete p.second;
+		}
+	}
+	if (autoUpdateBorders && !removed.empty()) {
+		calculateBorders();
+	}
+	return (int) removed.size();
 }
 
 
@@ -445,6 +660,9 @@ bool RS_EntityContainer::removeEntity(RS_Entity* entity) {
  * Erases all entities in this container and resets the borders..
  */
 void RS_EntityContainer::clear() {
+	invalidateSpatialIndex();
+	positions.clear();
+	positionsDirty = true;
     if (autoDelete) {
         while (!entities.isEmpty())
             delete entities.takeFirst();
@@ -517,11 +735,10 @@ void RS_EntityContainer::adjustBorders(RS_Entity* entity) {
     //resetBorders();
 
 	if (entity) {
-        // make sure a container is not empty (otherwise the border
-        //   would get extended to 0/0):
-        if (!entity->isContainer() || entity->count()>0) {
+        if (hasBorders(entity)) {
             minV = RS_Vector::minimum(entity->getMin(),minV);
             maxV = RS_Vector::maximum(entity->getMax(),maxV);
+            notifyBordersChanged();
         }
 
         // Notify parents. The border for the parent might
@@ -533,6 +750,37 @@ void RS_EntityContainer::adjustBorders(RS_Entity* entity) {
 }
 
 
+/**
+ * Recalculates the borders of this container from the current borders of
+ * the children, which calculateBorders() recalculates as well.
+ */
+void RS_EntityContainer::adjustBordersToChildren() {
+	resetBorders();
+	for (RS_Entity* e: entities) {
+		RS_Layer* layer = e->getLayer();
+		if (e->isVisible() && !(layer && layer->isFrozen()) && hasBorders(e)) {
+			minV = RS_Vector::minimum(e->getMin(), minV);
+			maxV = RS_Vector::maximum(e->getMax(), maxV);
+		}
+	}
+	if (minV.x>maxV.x || minV.y>maxV.y) {
+		minV = maxV = RS_Vector(0., 0.);
+	}
+	notifyBordersChanged();
+}
+
+bool RS_EntityContainer::hasBorders(RS_Entity* entity)
+{
+	// make sure a container is not empty (otherwise the border
+	//   would get extended to 0/0), instanced inserts have borders
+	//   without entities:
+	return !entity->isContainer() || entity->count()>0
+			|| static_cast<RS_EntityContainer*>(entity)->isUpdatePending()
+			|| (entity->rtti()==RS2::EntityInsert
+				&& static_cast<RS_Insert*>(entity)->isInstanced());
+}
+
+
 /**
  * Recalculates the borders of this entity container.
  */
@@ -569,6 +817,7 @@ void RS_EntityContainer::calculateBorders() {
         minV.y = 0.0;
         maxV.y = 0.0;
     }
+    notifyBordersChanged();
 
     RS_DEBUG->print("RS_EntityCotnainer::calculateBorders: size: %f,%f",
                     getSize().x, getSize().y);
@@ -622,6 +871,7 @@ void RS_EntityContainer::forcedCalculateBorders() {
         minV.y = 0.0;
         maxV.y = 0.0;
     }
+    notifyBordersChanged();
 
     //RS_DEBUG->print("  borders: %f/%f %f/%f", minV.x, minV.y, maxV.x, maxV.y);
 
@@ -639,20 +889,7 @@ void RS_EntityContainer::updateDimensions(bool autoText) {
 
     RS_DEBUG->print("RS_EntityContainer::updateDimensions()");
 
-    //for (RS_Entity* e=firstEntity(RS2::ResolveNone);
-	//        e;
-    //        e=nextEntity(RS2::ResolveNone)) {
-
-	for (RS_Entity* e: entities){
-        if (RS_Information::isDimension(e->rtti())) {
-            // update and reposition label:
-            ((RS_Dimension*)e)->updateDim(autoText);
-        } else if(e->rtti()==RS2::EntityDimLeader)
-            e->update();
-        else if (e->isContainer()) {
-            ((RS_EntityContainer*)e)->updateDimensions(autoText);
-        }
-    }
+    LC_Regeneration::updateDimensions(this, autoText);
 
     RS_DEBUG->print("RS_EntityContainer::updateDimensions() OK");
 }
@@ -660,28 +897,15 @@ void RS_EntityContainer::updateDimensions(bool autoText) {
 
 
 /**
- * Updates all Insert entities in this container.
+ * Updates all Insert entities in this container. Inserts within nested
+ * blocks are updated first.
  */
 void RS_EntityContainer::updateInserts() {
 
     RS_DEBUG->print("RS_EntityContainer::updateInserts() ID/type: %d/%d", getId(), rtti());
 
-    for (RS_Entity* e: entities){
-        //// Only update our own inserts and not inserts of inserts
-        if (e->rtti()==RS2::EntityInsert  /*&& e->getParent()==this*/) {
-            ((RS_Insert*)e)->update();
-            RS_DEBUG->print("RS_EntityContainer::updateInserts: updated ID/type: %d/%d", e->getId(), e->rtti());
-        } else if (e->isContainer()) {
-            if (e->rtti()==RS2::EntityHatch) {
-                RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_EntityContainer::updateInserts: skip hatch ID/type: %d/%d", e->getId(), e->rtti());
-            } else {
-                RS_DEBUG->print("RS_EntityContainer::updateInserts: update container ID/type: %d/%d", e->getId(), e->rtti());
-                ((RS_EntityContainer*)e)->updateInserts();
-            }
-        } else {
-            RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_EntityContainer::updateInserts: skip entity ID/type: %d/%d", e->getId(), e->rtti());
-        }
-    }
+    LC_Regeneration::updateInserts(this);
+
     RS_DEBUG->print("RS_EntityContainer::updateInserts() ID/type: %d/%d OK", getId(), rtti());
 }
 
@@ -721,14 +945,7 @@ void RS_EntityContainer::updateSplines() {
 
     RS_DEBUG->print("RS_EntityContainer::updateSplines()");
 
-	for (RS_Entity* e: entities){
-        //// Only update our own inserts and not inserts of inserts
-        if (e->rtti()==RS2::EntitySpline  /*&& e->getParent()==this*/) {
-            ((RS_Spline*)e)->update();
-        } else if (e->isContainer() && e->rtti()!=RS2::EntityHatch) {
-            ((RS_EntityContainer*)e)->updateSplines();
-        }
-    }
+    LC_Regeneration::updateSplines(this);
 
     RS_DEBUG->print("RS_EntityContainer::updateSplines() OK");
 }
@@ -757,6 +974,9 @@ void RS_EntityContainer::addRectangle(RS_Vector const& v0, RS_Vector const& v1)
  */
 RS_Entity* RS_EntityContainer::firstEntity(RS2::ResolveLevel level) {
 	RS_Entity* e = nullptr;
+	if (level!=RS2::ResolveNone) {
+		ensureUpdated();
+	}
     entIdx = -1;
     switch (level) {
     case RS2::ResolveNone:
@@ -839,6 +1059,9 @@ RS_Entity* RS_EntityContainer::firstEntity(RS2::ResolveLevel level) {
  */
 RS_Entity* RS_EntityContainer::lastEntity(RS2::ResolveLevel level) {
 	RS_Entity* e = nullptr;
+	if (level!=RS2::ResolveNone) {
+		ensureUpdated();
+	}
 	if(!entities.size()) return nullptr;
     entIdx = entities.size()-1;
     switch (level) {
@@ -1102,6 +1325,8 @@ RS_Entity* RS_EntityContainer::entityAt(int index) {
 }
 
 void RS_EntityContainer::setEntityAt(int index,RS_Entity* en){
+	invalidateSpatialIndex();
+	positionsDirty = true;
 	if(autoDelete && entities.at(index)) {
 		delete entities.at(index);
 	}
@@ -1121,7 +1346,7 @@ int RS_EntityContainer::entityAt() {
  * Finds the given entity and makes it the current entity if found.
  */
 int RS_EntityContainer::findEntity(RS_Entity const* const entity) {
-	entIdx = entities.indexOf(const_cast<RS_Entity*>(entity));
+	entIdx = indexOf(entity);
     return entIdx;
 }
 
@@ -1131,27 +1356,32 @@ int RS_EntityContainer::findEntity(RS_Entity const* const entity) {
  */
 RS_Vector RS_EntityContainer::getNearestEndpoint(const RS_Vector& coord,
                                                  double* dist  )const {
+    ensureUpdated();
 
     double minDist = RS_MAXDOUBLE;  // minimum measured distance
     double curDist;                 // currently measured distance
     RS_Vector closestPoint(false);  // closest found endpoint
     RS_Vector point;                // endpoint found
+    int closestOrder = -1;          // container order of the closest entity
 
-	for (RS_Entity* en: entities){
+	visitNearest(coord, [&](RS_Entity* en, int order) {
 
 		if (en->isVisible()
                 && !en->getParent()->ignoredOnModification()
 				){//no end point for Insert, text, Dim
             point = en->getNearestEndpoint(coord, &curDist);
-            if (point.valid && curDist<minDist) {
+            if (point.valid && (curDist<minDist
+                                || (curDist==minDist && order<closestOrder))) {
                 closestPoint = point;
                 minDist = curDist;
+                closestOrder = order;
 				if (dist) {
                     *dist = minDist;
                 }
             }
         }
-    }
+        return minDist;
+    });
 
     return closestPoint;
 }
@@ -1164,6 +1394,7 @@ RS_Vector RS_EntityContainer::getNearestEndpoint(const RS_Vector& coord,
  */
 RS_Vector RS_EntityContainer::getNearestEndpoint(const RS_Vector& coord,
                                                  double* dist,  RS_Entity** pEntity)const {
+    ensureUpdated();
 
     double minDist = RS_MAXDOUBLE;  // minimum measured distance
     double curDist;                 // currently measured distance
@@ -1175,14 +1406,16 @@ RS_Vector RS_EntityContainer::getNearestEndpoint(const RS_Vector& coord,
 	//while ( (en = it.current())  ) {
     //    ++it;
 
-    unsigned i0=0;
-	for(auto en: entities){
+    int closestOrder = -1;          // container order of the closest entity
+	visitNearest(coord, [&](RS_Entity* en, int order) {
         if (!en->getParent()->ignoredOnModification() ){//no end point for Insert, text, Dim
-//            std::cout<<"find nearest for entity "<<i0<<std::endl;
+//            std::cout<<"find nearest for entity "<<order<<std::endl;
             point = en->getNearestEndpoint(coord, &curDist);
-            if (point.valid && curDist<minDist) {
+            if (point.valid && (curDist<minDist
+                                || (curDist==minDist && order<closestOrder))) {
                 closestPoint = point;
                 minDist = curDist;
+                closestOrder = order;
 				if (dist) {
                     *dist = minDist;
                 }
@@ -1191,8 +1424,8 @@ RS_Vector RS_EntityContainer::getNearestEndpoint(const RS_Vector& coord,
                 }
             }
         }
-        i0++;
-    }
+        return minDist;
+    });
 
 //    std::cout<<__FILE__<<" : "<<__func__<<" : line "<<__LINE__<<std::endl;
 //    std::cout<<"count()="<<const_cast<RS_EntityContainer*>(this)->count()<<"\tminDist= "<<minDist<<"\tclosestPoint="<<closestPoint;
@@ -1223,23 +1456,28 @@ RS_Vector RS_EntityContainer::getNearestPointOnEntity(const RS_Vector& coord,
 
 RS_Vector RS_EntityContainer::getNearestCenter(const RS_Vector& coord,
 											   double* dist) const{
+    ensureUpdated();
     double minDist = RS_MAXDOUBLE;  // minimum measured distance
     double curDist = RS_MAXDOUBLE;  // currently measured distance
     RS_Vector closestPoint(false);  // closest found endpoint
     RS_Vector point;                // endpoint found
+    int closestOrder = -1;          // container order of the closest entity
 
-	for(auto en: entities){
+	visitNearest(coord, [&](RS_Entity* en, int order) {
 
         if (en->isVisible()
 				&& !en->getParent()->ignoredSnap()
 				){//no center point for spline, text, Dim
             point = en->getNearestCenter(coord, &curDist);
-            if (point.valid && curDist<minDist) {
+            if (point.valid && (curDist<minDist
+                                || (curDist==minDist && order<closestOrder))) {
                 closestPoint = point;
                 minDist = curDist;
+                closestOrder = order;
             }
         }
-    }
+        return minDist;
+    });
 	if (dist) {
         *dist = minDist;
     }
@@ -1253,23 +1491,28 @@ RS_Vector RS_EntityContainer::getNearestMiddle(const RS_Vector& coord,
                                                double* dist,
                                                int middlePoints
                                                ) const{
+    ensureUpdated();
     double minDist = RS_MAXDOUBLE;  // minimum measured distance
     double curDist = RS_MAXDOUBLE;  // currently measured distance
     RS_Vector closestPoint(false);  // closest found endpoint
     RS_Vector point;                // endpoint found
+    int closestOrder = -1;          // container order of the closest entity
 
-	for(auto en: entities){
+	visitNearest(coord, [&](RS_Entity* en, int order) {
 
         if (en->isVisible()
 				&& !en->getParent()->ignoredSnap()
 				){//no midle point for spline, text, Dim
             point = en->getNearestMiddle(coord, &curDist, middlePoints);
-            if (point.valid && curDist<minDist) {
+            if (point.valid && (curDist<minDist
+                                || (curDist==minDist && order<closestOrder))) {
                 closestPoint = point;
                 minDist = curDist;
+                closestOrder = order;
             }
         }
-    }
+        return minDist;
+    });
 	if (dist) {
         *dist = minDist;
     }
@@ -1302,37 +1545,75 @@ RS_Vector RS_EntityContainer::getNearestDist(double distance,
  */
 RS_Vector RS_EntityContainer::getNearestIntersection(const RS_Vector& coord,
                                                      double* dist) {
+    ensureUpdated();
 
     double minDist = RS_MAXDOUBLE;  // minimum measured distance
     double curDist = RS_MAXDOUBLE;  // currently measured distance
     RS_Vector closestPoint(false);  // closest found endpoint
     RS_Vector point;                // endpoint found
-    RS_VectorSolutions sol;
     RS_Entity* closestEntity;
 
 	closestEntity = getNearestEntity(coord, nullptr, RS2::ResolveAllButTextImage);
 
 	if (closestEntity) {
-        for (RS_Entity* en = firstEntity(RS2::ResolveAllButTextImage);
-             en;
-             en = nextEntity(RS2::ResolveAllButTextImage)) {
+		if (!isIntersectionCacheValid(closestEntity)) {
+			intersectionCache.reset(new IntersectionCache{closestEntity, changes, {}, {}});
+
+			// broad phase: intersections on entities lie within the borders
+			// of both entities, construction lines have no useful borders
+			std::vector<RS_Entity*> candidates;
+			if (closestEntity->isConstruction()) {
+				for (RS_Entity* en: entities) {
+					resolveEntity(en, RS2::ResolveAllButTextImage, candidates);
+				}
+			} else {
+				RS_Vector const tol{RS_TOLERANCE, RS_TOLERANCE};
+				candidates = getEntitiesInWindow(closestEntity->getMin() - tol,
+												 closestEntity->getMax() + tol,
+												 RS2::ResolveAllButTextImage);
+			}
+
+			// resolved children of inserts change without a change of this
+			// container, when an insert is updated or edited in place
+			std::unordered_set<const RS_EntityContainer*> seen;
+			candidates.push_back(closestEntity);
+			for (RS_Entity* en: candidates) {
+				std::vector<const RS_EntityContainer*> outer;
+				for (const RS_EntityContainer* p = en->getParent();
+					 p && p != this && !seen.count(p); p = p->getParent()) {
+					outer.push_back(p);
+				}
+				for (auto it = outer.rbegin(); it != outer.rend(); ++it) {
+					seen.insert(*it);
+					intersectionCache->resolved.emplace_back(*it, (*it)->changes.load());
+				}
+			}
+			candidates.pop_back();
+
+			// invisible entities are kept, they may get visible again by undo
+			for (RS_Entity* en: candidates) {
+				RS_VectorSolutions sol = RS_Information::getIntersection(closestEntity,
+																		 en,
+																		 true);
+				if (sol.getNumber()>0) {
+					intersectionCache->intersections.emplace_back(en, sol);
+				}
+			}
+		}
+
+		for (auto const& p: intersectionCache->intersections) {
             if (
-                    !en->isVisible()
-					|| en->getParent()->ignoredSnap()
+                    !p.first->isVisible()
+					|| p.first->getParent()->ignoredSnap()
                     ){
                 continue;
             }
 
-            sol = RS_Information::getIntersection(closestEntity,
-                                                  en,
-                                                  true);
-
-			point=sol.getClosest(coord,&curDist,nullptr);
-            if(sol.getNumber()>0 && curDist<minDist){
+			point=p.second.getClosest(coord,&curDist,nullptr);
+            if(curDist<minDist){
                 closestPoint=point;
                 minDist=curDist;
             }
-
         }
     }
 	if(dist && closestPoint.valid) {
@@ -1346,25 +1627,30 @@ RS_Vector RS_EntityContainer::getNearestIntersection(const RS_Vector& coord,
 
 RS_Vector RS_EntityContainer::getNearestRef(const RS_Vector& coord,
 											double* dist) const{
+    ensureUpdated();
 
     double minDist = RS_MAXDOUBLE;  // minimum measured distance
     double curDist;                 // currently measured distance
     RS_Vector closestPoint(false);  // closest found endpoint
     RS_Vector point;                // endpoint found
+    int closestOrder = -1;          // container order of the closest entity
 
-	for(auto en: entities){
+	visitNearest(coord, [&](RS_Entity* en, int order) {
 
         if (en->isVisible()) {
             point = en->getNearestRef(coord, &curDist);
-            if (point.valid && curDist<minDist) {
+            if (point.valid && (curDist<minDist
+                                || (curDist==minDist && order<closestOrder))) {
                 closestPoint = point;
                 minDist = curDist;
+                closestOrder = order;
 				if (dist) {
                     *dist = minDist;
                 }
             }
         }
-    }
+        return minDist;
+    });
 
     return closestPoint;
 }
@@ -1372,25 +1658,30 @@ RS_Vector RS_EntityContainer::getNearestRef(const RS_Vector& coord,
 
 RS_Vector RS_EntityContainer::getNearestSelectedRef(const RS_Vector& coord,
 													double* dist) const{
+    ensureUpdated();
 
     double minDist = RS_MAXDOUBLE;  // minimum measured distance
     double curDist;                 // currently measured distance
     RS_Vector closestPoint(false);  // closest found endpoint
     RS_Vector point;                // endpoint found
+    int closestOrder = -1;          // container order of the closest entity
 
-	for(auto en: entities){
+	visitNearest(coord, [&](RS_Entity* en, int order) {
 
         if (en->isVisible() && en->isSelected() && !en->isParentSelected()) {
             point = en->getNearestSelectedRef(coord, &curDist);
-            if (point.valid && curDist<minDist) {
+            if (point.valid && (curDist<minDist
+                                || (curDist==minDist && order<closestOrder))) {
                 closestPoint = point;
                 minDist = curDist;
+                closestOrder = order;
 				if (dist) {
                     *dist = minDist;
                 }
             }
         }
-    }
+        return minDist;
+    });
 
     return closestPoint;
 }
@@ -1400,6 +1691,7 @@ double RS_EntityContainer::getDistanceToPoint(const RS_Vector& coord,
                                               RS_Entity** entity,
                                               RS2::ResolveLevel level,
                                               double solidDist) const{
+    ensureUpdated();
 
     RS_DEBUG->print("RS_EntityContainer::getDistanceToPoint");
 
@@ -1408,14 +1700,15 @@ double RS_EntityContainer::getDistanceToPoint(const RS_Vector& coord,
     double curDist;                     // currently measured distance
 	RS_Entity* closestEntity = nullptr;    // closest entity found
 	RS_Entity* subEntity = nullptr;
+	int closestOrder = -1;                 // container order of the closest entity
 
-	for(auto e: entities){
+	visitNearest(coord, [&](RS_Entity* e, int order) {
 
         if (e->isVisible()) {
             RS_DEBUG->print("entity: getDistanceToPoint");
             RS_DEBUG->print("entity: %d", e->rtti());
             // bug#426, need to ignore Images to find nearest intersections
-            if(level==RS2::ResolveAllButTextImage && e->rtti()==RS2::EntityImage) continue;
+            if(level==RS2::ResolveAllButTextImage && e->rtti()==RS2::EntityImage) return minDist;
             curDist = e->getDistanceToPoint(coord, &subEntity, level, solidDist);
 
             RS_DEBUG->print("entity: getDistanceToPoint: OK");
@@ -1428,8 +1721,10 @@ double RS_EntityContainer::getDistanceToPoint(const RS_Vector& coord,
 			 * drawn directly over top of another, and it's reasonable to assume that humans will
 			 * tend to want to reference entities that they see or have recently drawn as opposed
 			 * to deeper more forgotten and invisible ones...
+			 * With the spatial index, entities are not visited in container order,
+			 * so ties are resolved by the container order explicitly.
 			 */
-			if (curDist<=minDist)
+			if (curDist<minDist || (curDist==minDist && order>closestOrder))
 			{
                 switch(level){
                 case RS2::ResolveAll:
@@ -1440,9 +1735,11 @@ double RS_EntityContainer::getDistanceToPoint(const RS_Vector& coord,
                     closestEntity = e;
                 }
                 minDist = curDist;
+                closestOrder = order;
             }
         }
-    }
+        return minDist;
+    });
 
 	if (entity) {
         *entity = closestEntity;
@@ -1457,6 +1754,7 @@ double RS_EntityContainer::getDistanceToPoint(const RS_Vector& coord,
 RS_Entity* RS_EntityContainer::getNearestEntity(const RS_Vector& coord,
                                                 double* dist,
 												RS2::ResolveLevel level) const{
+    ensureUpdated();
 
     RS_DEBUG->print("RS_EntityContainer::getNearestEntity");
 
@@ -1637,6 +1935,7 @@ bool RS_EntityContainer::hasEndpointsWithinWindow(const RS_Vector& v1, const RS_
 
 
 void RS_EntityContainer::move(const RS_Vector& offset) {
+	invalidateSpatialIndex();
 	for(auto e: entities){
 
         e->move(offset);
@@ -1646,6 +1945,7 @@ void RS_EntityContainer::move(const RS_Vector& offset) {
     }
     if (autoUpdateBorders) {
         moveBorders(offset);
+        notifyBordersChanged();
     }
 }
 
@@ -1654,6 +1954,7 @@ void RS_EntityContainer::move(const RS_Vector& offset) {
 void RS_EntityContainer::rotate(const RS_Vector& center, const double& angle) {
     RS_Vector angleVector(angle);
 
+	invalidateSpatialIndex();
 	for(auto e: entities){
         e->rotate(center, angleVector);
     }
@@ -1665,6 +1966,7 @@ void RS_EntityContainer::rotate(const RS_Vector& center, const double& angle) {
 
 void RS_EntityContainer::rotate(const RS_Vector& center, const RS_Vector& angleVector) {
 
+	invalidateSpatialIndex();
 	for(auto e: entities){
         e->rotate(center, angleVector);
     }
@@ -1675,6 +1977,7 @@ void RS_EntityContainer::rotate(const RS_Vector& center, const RS_Vector& angleV
 
 
 void RS_EntityContainer::scale(const RS_Vector& center, const RS_Vector& factor) {
+	invalidateSpatialIndex();
     if (fabs(factor.x)>RS_TOLERANCE && fabs(factor.y)>RS_TOLERANCE) {
 
 		for(auto e: entities){
@@ -1689,6 +1992,7 @@ void RS_EntityContainer::scale(const RS_Vector& center, const RS_Vector& factor)
 
 
 void RS_EntityContainer::mirror(const RS_Vector& axisPoint1, const RS_Vector& axisPoint2) {
+	invalidateSpatialIndex();
 	if (axisPoint1.distanceTo(axisPoint2)>RS_TOLERANCE) {
 
 		for(auto e: entities){
@@ -1702,6 +2006,7 @@ void RS_EntityContainer::stretch(const RS_Vector& firstCorner,
                                  const RS_Vector& secondCorner,
                                  const RS_Vector& offset) {
 
+	invalidateSpatialIndex();
     if (getMin().isInWindow(firstCorner, secondCorner) &&
             getMax().isInWindow(firstCorner, secondCorner)) {
 
@@ -1722,6 +2027,7 @@ void RS_EntityContainer::stretch(const RS_Vector& firstCorner,
 void RS_EntityContainer::moveRef(const RS_Vector& ref,
                                  const RS_Vector& offset) {
 
+	invalidateSpatialIndex();
 
 	for(auto e: entities){
         e->moveRef(ref, offset);
@@ -1735,6 +2041,7 @@ void RS_EntityContainer::moveRef(const RS_Vector& ref,
 void RS_EntityContainer::moveSelectedRef(const RS_Vector& ref,
                                          const RS_Vector& offset) {
 
+	invalidateSpatialIndex();
 
 	for(auto e: entities){
         e->moveSelectedRef(ref, offset);
@@ -1745,6 +2052,8 @@ void RS_EntityContainer::moveSelectedRef(const RS_Vector& ref,
 }
 
 void RS_EntityContainer::revertDirection() {
+	invalidateSpatialIndex();
+	positionsDirty = true;
 	for(int k = 0; k < entities.size() / 2; ++k) {
 		entities.swap(k, entities.size() - 1 - k);
 	}
@@ -1766,6 +2075,7 @@ void RS_EntityContainer::draw(RS_Painter* painter, RS_GraphicView* view,
         return;
     }
 
+    ensureUpdated();
     foreach (auto e, entities)
     {
         view->drawEntity(painter, e);
@@ -1877,7 +2187,7 @@ std::ostream& operator << (std::ostream& os, RS_EntityContainer& ec) {
 
     os << tab << "EntityContainer[" << id << "]: \n";
     os << tab << "Borders[" << id << "]: "
-       << ec.minV << " - " << ec.maxV << "\n";
+       << ec.getMin() << " - " << ec.getMax() << "\n";
     //os << tab << "Unit[" << id << "]: "
     //<< RS_Units::unit2string (ec.unit) << "\n";
 	if (ec.getLayer()) {
@@ -1936,3 +2246,297 @@ const QList<RS_Entity*>& RS_EntityContainer::getEntityList()
 {
     return entities;
 }
+
+std::vector<RS_Entity*> RS_EntityContainer::getEntitiesInWindow(const RS_Vector& v1,
+																const RS_Vector& v2,
+																RS2::ResolveLevel level) const
+{
+	std::vector<RS_Entity*> ret;
+	if (LC_SpatialIndex* index = getSpatialIndex()) {
+		ret = index->entitiesInWindow(v1, v2);
+	} else {
+		RS_Vector const vLow = RS_Vector::minimum(v1, v2);
+		RS_Vector const vHigh = RS_Vector::maximum(v1, v2);
+		for (RS_Entity* e: entities) {
+			RS_Vector vMin, vMax;
+			if (!LC_SpatialIndex::getExtent(e, vMin, vMax)
+					|| (vMin.x <= vHigh.x && vMax.x >= vLow.x
+						&& vMin.y <= vHigh.y && vMax.y >= vLow.y)) {
+				ret.push_back(e);
+			}
+		}
+	}
+	if (level == RS2::ResolveNone) {
+		return ret;
+	}
+
+	std::vector<RS_Entity*> resolved;
+	for (RS_Entity* e: ret) {
+		resolveEntity(e, level, resolved);
+	}
+	return resolved;
+}
+
+void RS_EntityContainer::updateSpatialIndex(RS_Entity* entity)
+{
+	// a pending update reports the borders once it is done
+	if (entity->isContainer()
+			&& static_cast<RS_EntityContainer*>(entity)->isUpdatingHere()) {
+		return;
+	}
+	// children of a container without index and cache may be updated
+	// on several threads, see LC_Regeneration
+	childrenChanged();
+	if (spatialIndex) {
+		spatialIndex->update(entity);
+	}
+}
+
+void RS_EntityContainer::invalidateSpatialIndex()
+{
+	childrenChanged();
+	spatialIndex.reset();
+}
+
+void RS_EntityContainer::childrenChanged()
+{
+	++changes;
+}
+
+bool RS_EntityContainer::isIntersectionCacheValid(RS_Entity* closestEntity) const
+{
+	if (!intersectionCache || intersectionCache->entity != closestEntity
+			|| intersectionCache->changes != changes) {
+		return false;
+	}
+	// an inner container may be deleted, when an outer one was changed
+	for (auto const& p: intersectionCache->resolved) {
+		if (p.first->changes != p.second) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void RS_EntityContainer::entityAdded(RS_Entity* entity, bool prepend)
+{
+	childrenChanged();
+	if (spatialIndex) {
+		spatialIndex->insert(entity, prepend);
+	}
+	if (prepend || positionsDirty || entities.size() <= minimumPositions) {
+		positionsDirty = true;
+	} else {
+		positions[entity] = entities.size() - 1;
+	}
+}
+
+int RS_EntityContainer::indexOf(const RS_Entity* entity) const
+{
+	if (entities.size() < minimumPositions) {
+		return entities.indexOf(const_cast<RS_Entity*>(entity));
+	}
+
+	auto it = positions.find(entity);
+	if (it != positions.end()) {
+		if (it->second < entities.size() && entities.at(it->second) == entity) {
+			return it->second;
+		}
+	} else if (!positionsDirty) {
+		return -1;
+	}
+
+	positions.clear();
+	positions.reserve(entities.size());
+	for (int i = 0; i < entities.size(); ++i) {
+		positions[entities.at(i)] = i;
+	}
+	positionsDirty = false;
+	it = positions.find(entity);
+	return it != positions.end() ? it->second : -1;
+}
+
+std::vector<std::pair<int, RS_Entity*>> RS_EntityContainer::takeEntities(const std::vector<RS_Entity*>& toTake)
+{
+	std::vector<std::pair<int, RS_Entity*>> taken;
+	if (toTake.empty()) {
+		return taken;
+	}
+
+	std::unordered_set<const RS_Entity*> const wanted(toTake.begin(), toTake.end());
+	QList<RS_Entity*> kept;
+	kept.reserve(entities.size());
+	for (int i = 0; i < entities.size(); ++i) {
+		RS_Entity* e = entities.at(i);
+		if (wanted.count(e)) {
+			taken.emplace_back(i, e);
+		} else {
+			kept.append(e);
+		}
+	}
+	if (taken.empty()) {
+		return taken;
+	}
+
+	entities.swap(kept);
+	for (auto const& p: taken) {
+		positions.erase(p.second);
+	}
+	positionsDirty = true;
+	childrenChanged();
+	if (spatialIndex) {
+		// removing many entities one by one costs more than a rebuild
+		if (4 * taken.size() > (size_t) kept.size()) {
+			spatialIndex.reset();
+		} else {
+			for (auto const& p: taken) {
+				spatialIndex->remove(p.second);
+			}
+		}
+	}
+	return taken;
+}
+
+std::vector<std::pair<int, RS_Entity*>> RS_EntityContainer::detachEntities(const std::vector<RS_Entity*>& toDetach)
+{
+	// undone entities are invisible, the borders don't change
+	return takeEntities(toDetach);
+}
+
+void RS_EntityContainer::attachEntities(const std::vector<std::pair<int, RS_Entity*>>& detached)
+{
+	if (detached.empty()) return;
+
+	// an entity at index i is preceded by i entities once all are back
+	int const oldCount = entities.size();
+	QList<RS_Entity*> merged;
+	merged.reserve(oldCount + (int) detached.size());
+	auto it = detached.begin();
+	for (RS_Entity* e: entities) {
+		for (; it != detached.end() && it->first <= merged.size(); ++it) {
+			merged.append(it->second);
+		}
+		merged.append(e);
+	}
+	for (; it != detached.end(); ++it) {
+		merged.append(it->second);
+	}
+	entities.swap(merged);
+
+	if (detached.front().first >= oldCount) {
+		// all appended, the spatial index and positions can be kept
+		for (auto const& p: detached) {
+			entityAdded(p.second, false);
+		}
+	} else {
+		invalidateSpatialIndex();
+		positionsDirty = true;
+	}
+}
+
+LC_SpatialIndex* RS_EntityContainer::getSpatialIndex() const
+{
+	// temporary containers, which don't own their entities, are usually
+	// queried once; building an index wouldn't pay off
+	if (!autoDelete || entities.size() < LC_SpatialIndex::minimumEntities()) {
+		spatialIndex.reset();
+		return nullptr;
+	}
+	if (!spatialIndex || spatialIndex->needsRebuild()) {
+		spatialIndex.reset(new LC_SpatialIndex);
+		spatialIndex->build(entities);
+	}
+	return spatialIndex.get();
+}
+
+void RS_EntityContainer::visitNearest(const RS_Vector& coord,
+									  const std::function<double(RS_Entity*, int)>& visitor) const
+{
+	if (LC_SpatialIndex* index = getSpatialIndex()) {
+		index->visitNearest(coord, visitor);
+		return;
+	}
+
+	int order = 0;
+	for (RS_Entity* e: entities) {
+		visitor(e, order++);
+	}
+}
+
+void RS_EntityContainer::setLazyUpdates(bool enable)
+{
+	lazyUpdates = enable;
+}
+
+bool RS_EntityContainer::isLazyUpdates()
+{
+	return lazyUpdates;
+}
+
+bool RS_EntityContainer::isUpdatePending() const
+{
+	// the update running on this thread creates the entities
+	return updatePending.load(std::memory_order_acquire) && !isUpdatingHere();
+}
+
+bool RS_EntityContainer::postponeUpdate()
+{
+	// the pending flag is cleared by ensureUpdated() once the update is done
+	if (isUpdatingHere()) {
+		return false;
+	}
+	// only the entities of a drawing are culled by the view
+	bool const postpone = lazyUpdates
+			&& parent && parent->rtti() == RS2::EntityGraphic;
+	updatePending.store(postpone, std::memory_order_release);
+	return postpone;
+}
+
+bool RS_EntityContainer::isUpdatingHere() const
+{
+	return updatingThread.load(std::memory_order_relaxed) == std::this_thread::get_id();
+}
+
+void RS_EntityContainer::ensureUpdated() const
+{
+	if (!updatePending.load(std::memory_order_acquire)) {
+		return;
+	}
+	// threads rendering tiles may run pending updates. The first thread
+	// claims the update, other threads wait until it is done and see the
+	// entities it created. The claiming thread returns at once, when the
+	// update queries this container.
+	RS_EntityContainer* self = const_cast<RS_EntityContainer*>(this);
+	std::thread::id idle;
+	std::thread::id const current = std::this_thread::get_id();
+	if (!self->updatingThread.compare_exchange_strong(idle, current,
+													 std::memory_order_acquire)) {
+		if (idle != current) {
+			while (updatePending.load(std::memory_order_acquire)) {
+				std::this_thread::yield();
+			}
+		}
+		return;
+	}
+	if (!updatePending.load(std::memory_order_acquire)) {
+		self->updatingThread.store(std::thread::id(), std::memory_order_release);
+		return;
+	}
+
+	// the inserts within blocks are kept up to date by updateInserts()
+	bool const blockInsertsUpdated = RS_Insert::setBlockInsertsUpdated(true);
+	self->update();
+	RS_Insert::setBlockInsertsUpdated(blockInsertsUpdated);
+
+	// the parent is shared with the threads updating its other children
+	if (parent) {
+		static std::mutex mutex;
+		std::lock_guard<std::mutex> lock(mutex);
+		parent->childrenChanged();
+		if (parent->spatialIndex) {
+			parent->spatialIndex->update(self);
+		}
+	}
+	self->updatePending.store(false, std::memory_order_release);
+	self->updatingThread.store(std::thread::id(), std::memory_order_release);
+}
@@ -28,9 +28,17 @@
 #ifndef RS_ENTITYCONTAINER_H
 #define RS_ENTITYCONTAINER_H
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include "rs_entity.h"
 
+class LC_SpatialIndex;
+
 /**
  * Class representing a tree of entities.
  * Typical entity containers are graphics, polylines, groups, texts, ...)
@@ -43,7 +51,8 @@ class RS_EntityContainer : public RS_Entity {
 public:
 
 	RS_EntityContainer(RS_EntityContainer* parent=nullptr, bool owner=true);
-    //RS_EntityContainer(const RS_EntityContainer& ec);
+	RS_EntityContainer(const RS_EntityContainer& ec);
+	RS_EntityContainer& operator = (const RS_EntityContainer& ec);
 	~RS_EntityContainer() override;
 
 	RS_Entity* clone() const override;
@@ -88,6 +97,13 @@ public:
 	virtual void moveEntity(int index, QList<RS_Entity *>& entList);
     virtual void insertEntity(int index, RS_Entity* entity);
     virtual bool removeEntity(RS_Entity* entity);
+	/**
+	 * @brief removeEntities removes the given children in one pass and
+	 * recalculates the borders once, deleting them if this container is
+	 * the owner. Entities which aren't children are ignored.
+	 * @return number of entities removed
+	 */
+	int removeEntities(const std::vector<RS_Entity*>& toRemove);
 
 	//!
 	//! \brief addRectangle add four lines to form a rectangle by
@@ -130,9 +146,11 @@ public:
         autoUpdateBorders = enable;
     }
     virtual void adjustBorders(RS_Entity* entity);
+	//! recalculates the borders without recalculating the children
+	void adjustBordersToChildren();
 	void calculateBorders() override;
-	void forcedCalculateBorders();
-	void updateDimensions( bool autoText=true);
+	virtual void forcedCalculateBorders();
+	virtual void updateDimensions( bool autoText=true);
     virtual void updateInserts();
     virtual void updateSplines();
 	void update() override;
@@ -229,7 +247,66 @@ public:
 
     const QList<RS_Entity*>& getEntityList();
 
+	/**
+	 * @brief getEntitiesInWindow child entities which may lie within the window
+	 * Uses the spatial index, if this container keeps one.
+	 * @param level children overlapping the window are resolved like
+	 * firstEntity()/nextEntity() do for this level
+	 * @return entities whose extent overlaps v1/v2, in container order
+	 */
+	std::vector<RS_Entity*> getEntitiesInWindow(const RS_Vector& v1,
+												const RS_Vector& v2,
+												RS2::ResolveLevel level=RS2::ResolveNone) const;
+	/**
+	 * @brief updateSpatialIndex re-reads the extent of a child entity
+	 * Called by children whenever their borders change.
+	 */
+	void updateSpatialIndex(RS_Entity* entity);
+	/**
+	 * @brief invalidateSpatialIndex drops the spatial index, it is rebuilt
+	 * on the next query. Needed after children were modified in place.
+	 */
+	void invalidateSpatialIndex();
+	/**
+	 * @brief detachEntities takes children out of the container without
+	 * deleting them, the undo system keeps undone entities this way.
+	 * The borders are not updated, detached entities are expected to be
+	 * invisible.
+	 * @return the detached entities with their former index, in container
+	 * order. Entities which aren't children are ignored.
+	 */
+	std::vector<std::pair<int, RS_Entity*>> detachEntities(const std::vector<RS_Entity*>& toDetach);
+	/**
+	 * @brief attachEntities puts detached entities back at their former
+	 * index, in one pass
+	 * @param detached result of detachEntities()
+	 */
+	void attachEntities(const std::vector<std::pair<int, RS_Entity*>>& detached);
+
+	/**
+	 * Lazy updates: inserts, dimensions and hatches directly in a drawing
+	 * only keep their defining data and borders on update(). Their
+	 * entities are created once they are drawn, queried, exploded or
+	 * exported, see ensureUpdated().
+	 */
+	static void setLazyUpdates(bool enable);
+	static bool isLazyUpdates();
+	//! true, if the entities of this container are yet to be created
+	bool isUpdatePending() const;
+	//! runs the pending update of this container, if any
+	void ensureUpdated() const;
+
 protected:
+	/**
+	 * Called by update() of containers which support lazy updates.
+	 * @return true, if the update is pending and update() only has to
+	 * calculate the borders
+	 */
+	bool postponeUpdate();
+	//! false for empty containers, which don't extend the borders
+	static bool hasBorders(RS_Entity* entity);
+	//! true, while ensureUpdated() runs the pending update on this thread
+	bool isUpdatingHere() const;
 
     /** entities in the container */
     QList<RS_Entity *> entities;
@@ -249,8 +326,60 @@ private:
 	 * @return true when entity of this container won't be considered for snapping points
 	 */
 	bool ignoredSnap() const;
+	/**
+	 * @brief getSpatialIndex builds the index on demand
+	 * @return the index or nullptr, if this container is too small or
+	 * doesn't own its entities
+	 */
+	LC_SpatialIndex* getSpatialIndex() const;
+	/**
+	 * @brief visitNearest calls visitor for the children, with the spatial
+	 * index nearest first, stopping when no closer child remains
+	 */
+	void visitNearest(const RS_Vector& coord,
+					  const std::function<double(RS_Entity*, int)>& visitor) const;
+	//! counts a change of the children, which outdates cached intersections
+	void childrenChanged();
+	/**
+	 * @return whether the cached intersections belong to closestEntity
+	 * and neither this container nor a container of the candidates changed
+	 */
+	bool isIntersectionCacheValid(RS_Entity* closestEntity) const;
+	//! keeps the spatial index and caches up to date after adding an entity
+	void entityAdded(RS_Entity* entity, bool prepend);
+	//! index of a child or -1, looked up in positions for large containers
+	int indexOf(const RS_Entity* entity) const;
+	/**
+	 * @brief takeEntities removes the given children in one pass and
+	 * keeps the caches up to date
+	 * @return the removed entities with their former index, in order
+	 */
+	std::vector<std::pair<int, RS_Entity*>> takeEntities(const std::vector<RS_Entity*>& toTake);
+
     int entIdx;
     bool autoDelete;
+	//! spatial index over entities, built on demand
+	mutable std::unique_ptr<LC_SpatialIndex> spatialIndex;
+	/**
+	 * intersections of the last entity found by getNearestIntersection(),
+	 * reused while the cursor stays over that entity and no container
+	 * of the candidates changed, see isIntersectionCacheValid()
+	 */
+	struct IntersectionCache;
+	std::unique_ptr<IntersectionCache> intersectionCache;
+	//! changes of the children, children may be updated on several threads
+	std::atomic<unsigned long long> changes{0};
+	/**
+	 * index of every child, built on demand. Entries are checked against
+	 * entities before use, any change of the order except appending makes
+	 * the whole map dirty.
+	 */
+	mutable std::unordered_map<const RS_Entity*, int> positions;
+	mutable bool positionsDirty = true;
+	static bool lazyUpdates;
+	std::atomic<bool> updatePending{false};
+	//! the thread running the pending update in ensureUpdated()
+	std::atomic<std::thread::id> updatingThread{std::thread::id()};
 };
 
 #endif
@@ -27,6 +27,7 @@
 #include <iostream>
 #include <QHash>
 #include "rs_fontlist.h"
+#include "lc_glyphcache.h"
 #include "rs_debug.h"
 #include "rs_font.h"
 #include "rs_system.h"
@@ -47,6 +48,8 @@ RS_FontList* RS_FontList::instance() {
  */
 void RS_FontList::init() {
     RS_DEBUG->print("RS_FontList::initFonts");
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    requested.clear();
 
     QStringList list = RS_SYSTEM->getNewFontList();
     list.append(RS_SYSTEM->getFontList());
@@ -58,6 +61,8 @@ void RS_FontList::init() {
         QFileInfo fi( list.at(i) );
         if ( !added.contains(fi.baseName()) ) {
 			fonts.emplace_back(new RS_Font(fi.baseName()));
+			if (!fontIndex.contains(fonts.back()->getFileName()))
+				fontIndex.insert(fonts.back()->getFileName(), fonts.back().get());
             added.insert(fi.baseName(), 1);
         }
 
@@ -83,6 +88,11 @@ std::vector<std::unique_ptr<RS_Font> >::const_iterator RS_FontList::end() const
  * Removes all fonts in the fontlist.
  */
 void RS_FontList::clearFonts() {
+	std::lock_guard<std::recursive_mutex> lock(mutex);
+	// glyphs are keyed by the fonts
+	LC_GLYPHCACHE->clear();
+	requested.clear();
+	fontIndex.clear();
 	fonts.clear();
 }
 
@@ -92,10 +102,22 @@ void RS_FontList::clearFonts() {
  * memory if it's not already.
  */
 RS_Font* RS_FontList::requestFont(const QString& name) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    ++lookupStats.lookups;
+
+    // texts request the same few fonts over and over
+    auto it = requested.constFind(name);
+    if (it != requested.constEnd()) {
+        ++lookupStats.comparisons;
+        if (it.value()) {
+            ++lookupStats.hits;
+        }
+        return it.value();
+    }
+
     RS_DEBUG->print("RS_FontList::requestFont %s",  name.toLatin1().data());
 
     QString name2 = name.toLower();
-    RS_Font* foundFont = NULL;
 
     // QCAD 1 compatibility:
     if (name2.contains('#') && name2.contains('_')) {
@@ -107,23 +129,32 @@ RS_Font* RS_FontList::requestFont(const QString& name) {
     RS_DEBUG->print("name2: %s", name2.toLatin1().data());
 
 	// Search our list of available fonts:
-	for( auto const& f: fonts){
-
-        if (f->getFileName()==name2) {
-            // Make sure this font is loaded into memory:
-            f->loadFont();
-			foundFont = f.get();
-            break;
-        }
+    RS_Font* foundFont = fontIndex.value(name2, NULL);
+    if (foundFont) {
+        ++lookupStats.comparisons;
+        ++lookupStats.hits;
+        // Make sure this font is loaded into memory:
+        foundFont->loadFont();
     }
 
 	if (!foundFont && name!="standard") {
         foundFont = requestFont("standard");
     }
 
+    requested.insert(name, foundFont);
     return foundFont;
 }
 
+LC_LookupStats RS_FontList::getLookupStats() {
+	std::lock_guard<std::recursive_mutex> lock(mutex);
+	return lookupStats;
+}
+
+void RS_FontList::resetLookupStats() {
+	std::lock_guard<std::recursive_mutex> lock(mutex);
+	lookupStats.reset();
+}
+
 /**
  * Dumps the fonts to stdout.
  */
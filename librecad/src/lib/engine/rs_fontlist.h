@@ -26,7 +26,11 @@
 #ifndef RS_FONTLIST_H
 #define RS_FONTLIST_H
 #include <memory>
+#include <mutex>
 #include <vector>
+#include <QHash>
+#include <QString>
+#include "lc_lookupstats.h"
 
 class RS_Font;
 
@@ -53,6 +57,9 @@ public:
     void clearFonts();
 	size_t countFonts() const;
     RS_Font* requestFont(const QString& name);
+	//! @return statistics of the font requests
+	LC_LookupStats getLookupStats();
+	void resetLookupStats();
 	std::vector<std::unique_ptr<RS_Font> >::const_iterator begin() const;
 	std::vector<std::unique_ptr<RS_Font> >::const_iterator end() const;
 
@@ -65,6 +72,13 @@ private:
 	static RS_FontList* uniqueInstance;
     //! fonts in the graphic
 	std::vector<std::unique_ptr<RS_Font>> fonts;
+	//! fonts by file name
+	QHash<QString, RS_Font*> fontIndex;
+	//! fonts returned for the names requested so far, including fallbacks
+	QHash<QString, RS_Font*> requested;
+	LC_LookupStats lookupStats;
+	//! fonts are requested by file imports in the background too
+	std::recursive_mutex mutex;
 };
 
 #endif
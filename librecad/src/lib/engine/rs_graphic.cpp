@@ -40,6 +40,25 @@
 #include "rs_layer.h"
 #include "rs_block.h"
 
+namespace {
+/**
+ * Puts entities and their sub-entities, which refer to layer, on layer
+ * "0". Entities kept by undo lists would refer to the layer after it
+ * is removed.
+ */
+void releaseLayer(const RS_Layer* layer, const std::vector<RS_Entity*>& entities)
+{
+	for (RS_Entity* e: entities) {
+		if (e->getLayer(false) == layer) {
+			e->setLayer("0");
+		}
+		if (e->isContainer()) {
+			auto ec = static_cast<RS_EntityContainer*>(e);
+			releaseLayer(layer, std::vector<RS_Entity*>(ec->begin(), ec->end()));
+		}
+	}
+}
+}
 
 /**
  * Default constructor.
@@ -149,6 +168,8 @@ void RS_Graphic::removeLayer(RS_Layer* layer) {
 			}
 			endUndoCycle();
 		}
+		// undone entities kept by the undo lists
+		releaseLayer(layer, getAllDetachedEntities());
 
 		toRemove.clear();
         // remove all entities in blocks that are on that layer:
@@ -173,6 +194,19 @@ void RS_Graphic::removeLayer(RS_Layer* layer) {
 }
 
 
+std::vector<RS_Entity*> RS_Graphic::getAllDetachedEntities() const
+{
+	std::vector<RS_Entity*> ret = getDetachedEntities();
+	for (RS_Block* blk: blockList) {
+		if (blk) {
+			auto entities = blk->getDetachedEntities();
+			ret.insert(ret.end(), entities.begin(), entities.end());
+		}
+	}
+	return ret;
+}
+
+
 /**
  * Clears all layers, blocks and entities of this graphic.
  * A default layer (0) is created.
@@ -530,11 +564,7 @@ bool RS_Graphic::open(const QString &filename, RS2::FormatType type) {
     ret = RS_FileIO::instance()->fileImport(*this, filename, type);
 
     if( ret) {
-        setModified(false);
-        layerList.setModified(false);
-        blockList.setModified(false);
-        modifiedTime = finfo.lastModified();
-        currentFileName=QString(filename);
+        setOpenedFile(filename);
 
         //cout << *((RS_Graphic*)graphic);
         //calculateBorders();
@@ -545,6 +575,57 @@ bool RS_Graphic::open(const QString &filename, RS2::FormatType type) {
     return ret;
 }
 
+void RS_Graphic::takeImport(RS_Graphic& imported, const QString& filename) {
+    RS_DEBUG->print("RS_Graphic::takeImport(%s)", filename.toLatin1().data());
+
+    clear();
+
+    // keep the order, images and hatches are in front already
+    QList<RS_Entity*> const taken = imported.entities;
+    imported.setOwner(false);
+    imported.clear();
+    imported.setOwner(true);
+    for (RS_Entity* e: taken) {
+        e->setParent(this);
+        appendEntity(e);
+    }
+
+    layerList.take(imported.layerList);
+    blockList.take(imported.blockList);
+    for (RS_Block* b: blockList) {
+        b->setParent(this);
+    }
+
+    variableDict = imported.variableDict;
+    crosshairType = imported.crosshairType;
+    paperScaleFixed = imported.paperScaleFixed;
+    marginLeft = imported.marginLeft;
+    marginTop = imported.marginTop;
+    marginRight = imported.marginRight;
+    marginBottom = imported.marginBottom;
+    pagesNumH = imported.pagesNumH;
+    pagesNumV = imported.pagesNumV;
+
+    calculateBorders();
+    setOpenedFile(filename);
+}
+
+/**
+ * Sets the file name and marks this graphic as unmodified after the file
+ * was opened.
+ */
+void RS_Graphic::setOpenedFile(const QString &filename) {
+    QFileInfo finfo(filename);
+    this->filename = filename;
+    this->autosaveFilename = finfo.path() + "/#" + finfo.fileName();
+
+    setModified(false);
+    layerList.setModified(false);
+    blockList.setModified(false);
+    modifiedTime = finfo.lastModified();
+    currentFileName=QString(filename);
+}
+
 
 
 /**
@@ -985,7 +1066,7 @@ int RS_Graphic::clean()
 {
     // author: ravas
 
-    int how_many = 0;
+    std::vector<RS_Entity*> toRemove;
 
     foreach (RS_Entity* e, entities)
     {
@@ -1000,11 +1081,10 @@ int RS_Graphic::clean()
             || e->getMin().y < RS_MINDOUBLE
             || e->getMax().y < RS_MINDOUBLE)
         {
-            removeEntity(e);
-            how_many += 1;
+            toRemove.push_back(e);
         }
     }
-    return how_many;
+    return removeEntities(toRemove);
 }
 
 /**
@@ -71,6 +71,12 @@ public:
     virtual bool save(bool isAutoSave = false);
     virtual bool saveAs(const QString& filename, RS2::FormatType type, bool force = false);
     virtual bool open(const QString& filename, RS2::FormatType type);
+    /**
+     * Replaces the content of this graphic by the file imported into
+     * imported, which is left empty. Views and listeners of this graphic
+     * are kept. Finishes an import in the background, see LC_FileImport.
+     */
+    void takeImport(RS_Graphic& imported, const QString& filename);
     bool loadTemplate(const QString &filename, RS2::FormatType type);
 
         // Wrappers for Layer functions:
@@ -182,6 +188,8 @@ public:
     void removeBlockListListener(RS_BlockListListener* listener) {
         blockList.removeListener(listener);
     }
+    //! entities the undo lists of this graphic and of its blocks took out
+    std::vector<RS_Entity*> getAllDetachedEntities() const;
 
         // Wrappers for variable functions:
     void clearVariables() {
@@ -358,6 +366,7 @@ public:
 private:
 
         bool BackupDrawingFile(const QString &filename);
+        void setOpenedFile(const QString &filename);
         QDateTime modifiedTime;
         QString currentFileName; //keep a copy of filename for the modifiedTime
 
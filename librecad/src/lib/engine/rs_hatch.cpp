@@ -29,7 +29,9 @@
 #include <QPainterPath>
 #include <QBrush>
 #include <QString>
+#include <QTransform>
 #include "rs_hatch.h"
+#include "lc_hatchscanline.h"
 
 #include "rs_arc.h"
 #include "rs_circle.h"
@@ -135,6 +137,8 @@ bool RS_Hatch::isContainer() const {
 void RS_Hatch::calculateBorders() {
     RS_DEBUG->print("RS_Hatch::calculateBorders");
 
+    fillPathValid = false;
+
     activateContour(true);
 
     RS_EntityContainer::calculateBorders();
@@ -157,6 +161,9 @@ void RS_Hatch::update() {
 
     RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update");
 
+    // the loops may have changed
+    fillPathValid = false;
+
     updateError = HATCH_OK;
     if (updateRunning) {
         RS_DEBUG->print(RS_Debug::D_NOTICE, "RS_Hatch::update: skip hatch in updating process");
@@ -208,6 +215,11 @@ void RS_Hatch::update() {
         RS_DEBUG->print(RS_Debug::D_ERROR, "RS_Hatch::update: requesting pattern: not found");
         updateError = HATCH_PATTERN_NOT_FOUND;
         return;
+    } else if (postponeUpdate()) {
+        // the pattern is trimmed to the loops once it is needed
+        updateRunning = false;
+        calculateBorders();
+        return;
     } else {
         RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update: requesting pattern: OK");
         // make a working copy of hatch pattern
@@ -231,9 +243,20 @@ void RS_Hatch::update() {
     // find out how many pattern-instances we need in x/y:
     int px1, py1, px2, py2;
     double f;
-    RS_Hatch* copy = (RS_Hatch*)this->clone();
-    copy->rotate(RS_Vector(0.0,0.0), -data.angle);
-    copy->forcedCalculateBorders();
+    // borders of the contour in the direction of the pattern
+    RS_Vector copyMin(RS_MAXDOUBLE, RS_MAXDOUBLE);
+    RS_Vector copyMax(RS_MINDOUBLE, RS_MINDOUBLE);
+    for (auto l: entities) {
+        if (l->isContainer()) {
+            for (auto e: *static_cast<RS_EntityContainer*>(l)) {
+                std::unique_ptr<RS_Entity> copy{e->clone()};
+                copy->rotate(RS_Vector(0.0,0.0), -data.angle);
+                copy->calculateBorders();
+                copyMin = RS_Vector::minimum(copyMin, copy->getMin());
+                copyMax = RS_Vector::maximum(copyMax, copy->getMax());
+            }
+        }
+    }
 
     // create a pattern over the whole contour.
     RS_Vector pSize = pat->getSize();
@@ -250,7 +273,6 @@ void RS_Hatch::update() {
             cSize.x>RS_MAXDOUBLE-1 || cSize.y>RS_MAXDOUBLE-1 ||
             pSize.x>RS_MAXDOUBLE-1 || pSize.y>RS_MAXDOUBLE-1) {
         delete pat;
-        delete copy;
         updateRunning = false;
         RS_DEBUG->print(RS_Debug::D_ERROR, "RS_Hatch::update: contour size or pattern size too small");
         updateError = HATCH_TOO_SMALL;
@@ -260,32 +282,41 @@ void RS_Hatch::update() {
     else if ( cSize.x* cSize.y/(pSize.x*pSize.y)>1e4) {
         RS_DEBUG->print(RS_Debug::D_ERROR, "RS_Hatch::update: contour size too large or pattern size too small");
         delete pat;
-        delete copy;
+        updateRunning = false;
         updateError = HATCH_AREA_TOO_BIG;
         return;
     }
 
     // calculate pattern pieces quantity
-    f = copy->getMin().x/pSize.x;
+    f = copyMin.x/pSize.x;
     px1 = (int)floor(f);
-    f = copy->getMin().y/pSize.y;
+    f = copyMin.y/pSize.y;
     py1 = (int)floor(f);
-    f = copy->getMax().x/pSize.x;
+    f = copyMax.x/pSize.x;
     px2 = (int)ceil(f);
-    f = copy->getMax().y/pSize.y;
+    f = copyMax.y/pSize.y;
     py2 = (int)ceil(f);
     RS_Vector dvx=RS_Vector(data.angle)*pSize.x;
     RS_Vector dvy=RS_Vector(data.angle+M_PI*0.5)*pSize.y;
     pat->rotate(rot_center, data.angle);
     pat->move(-rot_center);
 
-    RS_EntityContainer tmp;   // container for untrimmed lines
+    RS_EntityContainer tmp;   // container for untrimmed arcs, circles, ellipses
+    // pattern lines, trimmed by scanlines
+    std::vector<std::pair<RS_Vector, RS_Vector>> lines;
+    LC_HatchScanline scanline(this);
 
     // adding array of patterns to tmp:
     RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update: creating pattern carpet");
-    for (int px=px1; px<px2; px++) {
-		for (int py=py1; py<py2; py++) {
-			for(auto e: *pat){
+    for(auto e: *pat){
+        if (e->rtti()==RS2::EntityLine) {
+            auto pieces = scanline.clip(e->getStartpoint(), e->getEndpoint(),
+                                        dvx, dvy, px1, px2, py1, py2);
+            lines.insert(lines.end(), pieces.begin(), pieces.end());
+            continue;
+        }
+        for (int px=px1; px<px2; px++) {
+            for (int py=py1; py<py2; py++) {
                 RS_Entity* te=e->clone();
                 te->move(dvx*px + dvy*py);
                 tmp.addEntity(te);
@@ -296,8 +327,6 @@ void RS_Hatch::update() {
     // clean memory
     delete pat;
     pat = nullptr;
-    delete copy;
-    copy = nullptr;
     RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update: creating pattern carpet: OK");
 
     // cut pattern to contour shape
@@ -479,6 +508,13 @@ void RS_Hatch::update() {
     hatch->setLayer(hatch_layer);
     hatch->setFlag(RS2::FlagTemp);
 
+    for (const auto& l: lines) {
+        RS_Line* te = new RS_Line{hatch, l.first, l.second};
+        te->setPen(hatch_pen);
+        te->setLayer(hatch_layer);
+        hatch->addEntity(te);
+    }
+
     //calculateBorders();
 	for(auto e: tmp2){
 
@@ -560,6 +596,7 @@ void RS_Hatch::activateContour(bool on) {
 void RS_Hatch::draw(RS_Painter* painter, RS_GraphicView* view, double& /*patternOffset*/) {
 
     if (!data.solid) {
+        ensureUpdated();
         foreach (auto se, entities){
 
             view->drawEntity(painter,se);
@@ -567,15 +604,60 @@ void RS_Hatch::draw(RS_Painter* painter, RS_GraphicView* view, double& /*pattern
         return;
     }
 
-    //area of solid fill. Use polygon approximation, except trivial cases
-    QPainterPath path;
-    QList<QPolygon> paClosed;
-    QPolygon pa;
-//    QPolygon jp;   // jump points
+    // the boundary follows the layer of the hatch
+    for (auto l: entities) {
+        if (l->getLayer() != getLayer()) {
+            fillPathValid = false;
+            break;
+        }
+    }
+    if (!fillPathValid) {
+        updateFillPath();
+    }
+
+    // map the drawing coordinates to the view
+    RS_Vector const g0 = view->toGui(RS_Vector(0.0, 0.0));
+    RS_Vector const gx = view->toGui(RS_Vector(1.0, 0.0)) - g0;
+    RS_Vector const gy = view->toGui(RS_Vector(0.0, 1.0)) - g0;
+    QPainterPath path = QTransform(gx.x, gx.y, gy.x, gy.y, g0.x, g0.y).map(fillPath);
+
+    // clip fills reaching far beyond the view, which keeps the
+    // coordinates the painter fills in range
+    if (!painter->getInstance()) {
+        double const w = view->getWidth();
+        double const h = view->getHeight();
+        QRectF const viewRect(-w, -h, 3.0 * w, 3.0 * h);
+        if (!viewRect.contains(path.boundingRect())) {
+            QPainterPath clip;
+            clip.addRect(viewRect);
+            path = path.intersected(clip);
+        }
+    }
+
+    //bug#474, restore brush after solid fill
+    const QBrush brush(painter->brush());
+    const RS_Pen pen=painter->getPen();
+    painter->setBrush(pen.getColor());
+    painter->disablePen();
+    painter->drawPath(path);
+    painter->setBrush(brush);
+    painter->setPen(pen);
+
+
+}
+
+/**
+ * Builds the outline of a solid fill from the loops. Lines are kept,
+ * arcs, circles and ellipses become curves of the path, so the outline
+ * stays smooth at any zoom.
+ */
+void RS_Hatch::updateFillPath() {
+    // distance of edges considered connected
+    const double joinTolerance = 1.0e-6;
 
     // loops:
     if (needOptimization==true) {
-        foreach (auto l, entities){
+        for(auto l: entities){
 
             if (l->rtti()==RS2::EntityContainer) {
                 RS_EntityContainer* loop = (RS_EntityContainer*)l;
@@ -586,137 +668,102 @@ void RS_Hatch::draw(RS_Painter* painter, RS_GraphicView* view, double& /*pattern
         needOptimization = false;
     }
 
+    fillPath = QPainterPath();
+
     // loops:
-    foreach (auto l, entities){
+    for(auto l: entities){
         l->setLayer(getLayer());
 
-        if (l->rtti()==RS2::EntityContainer) {
-            RS_EntityContainer* loop = (RS_EntityContainer*)l;
-
-            // edges:
-			for(auto e: *loop){
-
-                e->setLayer(getLayer());
-                switch (e->rtti()) {
-                case RS2::EntityLine: {
-                    QPoint pt1(RS_Math::round(view->toGuiX(e->getStartpoint().x)),
-                               RS_Math::round(view->toGuiY(e->getStartpoint().y)));
-                    QPoint pt2(RS_Math::round(view->toGuiX(e->getEndpoint().x)),
-                               RS_Math::round(view->toGuiY(e->getEndpoint().y)));
-
-//                    if (! (pa.size()>0 && (pa.last() - pt1).manhattanLength()<=2)) {
-//                        jp<<pt1;
-//                    }
-                    if(pa.size() && (pa.last()-pt1).manhattanLength()>=1)
-                        pa<<pt1;
-                    pa<<pt2;
-                }
-                    break;
+        if (l->rtti()!=RS2::EntityContainer) {
+            continue;
+        }
+        RS_EntityContainer* loop = (RS_EntityContainer*)l;
+
+        // starts a new sub path, unless e continues the current one
+        bool open = false;
+        auto connect = [&](const RS_Vector& start) {
+            QPointF const current = fillPath.currentPosition();
+            if (open && fabs(current.x()-start.x) < joinTolerance
+                    && fabs(current.y()-start.y) < joinTolerance) {
+                return;
+            }
+            if (open) {
+                fillPath.closeSubpath();
+            }
+            fillPath.moveTo(start.x, start.y);
+            open = true;
+        };
 
-                case RS2::EntityArc: {
-//                    QPoint pt1(RS_Math::round(view->toGuiX(e->getStartpoint().x)),
-//                               RS_Math::round(view->toGuiY(e->getStartpoint().y)));
-//                    if (! (pa.size()>0 && (pa.last() - pt1).manhattanLength()<=2)) {
-//                        jp<<pt1;
-//                    }
+        // edges:
+        for(auto e: *loop){
 
-                    QPolygon pa2;
-                    RS_Arc* arc=static_cast<RS_Arc*>(e);
+            e->setLayer(getLayer());
+            switch (e->rtti()) {
+            case RS2::EntityLine:
+                connect(e->getStartpoint());
+                fillPath.lineTo(e->getEndpoint().x, e->getEndpoint().y);
+                break;
 
-                    painter->createArc(pa2, view->toGui(arc->getCenter()),
-                                       view->toGuiDX(arc->getRadius())
-                                       ,arc->getAngle1(),arc->getAngle2(),arc->isReversed());
-                    if(pa.size() &&pa2.size()&&(pa.last()-pa2.first()).manhattanLength()<1)
-                        pa2.remove(0,1);
-                    pa<<pa2;
+            case RS2::EntityArc: {
+                RS_Arc* arc=static_cast<RS_Arc*>(e);
+                RS_Vector const c = arc->getCenter();
+                double const r = arc->getRadius();
+                double const sweep = arc->isReversed() ? -arc->getAngleLength() : arc->getAngleLength();
+                connect(arc->getStartpoint());
+                // Qt angles run clockwise in drawing coordinates
+                fillPath.arcTo(QRectF(c.x-r, c.y-r, 2.*r, 2.*r),
+                               -RS_Math::rad2deg(arc->getAngle1()), -RS_Math::rad2deg(sweep));
+                break;
+            }
 
+            case RS2::EntityCircle: {
+                if (open) {
+                    fillPath.closeSubpath();
+                    open = false;
                 }
-                    break;
-
-                case RS2::EntityCircle: {
-                    RS_Circle* circle = static_cast<RS_Circle*>(e);
-//                    QPoint pt1(RS_Math::round(view->toGuiX(circle->getCenter().x+circle->getRadius())),
-//                               RS_Math::round(view->toGuiY(circle->getCenter().y)));
-//                    if (! (pa.size()>0 && (pa.last() - pt1).manhattanLength()<=2)) {
-//                        jp<<pt1;
-//                    }
-
-                    RS_Vector c=view->toGui(circle->getCenter());
-                    double r=view->toGuiDX(circle->getRadius());
-                    path.addEllipse(QPoint(c.x,c.y),r,r);
-//                    QPolygon pa2;
-//                    painter->createArc(pa2, view->toGui(circle->getCenter()),
-//                                       view->toGuiDX(circle->getRadius()),
-//                                       0.0,
-//                                       2*M_PI,
-//                                       false);
-//                    pa<<pa2;
-                }
-                    break;
-                case RS2::EntityEllipse:
-                if(static_cast<RS_Ellipse*>(e)->isArc()) {
-                    QPolygon pa2;
-                    auto ellipse=static_cast<RS_Ellipse*>(e);
-
-                    painter->createEllipse(pa2,
-                                           view->toGui(ellipse->getCenter()),
-                                           view->toGuiDX(ellipse->getMajorRadius()),
-                                           view->toGuiDX(ellipse->getMinorRadius()),
-                                           ellipse->getAngle()
-                                           ,ellipse->getAngle1(),ellipse->getAngle2(),ellipse->isReversed()
-                                           );
-//                    qDebug()<<"ellipse: "<<ellipse->getCenter().x<<","<<ellipse->getCenter().y;
-//                    qDebug()<<"ellipse: pa2.size()="<<pa2.size();
-//                    qDebug()<<"ellipse: pa2="<<pa2;
-                    if(pa.size() && pa2.size()&&(pa.last()-pa2.first()).manhattanLength()<1)
-                        pa2.remove(0,1);
-                    pa<<pa2;
-                }else{
-                    QPolygon pa2;
-                    auto ellipse=static_cast<RS_Ellipse*>(e);
-                    painter->createEllipse(pa2,
-                                           view->toGui(ellipse->getCenter()),
-                                           view->toGuiDX(ellipse->getMajorRadius()),
-                                           view->toGuiDX(ellipse->getMinorRadius()),
-                                           ellipse->getAngle(),
-                                           ellipse->getAngle1(), ellipse->getAngle2(),
-                                           ellipse->isReversed()
-                                           );
-                    path.addPolygon(pa2);
-                }
-                    break;
-                default:
-                    break;
-                }
-//                qDebug()<<"pa="<<pa;
-                if( pa.size()>2 && pa.first() == pa.last()) {
-                    paClosed<<pa;
-                    pa.clear();
-                }
+                RS_Vector const c = e->getCenter();
+                fillPath.addEllipse(QPointF(c.x, c.y), e->getRadius(), e->getRadius());
+                break;
+            }
 
+            case RS2::EntityEllipse: {
+                auto ellipse=static_cast<RS_Ellipse*>(e);
+                double const a = ellipse->getMajorRadius();
+                double const b = ellipse->getMinorRadius();
+                RS_Vector const c = ellipse->getCenter();
+                double const angle = ellipse->getAngle();
+                // the ellipse in its own axes, rotated into place
+                QTransform const toDrawing(cos(angle), sin(angle), -sin(angle), cos(angle), c.x, c.y);
+                QPainterPath local;
+                if (ellipse->isArc()) {
+                    double const a1 = ellipse->getAngle1();
+                    double const sweep = ellipse->isReversed() ? -ellipse->getAngleLength() : ellipse->getAngleLength();
+                    local.moveTo(a*cos(a1), b*sin(a1));
+                    local.arcTo(QRectF(-a, -b, 2.*a, 2.*b),
+                                -RS_Math::rad2deg(a1), -RS_Math::rad2deg(sweep));
+                    connect(ellipse->getStartpoint());
+                    fillPath.connectPath(toDrawing.map(local));
+                } else {
+                    if (open) {
+                        fillPath.closeSubpath();
+                        open = false;
+                    }
+                    local.addEllipse(QPointF(0., 0.), a, b);
+                    fillPath.addPath(toDrawing.map(local));
+                }
+                break;
             }
 
+            default:
+                break;
+            }
+        }
+        if (open) {
+            fillPath.closeSubpath();
         }
     }
-    if(pa.size()>2){
-        pa<<pa.first();
-        paClosed<<pa;
-    }
-
-    for(auto& p:paClosed){
-        path.addPolygon(p);
-    }
-
-    //bug#474, restore brush after solid fill
-    const QBrush brush(painter->brush());
-    const RS_Pen pen=painter->getPen();
-    painter->setBrush(pen.getColor());
-    painter->disablePen();
-    painter->drawPath(path);
-    painter->setBrush(brush);
-    painter->setPen(pen);
-
 
+    fillPathValid = true;
 }
 
 //must be called after update()
@@ -28,6 +28,7 @@
 #ifndef RS_HATCH_H
 #define RS_HATCH_H
 
+#include <QPainterPath>
 #include "rs_entity.h"
 #include "rs_entitycontainer.h"
 
@@ -170,6 +171,17 @@ protected:
         bool updateRunning;
         bool needOptimization;
         int  updateError;
+
+private:
+        //! rebuilds fillPath from the loops
+        void updateFillPath();
+
+        /**
+         * Outline of a solid fill in drawing coordinates. Built once from
+         * the loops and mapped to the view when drawn.
+         */
+        QPainterPath fillPath;
+        bool fillPathValid = false;
 };
 
 #endif
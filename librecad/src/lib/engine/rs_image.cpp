@@ -185,6 +185,7 @@ void RS_Image::calculateBorders() {
                 RS_Vector::maximum(sol.get(0), sol.get(1)),
                 RS_Vector::maximum(sol.get(2), sol.get(3))
                     );
+        notifyBordersChanged();
 }
 
 RS_VectorSolutions RS_Image::getCorners() const {
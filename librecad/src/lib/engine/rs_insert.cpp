@@ -36,6 +36,14 @@
 #include "rs_layer.h"
 #include "rs_math.h"
 #include "rs_debug.h"
+#include "rs_graphicview.h"
+#include "rs_painter.h"
+#include "lc_tilerenderer.h"
+
+namespace {
+//! see RS_Insert::setBlockInsertsUpdated()
+thread_local bool blockInsertsUpdated = false;
+}
 
 RS_InsertData::RS_InsertData(const QString& _name,
 							 RS_Vector _insertionPoint,
@@ -102,6 +110,7 @@ void RS_Insert::update() {
         }
 
     clear();
+    instanced = false;
 
     RS_Block* blk = getBlockForInsert();
 	if (!blk) {
@@ -120,6 +129,28 @@ void RS_Insert::update() {
                 return;
         }
 
+    bool const instanceable = isInstanceable();
+    if (instanceable || postponeUpdate()) {
+        // the block is drawn and queried through the transformation or,
+        // with the update pending, copied once the copies are needed.
+        // Either way the borders follow from the block and only
+        // sub-inserts of the block need to be up to date
+        bool subInserts = false;
+        for (RS_Entity* e: *blk) {
+            if (e->rtti()==RS2::EntityInsert && !blockInsertsUpdated) {
+                static_cast<RS_Insert*>(e)->update();
+                subInserts = true;
+            }
+        }
+        if (subInserts) {
+            blk->calculateBorders();
+        }
+        instanced = instanceable;
+        calculateBorders();
+        RS_DEBUG->print("RS_Insert::update: %s OK", instanceable ? "instanced" : "pending");
+        return;
+    }
+
     RS_Pen tmpPen;
 
         /*QListIterator<RS_Entity> it = createIterator();
@@ -140,7 +171,8 @@ void RS_Insert::update() {
 //                RS_DEBUG->print("RS_Insert::update: row %d", r);
 
                 if (e->rtti()==RS2::EntityInsert &&
-                    data.updateMode!=RS2::PreviewUpdate) {
+                    data.updateMode!=RS2::PreviewUpdate &&
+                    !blockInsertsUpdated) {
 
 //                                        RS_DEBUG->print("RS_Insert::update: updating sub-insert");
 					static_cast<RS_Insert*>(e)->update();
@@ -248,6 +280,99 @@ void RS_Insert::update() {
 
 
 
+void RS_Insert::materialize() {
+    if (materialized) {
+        return;
+    }
+    materialized = true;
+    if (instanced) {
+        update();
+    }
+}
+
+
+bool RS_Insert::setBlockInsertsUpdated(bool updated) {
+    bool const previous = blockInsertsUpdated;
+    blockInsertsUpdated = updated;
+    return previous;
+}
+
+
+bool RS_Insert::isInstanceable() const {
+    // line widths and patterns of the block entities are drawn scaled,
+    // larger scales would also magnify the rounding to pixels
+    double const sx = fabs(data.scaleFactor.x);
+    return !materialized
+            && data.updateMode!=RS2::PreviewUpdate
+            && fabs(sx - fabs(data.scaleFactor.y)) <= RS_TOLERANCE*sx
+            && sx <= 1.0 + RS_TOLERANCE;
+}
+
+
+RS_Vector RS_Insert::toWorld(const RS_Vector& v, int col, int row) const {
+    RS_Vector p = v - getBlockForInsert()->getBasePoint()
+            + RS_Vector(data.spacing.x/data.scaleFactor.x*col,
+                        data.spacing.y/data.scaleFactor.y*row);
+    p = p.scale(data.scaleFactor);
+    p.rotate(data.angle);
+    return data.insertionPoint + p;
+}
+
+
+RS_Vector RS_Insert::toBlock(const RS_Vector& v, int col, int row) const {
+    RS_Vector p = v - data.insertionPoint;
+    p.rotate(-data.angle);
+    p.x /= data.scaleFactor.x;
+    p.y /= data.scaleFactor.y;
+    return p + getBlockForInsert()->getBasePoint()
+            - RS_Vector(data.spacing.x/data.scaleFactor.x*col,
+                        data.spacing.y/data.scaleFactor.y*row);
+}
+
+
+RS_Pen RS_Insert::getInstancePen(const RS_Entity* e, const RS_Pen& insertPen,
+                                 RS_Layer* insertLayer) {
+    // as the copies made by update() resolve their pens
+    RS_Pen p = e->getPen(false);
+    if (!p.isValid()) {
+        p = insertPen;
+    }
+    if (p.getColor().isByBlock()) {
+        p.setColor(insertPen.getColor());
+    }
+    if (p.getWidth()==RS2::WidthByBlock) {
+        p.setWidth(insertPen.getWidth());
+    }
+    if (p.getLineType()==RS2::LineByBlock) {
+        p.setLineType(insertPen.getLineType());
+    }
+
+    RS_Layer* l = getInstanceLayer(e, insertLayer);
+    if (l) {
+        if (p.getColor().isByLayer()) {
+            p.setColor(l->getPen().getColor());
+        }
+        if (p.getWidth()==RS2::WidthByLayer) {
+            p.setWidth(l->getPen().getWidth());
+        }
+        if (p.getLineType()==RS2::LineByLayer) {
+            p.setLineType(l->getPen().getLineType());
+        }
+    }
+    return p;
+}
+
+
+RS_Layer* RS_Insert::getInstanceLayer(const RS_Entity* e, RS_Layer* insertLayer) {
+    // entities on layer 0 are on the layer of the insert
+    RS_Layer* l = e->getLayer(true);
+    if (!l || l->getName()=="0") {
+        return insertLayer;
+    }
+    return l;
+}
+
+
 /**
  * @return Pointer to the block associated with this Insert or
  *   nullptr if the block couldn't be found. Blocks are requested
@@ -388,6 +513,226 @@ void RS_Insert::mirror(const RS_Vector& axisPoint1, const RS_Vector& axisPoint2)
 }
 
 
+void RS_Insert::calculateBorders() {
+    if (!instanced && !isUpdatePending()) {
+        RS_EntityContainer::calculateBorders();
+        return;
+    }
+
+    resetBorders();
+    RS_Block* blk = getBlockForInsert();
+    if (blk && blk->count()>0) {
+        RS_Vector const bMin = blk->getMin();
+        RS_Vector const bMax = blk->getMax();
+        if (bMin.x<=bMax.x && bMin.y<=bMax.y) {
+            RS_Vector const corners[] = {bMin, {bMin.x, bMax.y}, bMax, {bMax.x, bMin.y}};
+            for (int c: {0, data.cols-1}) {
+                for (int r: {0, data.rows-1}) {
+                    for (const RS_Vector& v: corners) {
+                        RS_Vector const p = toWorld(v, c, r);
+                        minV = RS_Vector::minimum(minV, p);
+                        maxV = RS_Vector::maximum(maxV, p);
+                    }
+                }
+            }
+        }
+    }
+    notifyBordersChanged();
+}
+
+
+void RS_Insert::forcedCalculateBorders() {
+    if (instanced || isUpdatePending()) {
+        calculateBorders();
+    } else {
+        RS_EntityContainer::forcedCalculateBorders();
+    }
+}
+
+
+RS_Vector RS_Insert::getNearestInBlock(const RS_Vector& coord, double* dist,
+        const std::function<RS_Vector(RS_Block*, const RS_Vector&, double*)>& query) const {
+    RS_Vector ret(false);
+    double minDist = RS_MAXDOUBLE;
+    RS_Block* blk = getBlockForInsert();
+    if (blk) {
+        double const scale = fabs(data.scaleFactor.x);
+        for (int c=0; c<data.cols; ++c) {
+            for (int r=0; r<data.rows; ++r) {
+                double d = RS_MAXDOUBLE;
+                RS_Vector const p = query(blk, toBlock(coord, c, r), &d);
+                if (p.valid && d*scale < minDist) {
+                    minDist = d*scale;
+                    ret = toWorld(p, c, r);
+                }
+            }
+        }
+    }
+    if (dist) {
+        *dist = minDist;
+    }
+    return ret;
+}
+
+
+RS_Vector RS_Insert::getNearestEndpoint(const RS_Vector& coord, double* dist) const {
+    if (!instanced) {
+        return RS_EntityContainer::getNearestEndpoint(coord, dist);
+    }
+    return getNearestInBlock(coord, dist, [](RS_Block* blk, const RS_Vector& v, double* d) {
+        return blk->getNearestEndpoint(v, d);
+    });
+}
+
+
+RS_Vector RS_Insert::getNearestPointOnEntity(const RS_Vector& coord, bool onEntity,
+                                             double* dist, RS_Entity** entity) const {
+    if (!instanced) {
+        return RS_EntityContainer::getNearestPointOnEntity(coord, onEntity, dist, entity);
+    }
+    // the entities of the block are not part of the drawing
+    if (entity) {
+        *entity = const_cast<RS_Insert*>(this);
+    }
+    return getNearestInBlock(coord, dist, [onEntity](RS_Block* blk, const RS_Vector& v, double* d) {
+        return blk->getNearestPointOnEntity(v, onEntity, d);
+    });
+}
+
+
+RS_Vector RS_Insert::getNearestCenter(const RS_Vector& coord, double* dist) const {
+    if (!instanced) {
+        return RS_EntityContainer::getNearestCenter(coord, dist);
+    }
+    return getNearestInBlock(coord, dist, [](RS_Block* blk, const RS_Vector& v, double* d) {
+        return blk->getNearestCenter(v, d);
+    });
+}
+
+
+RS_Vector RS_Insert::getNearestMiddle(const RS_Vector& coord, double* dist,
+                                      int middlePoints) const {
+    if (!instanced) {
+        return RS_EntityContainer::getNearestMiddle(coord, dist, middlePoints);
+    }
+    return getNearestInBlock(coord, dist, [middlePoints](RS_Block* blk, const RS_Vector& v, double* d) {
+        return blk->getNearestMiddle(v, d, middlePoints);
+    });
+}
+
+
+RS_Vector RS_Insert::getNearestDist(double distance, const RS_Vector& coord,
+                                    double* dist) const {
+    if (!instanced) {
+        return RS_EntityContainer::getNearestDist(distance, coord, dist);
+    }
+    double const blockDistance = distance/fabs(data.scaleFactor.x);
+    return getNearestInBlock(coord, dist, [blockDistance](RS_Block* blk, const RS_Vector& v, double* d) {
+        return blk->getNearestDist(blockDistance, v, d);
+    });
+}
+
+
+double RS_Insert::getDistanceToPoint(const RS_Vector& coord, RS_Entity** entity,
+                                     RS2::ResolveLevel level, double solidDist) const {
+    if (!instanced) {
+        return RS_EntityContainer::getDistanceToPoint(coord, entity, level, solidDist);
+    }
+
+    double const scale = fabs(data.scaleFactor.x);
+    double minDist = RS_MAXDOUBLE;
+    RS_Block* blk = getBlockForInsert();
+    if (blk) {
+        double const blockSolidDist = solidDist<RS_MAXDOUBLE ? solidDist/scale : solidDist;
+        for (int c=0; c<data.cols; ++c) {
+            for (int r=0; r<data.rows; ++r) {
+                RS_Entity* sub = nullptr;
+                double const d = blk->getDistanceToPoint(toBlock(coord, c, r), &sub,
+                                                         level, blockSolidDist);
+                if (sub && d<RS_MAXDOUBLE) {
+                    minDist = std::min(minDist, d*scale);
+                }
+            }
+        }
+    }
+    // the entities of the block are not part of the drawing
+    if (entity) {
+        *entity = const_cast<RS_Insert*>(this);
+    }
+    return minDist;
+}
+
+
+void RS_Insert::draw(RS_Painter* painter, RS_GraphicView* view, double& patternOffset) {
+    if (!instanced) {
+        RS_EntityContainer::draw(painter, view, patternOffset);
+        return;
+    }
+    RS_Block* blk = getBlockForInsert();
+    if (!(painter && view && blk)) {
+        return;
+    }
+
+    RS_Painter::Instance instance;
+    if (const RS_Painter::Instance* outer = painter->getInstance()) {
+        instance.pen = getInstancePen(this, outer->pen, outer->layer);
+        instance.layer = getInstanceLayer(this, outer->layer);
+        instance.selected = outer->selected || isSelected();
+        instance.highlighted = outer->highlighted || isHighlighted();
+    } else {
+        instance.pen = getPen(true);
+        instance.layer = getLayer(true);
+        instance.selected = isSelected();
+        instance.highlighted = isHighlighted();
+    }
+    instance.scale = fabs(data.scaleFactor.x);
+
+    // the entities of the block are shared by all inserts, threads
+    // rendering tiles of the view draw them one at a time
+    std::unique_lock<std::recursive_mutex> lock;
+    if (LC_RenderGuard* guard = painter->getRenderGuard()) {
+        lock = guard->lockBlocks();
+    }
+
+    // the block is drawn in its own screen coordinates, the painter maps
+    // them into the cell of the insert
+    RS_Vector const p0(view->toGraphX(0), view->toGraphY(0));
+    RS_Vector const px(view->toGraphX(1), view->toGraphY(0));
+    RS_Vector const py(view->toGraphX(0), view->toGraphY(1));
+    RS_Vector const bMin = blk->getMin();
+    RS_Vector const bMax = blk->getMax();
+    RS_Vector const corners[] = {bMin, {bMin.x, bMax.y}, bMax, {bMax.x, bMin.y}};
+
+    for (int c=0; c<data.cols; ++c) {
+        for (int r=0; r<data.rows; ++r) {
+            if (!view->isPrinting()) {
+                // skip cells outside of the view
+                RS_Vector vMin(RS_MAXDOUBLE, RS_MAXDOUBLE);
+                RS_Vector vMax(RS_MINDOUBLE, RS_MINDOUBLE);
+                for (const RS_Vector& v: corners) {
+                    RS_Vector const p = painter->mapInstance(view->toGui(toWorld(v, c, r)));
+                    vMin = RS_Vector::minimum(vMin, p);
+                    vMax = RS_Vector::maximum(vMax, p);
+                }
+                if (vMax.x<0 || vMin.x>view->getWidth()
+                        || vMax.y<0 || vMin.y>view->getHeight()) {
+                    continue;
+                }
+            }
+
+            instance.origin = view->toGui(toWorld(p0, c, r));
+            instance.axisX = view->toGui(toWorld(px, c, r)) - instance.origin;
+            instance.axisY = view->toGui(toWorld(py, c, r)) - instance.origin;
+            painter->pushInstance(instance);
+            for (RS_Entity* e: *blk) {
+                view->drawEntity(painter, e);
+            }
+            painter->popInstance();
+        }
+    }
+}
+
+
 std::ostream& operator << (std::ostream& os, const RS_Insert& i) {
     os << " Insert: " << i.getData() << std::endl;
     return os;
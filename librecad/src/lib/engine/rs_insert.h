@@ -28,9 +28,11 @@
 #ifndef RS_INSERT_H
 #define RS_INSERT_H
 
+#include <functional>
 #include "rs_entitycontainer.h"
 
 class RS_BlockList;
+class RS_Layer;
 
 /**
  * Holds the data that defines an insert.
@@ -106,6 +108,10 @@ public:
     RS_InsertData getData() const {
         return data;
     }
+    /** Sets new insert parameters, update() creates the sub-entities. **/
+    void setData(const RS_InsertData& d) {
+        data = d;
+    }
 
         /**
          * Reimplementation of reparent. Invalidates block cache pointer.
@@ -119,6 +125,39 @@ public:
 
     virtual void update();
 
+	/**
+	 * Instanced inserts don't hold copies of the block entities. They
+	 * draw and query the entities of the block through the transformation
+	 * of the insert. Used for uniform scales up to 1, unless the insert
+	 * was materialized.
+	 */
+	bool isInstanced() const {
+		return instanced;
+	}
+
+	/**
+	 * Creates the copies of the block entities, e.g. to explode the insert.
+	 * The insert stays materialized from then on.
+	 */
+	void materialize();
+
+	/**
+	 * While set on the calling thread, update() takes the inserts within
+	 * the block as up to date and does not update them again. Set by
+	 * LC_Regeneration, which updates nested blocks first.
+	 * @return the previous setting
+	 */
+	static bool setBlockInsertsUpdated(bool updated);
+
+	/**
+	 * @return the pen of a block entity, as a copy in an insert with the
+	 * given (resolved) pen and layer would have it.
+	 */
+	static RS_Pen getInstancePen(const RS_Entity* e, const RS_Pen& insertPen,
+								 RS_Layer* insertLayer);
+	//! @return the layer of a block entity, as for getInstancePen()
+	static RS_Layer* getInstanceLayer(const RS_Entity* e, RS_Layer* insertLayer);
+
     QString getName() const {
         return data.name;
     }
@@ -186,11 +225,52 @@ public:
     virtual void scale(const RS_Vector& center, const RS_Vector& factor);
     virtual void mirror(const RS_Vector& axisPoint1, const RS_Vector& axisPoint2);
 
+	void calculateBorders() override;
+	void forcedCalculateBorders() override;
+
+	RS_Vector getNearestEndpoint(const RS_Vector& coord,
+								 double* dist = nullptr) const override;
+	RS_Vector getNearestPointOnEntity(const RS_Vector& coord,
+									  bool onEntity = true,
+									  double* dist = nullptr,
+									  RS_Entity** entity = nullptr) const override;
+	RS_Vector getNearestCenter(const RS_Vector& coord,
+							   double* dist = nullptr) const override;
+	RS_Vector getNearestMiddle(const RS_Vector& coord,
+							   double* dist = nullptr,
+							   int middlePoints = 1) const override;
+	RS_Vector getNearestDist(double distance,
+							 const RS_Vector& coord,
+							 double* dist = nullptr) const override;
+	double getDistanceToPoint(const RS_Vector& coord,
+							  RS_Entity** entity,
+							  RS2::ResolveLevel level = RS2::ResolveNone,
+							  double solidDist = RS_MAXDOUBLE) const override;
+
+	void draw(RS_Painter* painter, RS_GraphicView* view, double& patternOffset) override;
+
     friend std::ostream& operator << (std::ostream& os, const RS_Insert& i);
 
 protected:
     RS_InsertData data;
 	mutable RS_Block* block;
+
+private:
+	//! true, if the insert can be drawn from the block directly
+	bool isInstanceable() const;
+	//! maps a point of the block into the cell (col, row) of the insert
+	RS_Vector toWorld(const RS_Vector& v, int col, int row) const;
+	//! maps a point of the cell (col, row) of the insert into the block
+	RS_Vector toBlock(const RS_Vector& v, int col, int row) const;
+	/**
+	 * Runs query on the block for every cell of the insert.
+	 * @return the closest point found, mapped into the insert
+	 */
+	RS_Vector getNearestInBlock(const RS_Vector& coord, double* dist,
+								const std::function<RS_Vector(RS_Block*, const RS_Vector&, double*)>& query) const;
+
+	bool instanced = false;
+	bool materialized = false;
 };
 
 
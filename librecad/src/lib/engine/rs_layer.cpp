@@ -28,6 +28,7 @@
 #include <iostream>
 #include <QString>
 #include "rs_layer.h"
+#include "rs_entity.h"
 
 RS_LayerData::RS_LayerData(const QString& name,
 						   const RS_Pen& pen,
@@ -65,6 +66,7 @@ QString RS_Layer::getName() const {
 /** sets the default pen for this layer. */
 void RS_Layer::setPen(const RS_Pen& pen) {
 	data.pen = pen;
+	penVersion = RS_Entity::nextPenVersion();
 }
 
 /** @return default pen for this layer. */
@@ -72,6 +74,10 @@ RS_Pen RS_Layer::getPen() const {
 	return data.pen;
 }
 
+unsigned long long RS_Layer::getPenVersion() const {
+	return penVersion;
+}
+
 /**
  * @retval true if this layer is frozen (invisible)
  * @retval false if this layer isn't frozen (visible)
@@ -87,6 +87,12 @@ public:
     /** @return default pen for this layer. */
 	RS_Pen getPen() const;
 
+    /**
+     * @return version of the pen, a new one whenever the pen is set,
+     * see RS_Entity::getResolvedPen()
+     */
+	unsigned long long getPenVersion() const;
+
     /**
      * @retval true if this layer is frozen (invisible)
      * @retval false if this layer isn't frozen (visible)
@@ -187,6 +193,8 @@ public:
 private:
     //! Layer data
     RS_LayerData data;
+    //! version of data.pen
+    unsigned long long penVersion = 0;
 
 };
 
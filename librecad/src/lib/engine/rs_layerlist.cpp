@@ -25,8 +25,10 @@
 **
 **********************************************************************/
 
+#include<algorithm>
 #include<iostream>
 #include "rs_debug.h"
+#include "rs_entity.h"
 #include "rs_layerlist.h"
 #include "rs_layer.h"
 #include "rs_layerlistlistener.h"
@@ -46,10 +48,35 @@ RS_LayerList::RS_LayerList() {
  */
 void RS_LayerList::clear() {
     layers.clear();
+    layerIndex.clear();
 	setModified(true);
 }
 
 
+/**
+ * Replaces the layers in this layerlist by the layers of other, which is
+ * left empty. The active layer is taken over. Listeners of this list are
+ * notified as if the layers were added.
+ */
+void RS_LayerList::take(RS_LayerList& other) {
+    layers = other.layers;
+    other.layers.clear();
+    layerIndex = other.layerIndex;
+    other.layerIndex.clear();
+    RS_Layer* active = other.activeLayer;
+    other.activeLayer = NULL;
+    other.setModified(true);
+
+    for (RS_Layer* layer: layers) {
+        for (RS_LayerListListener* l: layerListListeners) {
+            l->layerAdded(layer);
+        }
+    }
+    setModified(true);
+    activate(active, true);
+}
+
+
 QList<RS_Layer*>::iterator RS_LayerList::begin()
 {
     return layers.begin();
@@ -153,8 +180,13 @@ void RS_LayerList::add(RS_Layer* layer) {
     // check if layer already exists:
     RS_Layer* l = find(layer->getName());
     if (l==NULL) {
-        layers.append(layer);
-        this->sort();
+        // keep the list sorted by name
+        auto it = std::upper_bound(layers.begin(), layers.end(), layer,
+                                   [](const RS_Layer* l0, const RS_Layer* l1)->bool{
+                                       return l0->getName() < l1->getName();
+                                   });
+        layers.insert(it, layer);
+        layerIndex.insert(layer->getName(), layer);
         // notify listeners
         for (int i=0; i<layerListListeners.size(); ++i) {
             RS_LayerListListener* l = layerListListeners.at(i);
@@ -200,6 +232,9 @@ void RS_LayerList::remove(RS_Layer* layer) {
 
     // here the layer is removed from the list but not deleted
     layers.removeOne(layer);
+    if (layerIndex.value(layer->getName())==layer) {
+        layerIndex.remove(layer->getName());
+    }
 
     for (int i=0; i<layerListListeners.size(); ++i) {
         RS_LayerListListener* l = layerListListeners.at(i);
@@ -229,7 +264,15 @@ void RS_LayerList::edit(RS_Layer* layer, const RS_Layer& source) {
         return;
     }
 
+    QString const oldName = layer->getName();
     *layer = source;
+    // a new pen version for the entities on the layer
+    layer->setPen(source.getPen());
+    if (layer->getName()!=oldName && layerIndex.value(oldName)==layer) {
+        layerIndex.remove(oldName);
+        layerIndex.insert(layer->getName(), layer);
+        sort();
+    }
 
     for (int i=0; i<layerListListeners.size(); ++i) {
         RS_LayerListListener* l = layerListListeners.at(i);
@@ -247,21 +290,36 @@ void RS_LayerList::edit(RS_Layer* layer, const RS_Layer& source) {
  * \p NULL if no such layer was found.
  */
 RS_Layer* RS_LayerList::find(const QString& name) {
-    //RS_DEBUG->print("RS_LayerList::find begin");
-
-    RS_Layer* ret = NULL;
-
-    for (int i=0; i<layers.size(); ++i) {
-        RS_Layer* l = layers.at(i);
-        if (l->getName()==name) {
-            ret = l;
-            break;
+    std::lock_guard<std::mutex> lock(lookupMutex);
+    ++lookupStats.lookups;
+
+    RS_Layer* l = layerIndex.value(name, NULL);
+    if (l!=NULL) {
+        ++lookupStats.comparisons;
+        if (l->getName()!=name) {
+            // renamed behind our back
+            rebuildIndex();
+            l = layerIndex.value(name, NULL);
         }
     }
 
-    //RS_DEBUG->print("RS_LayerList::find end");
+    if (l!=NULL) {
+        ++lookupStats.hits;
+    }
+    return l;
+}
+
 
-    return ret;
+
+/**
+ * Rebuilds the index of the layers by name.
+ */
+void RS_LayerList::rebuildIndex() {
+    ++lookupStats.rebuilds;
+    layerIndex.clear();
+    for (RS_Layer* l: layers) {
+        layerIndex.insert(l->getName(), l);
+    }
 }
 
 
@@ -271,22 +329,8 @@ RS_Layer* RS_LayerList::find(const QString& name) {
  * was not found.
  */
 int RS_LayerList::getIndex(const QString& name) {
-    //RS_DEBUG->print("RS_LayerList::find begin");
-
-    int ret = -1;
-
-    for (int i=0; i<layers.size(); i++) {
-        RS_Layer* l = layers.at(i);
-
-        if (l->getName()==name) {
-            ret = i;
-            break;
-        }
-    }
-
-    //RS_DEBUG->print("RS_LayerList::find end");
-
-    return ret;
+    RS_Layer* l = find(name);
+    return l==NULL ? -1 : layers.indexOf(l);
 }
 
 
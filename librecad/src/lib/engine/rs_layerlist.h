@@ -29,8 +29,11 @@
 #ifndef RS_LAYERLIST_H
 #define RS_LAYERLIST_H
 
+#include <mutex>
+#include <QHash>
 #include <QList>
 #include "rs_layer.h"
+#include "lc_lookupstats.h"
 
 class RS_LayerListListener;
 class QG_LayerWidget;
@@ -46,6 +49,7 @@ public:
 	virtual ~RS_LayerList() = default;
 
     void clear();
+    void take(RS_LayerList& other);
 
     /**
      * @return Number of layers in the list.
@@ -124,11 +128,29 @@ public:
      */
     void sort();
 
+    //! @return statistics of the lookups by name
+    const LC_LookupStats& getLookupStats() const {
+        return lookupStats;
+    }
+    void resetLookupStats() {
+        lookupStats.reset();
+    }
+
     friend std::ostream& operator << (std::ostream& os, RS_LayerList& l);
 
 private:
+    void rebuildIndex();
+
     //! layers in the graphic
     QList<RS_Layer*> layers;
+    /**
+     * Layers by name. Layers are renamed by edit() only, which keeps the
+     * index up to date.
+     */
+    QHash<QString, RS_Layer*> layerIndex;
+    LC_LookupStats lookupStats;
+    //! layers are looked up by regenerations on several threads
+    std::mutex lookupMutex;
     //! List of registered LayerListListeners
     QList<RS_LayerListListener*> layerListListeners;
     QG_LayerWidget* layerWidget;
@@ -30,7 +30,8 @@
 #include "rs_mtext.h"
 
 #include "rs_fontlist.h"
-#include "rs_insert.h"
+#include "lc_glyphcache.h"
+#include "lc_textglyph.h"
 #include "rs_math.h"
 #include "rs_debug.h"
 #include "rs_graphicview.h"
@@ -220,7 +221,20 @@ int RS_MText::getNumberOfLines() {
 
 
 /**
- * Updates the Inserts (letters) of this text. Called when the
+ * Creates the inserts of the letter blocks, e.g. to explode the text.
+ */
+void RS_MText::materialize() {
+    if (!materialized) {
+        materialized = true;
+        update();
+    }
+}
+
+
+
+
+/**
+ * Updates the letters of this text. Called when the
  * text or it's data, position, alignment, .. changes.
  * This method also updates the usedTextWidth / usedTextHeight property.
  */
@@ -363,6 +377,9 @@ void RS_MText::update()
                                                                   RS2::Update)) };
                     upper->setLayer( nullptr);
                     upper->setPen( RS_Pen( RS2::FlagInvalid));
+                    if (materialized) {
+                        upper->materialize();
+                    }
                     upper->calculateBorders();
                     oneLine->addEntity(upper);
                     upperWidth = upper->getSize().x;
@@ -385,6 +402,9 @@ void RS_MText::update()
                                                                   RS2::Update)) };
                     lower->setLayer( nullptr);
                     lower->setPen( RS_Pen( RS2::FlagInvalid));
+                    if (materialized) {
+                        lower->materialize();
+                    }
                     lower->calculateBorders();
                     oneLine->addEntity(lower);
                     lowerWidth = lower->getSize().x;
@@ -417,7 +437,7 @@ void RS_MText::update()
         default: {
             // One Letter:
             QString letterText {QString(data.text.at(i))};
-            if (nullptr == font->findLetter( letterText)) {
+            if (nullptr == LC_GLYPHCACHE->find( font, letterText)) {
                 RS_DEBUG->print("RS_MText::update: missing font for letter( %s ), replaced it with QChar(0xfffd)",
                                 qPrintable( letterText));
                 letterText = QChar( 0xfffd);
@@ -425,24 +445,13 @@ void RS_MText::update()
 
             RS_DEBUG->print("RS_MText::update: insert a letter at pos: %f/%f", letterPos.x, letterPos.y);
 
-            RS_InsertData d( letterText,
-                             letterPos,
-                             RS_Vector( 1.0, 1.0),
-                             0.0,
-                             1,
-                             1,
-                             RS_Vector( 0.0, 0.0),
-                             font->getLetterList(),
-                             RS2::NoUpdate);
-
-            RS_Insert* letter {new RS_Insert(this, d)};
-            RS_Vector letterWidth;
-            letter->setPen( RS_Pen( RS2::FlagInvalid));
-            letter->setLayer( nullptr);
-            letter->update();
-            letter->forcedCalculateBorders();
-
-            letterWidth = RS_Vector( letter->getMax().x - letterPos.x, 0.0);
+            RS_Entity* letter {LC_TextGlyph::createLetter( this, font, letterText,
+                                                           letterPos, materialized)};
+            if (nullptr == letter) {
+                break;
+            }
+
+            RS_Vector letterWidth {RS_Vector( letter->getMax().x - letterPos.x, 0.0)};
             if (0 > letterWidth.x) {
                 letterWidth.x = -letterSpace.x;
             }
@@ -675,7 +684,7 @@ void RS_MText::draw(RS_Painter* painter, RS_GraphicView* view, double& /*pattern
 
     if (!view->isPrintPreview() && !view->isPrinting())
     {
-        if (view->isPanning() || view->toGuiDY(getHeight()) < 4)
+        if (view->isPanning() || view->toGuiDY(getHeight()) < view->getTextLodThreshold())
         {
             painter->drawRect(view->toGui(getMin()), view->toGui(getMax()));
             return;
@@ -161,9 +161,23 @@ public:
     RS_MTextData getData() const {
         return data;
     }
+    /** Sets new text parameters, update() creates the sub-entities. */
+    void setData(const RS_MTextData& d) {
+        data = d;
+    }
 
     void update() override;
 
+    /**
+     * Texts draw their letters from glyphs shared through LC_GlyphCache,
+     * unless materialized: then the letters are inserts of the letter
+     * blocks of the font, see RS_Text::materialize().
+     */
+    void materialize();
+    bool isMaterialized() const {
+        return materialized;
+    }
+
     int getNumberOfLines();
 
 
@@ -271,6 +285,9 @@ protected:
      * @see update
      */
     double usedTextHeight;
+
+private:
+    bool materialized = false;
 };
 
 #endif
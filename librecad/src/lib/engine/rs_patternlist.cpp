@@ -70,6 +70,7 @@ void RS_PatternList::init() {
  */
 RS_Pattern* RS_PatternList::requestPattern(const QString& name) {
     RS_DEBUG->print("RS_PatternList::requestPattern %s", name.toLatin1().data());
+	std::lock_guard<std::recursive_mutex> lock(mutex);
 
     QString name2 = name.toLower();
 
@@ -30,6 +30,7 @@
 
 #include<map>
 #include<memory>
+#include<mutex>
 
 class RS_Pattern;
 class QString;
@@ -89,6 +90,8 @@ public:
 private:
     //! patterns in the graphic
 	PTN_MAP patterns;
+	//! patterns are requested by file imports in the background too
+	std::recursive_mutex mutex;
 };
 
 #endif
@@ -49,6 +49,7 @@ RS2::EntityType RS_Point::rtti() const
 
 void RS_Point::calculateBorders () {
     minV = maxV = data.pos;
+    notifyBordersChanged();
 }
 
 RS_VectorSolutions RS_Point::getRefPoints() const
@@ -71,6 +72,11 @@ RS_PointData RS_Point::getData() const
     return data;
 }
 
+void RS_Point::setData(const RS_PointData& d)
+{
+    data = d;
+}
+
 RS_Vector RS_Point::getPos() const
 {
     return data.pos;
@@ -32,6 +32,7 @@
 #include "rs_line.h"
 #include "rs_arc.h"
 #include "rs_graphicview.h"
+#include "rs_painter.h"
 #include "rs_math.h"
 #include "rs_information.h"
 
@@ -360,6 +361,7 @@ void RS_Polyline::setLayer(const QString& name) {
 
 void RS_Polyline::setLayer(RS_Layer* l) {
     layer = l;
+    invalidateResolvedPen();
     // set layer for sub-entities
     for (auto *e : entities) {
         e->setLayer(layer);
@@ -737,7 +739,8 @@ void RS_Polyline::draw(RS_Painter* painter,RS_GraphicView* view, double& /*patte
     // first line so that subsequent line are draw in the right color
     //prevent segfault if polyline is empty
 	if (e) {
-        RS_Pen p=this->getPen(true);
+        // in an instanced insert the pen is resolved against the insert
+        RS_Pen p = painter->getInstance() ? getPen(false) : getPen(true);
         e->setPen(p);
         double patternOffset=0.;
         view->drawEntity(painter, e, patternOffset);
@@ -71,6 +71,10 @@ public:
     RS_PolylineData getData() const {
         return data;
     }
+    /** Sets new polyline parameters. */
+    void setData(const RS_PolylineData& d) {
+        data = d;
+    }
 
     /** sets a new start point of the polyline */
 	void setStartpoint(RS_Vector const& v);
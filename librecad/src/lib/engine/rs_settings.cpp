@@ -31,6 +31,12 @@
 RS_Settings* RS_Settings::uniqueInstance = nullptr;
 bool RS_Settings::save_is_allowed = true;
 
+namespace {
+//! the current group, per thread, so a file import in the background can
+//! read settings while the GUI thread is in a group
+thread_local QString group;
+}
+
 RS_Settings::RS_Settings():
 	initialized(false)
 {
@@ -74,11 +80,11 @@ RS_Settings::~RS_Settings() {
 
 
 void RS_Settings::beginGroup(const QString& group) {
-    this->group = group;
+    ::group = group;
 }
 
 void RS_Settings::endGroup() {
-    this->group = "";
+    ::group = "";
 }
 
 bool RS_Settings::writeEntry(const QString& key, int value) {
@@ -106,7 +112,7 @@ bool RS_Settings::writeEntry(const QString& key, const QVariant& value) {
     // RVT_PORT not supported anymore s.insertSearchPath(QSettings::Windows, companyKey);
 
     s.setValue(QString("%1%2").arg(group).arg(key), value);
-	cache[key]=value;
+	addToCache(key, value);
 
     return true;
 }
@@ -127,7 +133,7 @@ QString RS_Settings::readEntry(const QString& key,
 		}
 		
         ret = s.value(QString("%1%2").arg(group).arg(key), QVariant(def));
-		cache[key]=ret;
+		addToCache(key, ret);
     }
 
     return ret.toString();
@@ -148,7 +154,7 @@ QByteArray RS_Settings::readByteArrayEntry(const QString& key,
                 }
 
         ret = s.value(QString("%1%2").arg(group).arg(key), QVariant(def));
-		cache[key]=ret;
+		addToCache(key, ret);
     }
 
     return ret.toByteArray();
@@ -164,20 +170,23 @@ int RS_Settings::readNumEntry(const QString& key, int def)
 		QString str = QString("%1%2").arg(group).arg(key);
 		// qDebug() << str;
 		value = s.value(str, QVariant(def));
-		cache[key] = value;
+		addToCache(key, value);
 	}
 	return value.toInt();
 }
 
 
 QVariant RS_Settings::readEntryCache(const QString& key) {
-	if(!cache.count(key)) return QVariant();
-	return cache[key];
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	auto it = cache.find(key);
+	if (it == cache.end()) return QVariant();
+	return it->second;
 }
 
 
 void RS_Settings::addToCache(const QString& key, const QVariant& value) {
-    cache[key]=value;
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	cache[key]=value;
 }
 
 void RS_Settings::clear_all()
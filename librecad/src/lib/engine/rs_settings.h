@@ -30,6 +30,7 @@
 
 #include <QString>
 #include <map>
+#include <mutex>
 
 class QVariant;
 
@@ -108,9 +109,9 @@ protected:
     static RS_Settings* uniqueInstance;
 
 	std::map<QString, QVariant> cache;
+	std::mutex cacheMutex;
     QString companyKey;
     QString appKey;
-    QString group;
     bool initialized;
 };
 
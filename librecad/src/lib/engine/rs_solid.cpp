@@ -140,6 +140,7 @@ void RS_Solid::calculateBorders()
             maxV = RS_Vector::maximum( maxV, data.corner[i]);
         }
     }
+    notifyBordersChanged();
 }
 
 RS_Vector RS_Solid::getNearestEndpoint(const RS_Vector& coord, double* dist /*= nullptr*/)const
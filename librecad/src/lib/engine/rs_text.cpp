@@ -30,7 +30,8 @@
 #include "rs_text.h"
 
 #include "rs_fontlist.h"
-#include "rs_insert.h"
+#include "lc_glyphcache.h"
+#include "lc_textglyph.h"
 #include "rs_math.h"
 #include "rs_debug.h"
 #include "rs_graphicview.h"
@@ -248,7 +249,19 @@ int RS_Text::getNumberOfLines() {
 
 
 /**
- * Updates the Inserts (letters) of this text. Called when the
+ * Creates the inserts of the letter blocks, e.g. to explode the text.
+ */
+void RS_Text::materialize() {
+    if (!materialized) {
+        materialized = true;
+        update();
+    }
+}
+
+
+
+/**
+ * Updates the letters of this text. Called when the
  * text or it's data, position, alignment, .. changes.
  * This method also updates the usedTextWidth / usedTextHeight property.
  */
@@ -289,28 +302,19 @@ void RS_Text::update() {
         } else {
             // One Letter:
             QString letterText = QString(data.text.at(i));
-            if (font->findLetter(letterText) == NULL) {
+            if (!LC_GLYPHCACHE->find(font, letterText)) {
                 RS_DEBUG->print("RS_Text::update: missing font for letter( %s ), replaced it with QChar(0xfffd)",qPrintable(letterText));
                 letterText = QChar(0xfffd);
             }
             RS_DEBUG->print("RS_Text::update: insert a "
                             "letter at pos: %f/%f", letterPos.x, letterPos.y);
 
-            RS_InsertData d(letterText,
-                            letterPos,
-                            RS_Vector(1.0, 1.0),
-                            0.0,
-                            1,1, RS_Vector(0.0,0.0),
-                            font->getLetterList(), RS2::NoUpdate);
-
-            RS_Insert* letter = new RS_Insert(this, d);
-            RS_Vector letterWidth;
-            letter->setPen(RS_Pen(RS2::FlagInvalid));
-            letter->setLayer(NULL);
-            letter->update();
-            letter->forcedCalculateBorders();
-
-            letterWidth = RS_Vector(letter->getMax().x-letterPos.x, 0.0);
+            RS_Entity* letter = LC_TextGlyph::createLetter(this, font, letterText,
+                                                           letterPos, materialized);
+            if (!letter) {
+                continue;
+            }
+            RS_Vector letterWidth = RS_Vector(letter->getMax().x-letterPos.x, 0.0);
             if (letterWidth.x < 0)
                 letterWidth.x = -letterSpace.x;
 
@@ -544,7 +548,7 @@ void RS_Text::draw(RS_Painter* painter, RS_GraphicView* view, double& /*patternO
 
     if (!view->isPrintPreview() && !view->isPrinting())
     {
-        if (view->isPanning() || view->toGuiDY(getHeight()) < 4)
+        if (view->isPanning() || view->toGuiDY(getHeight()) < view->getTextLodThreshold())
         {
             painter->drawRect(view->toGui(getMin()), view->toGui(getMax()));
             return;
@@ -152,9 +152,24 @@ public:
     RS_TextData getData() const {
         return data;
     }
+    /** Sets new text parameters, update() creates the sub-entities. */
+    void setData(const RS_TextData& d) {
+        data = d;
+    }
 
     void update() override;
 
+    /**
+     * Texts draw their letters from glyphs shared through LC_GlyphCache,
+     * unless materialized: then the letters are inserts of the letter
+     * blocks of the font, e.g. to explode them. The text stays
+     * materialized from then on.
+     */
+    void materialize();
+    bool isMaterialized() const {
+        return materialized;
+    }
+
     int getNumberOfLines();
 
 
@@ -258,6 +273,9 @@ protected:
      * @see update
      */
     double usedTextHeight;
+
+private:
+    bool materialized = false;
 };
 
 #endif
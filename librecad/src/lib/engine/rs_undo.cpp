@@ -26,11 +26,16 @@
 **********************************************************************/
 
 #include<iostream>
+#include <algorithm>
+#include <set>
 #include "qc_applicationwindow.h"
 #include "rs_undocycle.h"
 #include "rs_undo.h"
 #include "rs_debug.h"
 
+int RS_Undo::maxCycles = 0;
+size_t RS_Undo::maxMemory = 0;
+
 /**
  * @return Number of Cycles that can be undone.
  */
@@ -95,36 +100,37 @@ void RS_Undo::startUndoCycle()
         return;
     }
 
+    // the containers change from now on, the last cycle can't be
+    // compacted anymore
+    pendingCycle = nullptr;
+
     size_t  removePointer {static_cast<size_t>(undoPointer + 1)};
     // if there are undo cycles behind undoPointer
     // remove obsolete entities and undoCycles
     if (undoList.size() > removePointer) {
         // collect remaining undoables
-        std::list<RS_Undoable*> keep;
+        std::set<RS_Undoable*> keep;
         for (auto it = undoList.begin(); it != undoList.begin() + removePointer; ++it) {
-            for (auto u: (*it)->getUndoables()){
-                keep.push_back( u);
-            }
+            keep.insert( (*it)->getUndoables().begin(), (*it)->getUndoables().end());
         }
-        keep.unique();
 
-        // collect obsolete undoables
-        std::list<RS_Undoable*> obsolete;
+        // entities detached by obsolete cycles are deleted with them
         for (auto it = undoList.begin() + removePointer; it != undoList.end(); ++it) {
-            for (auto u: (*it)->getUndoables()){
-                obsolete.push_back( u);
+            for (auto e: (*it)->getDetachedEntities()){
+                keep.insert( e);
             }
         }
-        // unique() only works correct on sorted list!
-        obsolete.sort();
-        obsolete.unique();
-
-        // delete obsolte undoables which are not in keep list
-        for (auto it = obsolete.begin(); it != obsolete.end(); ++it) {
-            if (keep.end() == std::find( keep.begin(), keep.end(), *it)) {
-                removeUndoable( *it);
+
+        // delete obsolete undoables which are not in keep list
+        std::vector<RS_Undoable*> obsolete;
+        for (auto it = undoList.begin() + removePointer; it != undoList.end(); ++it) {
+            for (auto u: (*it)->getUndoables()){
+                if (keep.insert( u).second) {
+                    obsolete.push_back( u);
+                }
             }
         }
+        removeUndoables( obsolete);
 
         // clean up obsolete undoCycles
         while (undoList.size() > removePointer) {
@@ -137,6 +143,17 @@ void RS_Undo::startUndoCycle()
 }
 
 
+/**
+ * Deletes the given undoables, like removeUndoable() for each of them.
+ * Implementations may override this to remove them at once.
+ */
+void RS_Undo::removeUndoables(const std::vector<RS_Undoable*>& obsolete) {
+    for (auto u: obsolete) {
+        removeUndoable( u);
+    }
+}
+
+
 /**
  * Adds an undoable to the current undo cycle.
  */
@@ -154,6 +171,25 @@ void RS_Undo::addUndoable(RS_Undoable* u) {
 
 
 
+/**
+ * Adds a record of an in place change to the current undo cycle,
+ * which takes ownership of it.
+ */
+void RS_Undo::addUndoRecord(LC_UndoRecord* r) {
+    RS_DEBUG->print("RS_Undo::%s(): begin", __func__);
+
+    if( nullptr == currentCycle) {
+        RS_DEBUG->print( RS_Debug::D_CRITICAL, "RS_Undo::%s(): invalid currentCycle, possibly missing startUndoCycle()", __func__);
+        delete r;
+        return;
+    }
+
+    currentCycle->addUndoRecord(r);
+    RS_DEBUG->print("RS_Undo::%s(): end", __func__);
+}
+
+
+
 /**
  * Ends the current undo cycle.
  */
@@ -174,6 +210,11 @@ void RS_Undo::endUndoCycle()
     if (hasUndoable()) {
         // only keep the undoCycle, when it contains undoables
         addUndoCycle(currentCycle);
+        pendingCycle = currentCycle;
+        auto appWin = QC_ApplicationWindow::getAppWindow();
+        if (appWin) {
+            appWin->scheduleUndoCompaction();
+        }
     }
 
     setGUIButtons();
@@ -182,12 +223,119 @@ void RS_Undo::endUndoCycle()
 
 
 
+/**
+ * Detaches the undone entities of the last cycle, if that wasn't done yet,
+ * and frees the oldest cycles beyond the limits.
+ */
+void RS_Undo::compactUndone()
+{
+    if (0 < refCount) {
+        // a cycle is open, its caller may iterate a container
+        return;
+    }
+
+    if (nullptr != pendingCycle) {
+        pendingCycle->compact();
+        pendingCycle = nullptr;
+    }
+    trimUndoCycles();
+}
+
+
+
+/**
+ * Frees the oldest cycles that can be undone, while there are more than
+ * maxCycles or they take more than maxMemory. The last cycle is kept.
+ */
+void RS_Undo::trimUndoCycles()
+{
+    if (0 == maxCycles && 0 == maxMemory) {
+        return;
+    }
+
+    size_t memory {0};
+    if (0 < maxMemory) {
+        for (int i = 0; i <= undoPointer; ++i) {
+            memory += undoList[i]->memoryUsage();
+        }
+    }
+    int drop {0};
+    while (drop < undoPointer
+           && ((0 < maxCycles && undoPointer + 1 - drop > maxCycles)
+               || (0 < maxMemory && memory > maxMemory))) {
+        if (0 < maxMemory) {
+            memory -= undoList[drop]->memoryUsage();
+        }
+        ++drop;
+    }
+    if (0 == drop) {
+        return;
+    }
+    RS_DEBUG->print("RS_Undo::%s(): freeing %d cycles", __func__, drop);
+
+    // undoables still referenced by the remaining cycles
+    std::set<RS_Undoable*> keep;
+    for (auto it = undoList.begin() + drop; it != undoList.end(); ++it) {
+        keep.insert( (*it)->getUndoables().begin(), (*it)->getUndoables().end());
+    }
+    // entities detached by the freed cycles are deleted with them
+    for (auto it = undoList.begin(); it != undoList.begin() + drop; ++it) {
+        for (auto e: (*it)->getDetachedEntities()){
+            keep.insert( e);
+        }
+    }
+
+    // undone entities of the freed cycles can't be restored anymore
+    std::vector<RS_Undoable*> obsolete;
+    for (auto it = undoList.begin(); it != undoList.begin() + drop; ++it) {
+        for (auto u: (*it)->getUndoables()) {
+            if (keep.insert( u).second && u->isUndone()) {
+                obsolete.push_back( u);
+            }
+        }
+    }
+    removeUndoables( obsolete);
+
+    undoList.erase(undoList.begin(), undoList.begin() + drop);
+    undoPointer -= drop;
+    setGUIButtons();
+}
+
+
+
+/**
+ * @return Entities detached from their containers by any cycle.
+ */
+std::vector<RS_Entity*> RS_Undo::getDetachedEntities() const
+{
+    std::vector<RS_Entity*> ret;
+    for (auto const& cycle: undoList) {
+        auto entities = cycle->getDetachedEntities();
+        ret.insert(ret.end(), entities.begin(), entities.end());
+    }
+    return ret;
+}
+
+
+
+/**
+ * Sets the limits of all undo lists.
+ */
+void RS_Undo::setLimits(int cycles, int megabytes)
+{
+    maxCycles = std::max(cycles, 0);
+    maxMemory = static_cast<size_t>(std::max(megabytes, 0)) * 1024 * 1024;
+}
+
+
+
 /**
  * Undoes the last undo cycle.
  */
 bool RS_Undo::undo() {
     RS_DEBUG->print("RS_Undo::undo");
 
+	compactUndone();
 	if (undoPointer < 0) return false;
 
 	std::shared_ptr<RS_UndoCycle> uc = undoList[undoPointer--];
@@ -204,6 +352,7 @@ bool RS_Undo::undo() {
 bool RS_Undo::redo() {
     RS_DEBUG->print("RS_Undo::redo");
 
+	compactUndone();
 	if (undoPointer+1 < int(undoList.size())) {
 
 		std::shared_ptr<RS_UndoCycle> uc = undoList[++undoPointer];
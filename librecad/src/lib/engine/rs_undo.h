@@ -32,6 +32,8 @@
 #include <memory>
 #include <vector>
 
+class LC_UndoRecord;
+class RS_Entity;
 class RS_UndoCycle;
 class RS_Undoable;
 
@@ -58,6 +60,7 @@ public:
 
     virtual void startUndoCycle();
     virtual void addUndoable(RS_Undoable* u);
+    virtual void addUndoRecord(LC_UndoRecord* r);
     virtual void endUndoCycle();
 
     /**
@@ -66,6 +69,27 @@ public:
      * for Undoables that are no longer in the undo buffer.
      */
     virtual void removeUndoable(RS_Undoable* u) = 0;
+    //! deletes several undoables, see removeUndoable()
+    virtual void removeUndoables(const std::vector<RS_Undoable*>& obsolete);
+
+    /**
+     * Detaches the undone entities of the last cycle from their containers
+     * and frees the oldest cycles beyond the limits. Containers may be
+     * iterated while a cycle ends, so this is deferred to the event loop
+     * of the application window, or done on the next undo/redo.
+     */
+    void compactUndone();
+
+    //! entities the undo list took out of their containers
+    std::vector<RS_Entity*> getDetachedEntities() const;
+
+    /**
+     * Limits for all undo lists, the oldest cycles are freed beyond them.
+     * @param cycles maximum number of cycles that can be undone, 0 for no limit
+     * @param megabytes maximum estimated memory of the cycles that can be
+     *        undone, 0 for no limit
+     */
+    static void setLimits(int cycles, int megabytes);
 
     /**
 	  *\brief enable/disable redo/undo buttons in main application window
@@ -80,6 +104,9 @@ public:
 private:
 
 	void addUndoCycle(std::shared_ptr<RS_UndoCycle> const& i);
+	//! frees the oldest cycles beyond the limits
+	void trimUndoCycles();
+
     //! List of undo list items. every item is something that can be undone.
 	std::vector<std::shared_ptr<RS_UndoCycle>> undoList;
 
@@ -97,6 +124,12 @@ private:
     std::shared_ptr<RS_UndoCycle> currentCycle {nullptr};
 
     int refCount {0}; ///< reference counter for nested start/end calls
+
+    //! last cycle added, if not compacted yet
+    std::shared_ptr<RS_UndoCycle> pendingCycle {nullptr};
+
+    static int maxCycles;
+    static size_t maxMemory;
 };
 
 
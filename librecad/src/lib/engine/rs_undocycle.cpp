@@ -26,8 +26,25 @@
 **********************************************************************/
 
 
+#include <map>
 #include <ostream>
 #include"rs_undocycle.h"
+#include "rs_entitycontainer.h"
+
+namespace {
+//! estimated size of an entity in bytes, including its data and caches
+constexpr size_t entityBytes = 512;
+//! estimated size of a record in bytes
+constexpr size_t recordBytes = 256;
+}
+
+RS_UndoCycle::~RS_UndoCycle()
+{
+    for (auto const& d: detached) {
+        for (auto const& p: d.entities)
+            delete p.second;
+    }
+}
 
 /**
  * Adds an Undoable to this Undo Cycle. Every Cycle can contain one or
@@ -51,17 +68,107 @@ void RS_UndoCycle::removeUndoable(RS_Undoable* u) {
 }
 
 /**
- * Return number of undoables in cycle
+ * Adds a record of an in place change, the cycle takes ownership.
+ */
+void RS_UndoCycle::addUndoRecord(LC_UndoRecord* r) {
+    if (!r)
+        return;
+
+    records.emplace_back(r);
+}
+
+/**
+ * Return number of undoables and records in cycle
  */
 size_t RS_UndoCycle::size()
 {
-    return undoables.size();
+    return undoables.size() + records.size();
 }
 
 void RS_UndoCycle::changeUndoState()
 {
+	if (compacted)
+		attachDetached();
+	memory = 0;
+	undone = !undone;
+	// records may change entities created in the same cycle, so they are
+	// reverted before the entities are toggled and applied again after
+	if (undone) {
+		for (auto it = records.rbegin(); it != records.rend(); ++it)
+			(*it)->undo();
+	}
 	for (RS_Undoable* u: undoables)
 		u->changeUndoState();
+	if (!undone) {
+		for (auto& r: records)
+			r->redo();
+	}
+	if (compacted)
+		detachUndone();
+}
+
+void RS_UndoCycle::compact()
+{
+	if (compacted)
+		return;
+	compacted = true;
+	detachUndone();
+}
+
+bool RS_UndoCycle::isCompact() const
+{
+	return compacted;
+}
+
+std::vector<RS_Entity*> RS_UndoCycle::getDetachedEntities() const
+{
+	std::vector<RS_Entity*> ret;
+	for (auto const& d: detached) {
+		for (auto const& p: d.entities)
+			ret.push_back(p.second);
+	}
+	return ret;
+}
+
+void RS_UndoCycle::detachUndone()
+{
+	std::map<RS_EntityContainer*, std::vector<RS_Entity*>> undone;
+	for (RS_Undoable* u: undoables) {
+		if (u->undoRtti() != RS2::UndoableEntity || !u->isUndone())
+			continue;
+		RS_Entity* e = static_cast<RS_Entity*>(u);
+		if (e->getParent())
+			undone[e->getParent()].push_back(e);
+	}
+	// entities outside of a container list, e.g. blocks, stay
+	for (auto& p: undone) {
+		auto entities = p.first->detachEntities(p.second);
+		if (!entities.empty())
+			detached.push_back({p.first, std::move(entities)});
+	}
+}
+
+void RS_UndoCycle::attachDetached()
+{
+	for (auto const& d: detached)
+		d.container->attachEntities(d.entities);
+	detached.clear();
+}
+
+size_t RS_UndoCycle::memoryUsage()
+{
+	if (memory == 0) {
+		memory = sizeof(RS_UndoCycle)
+				+ undoables.size() * 4 * sizeof(void*)
+				+ records.size() * recordBytes;
+		for (RS_Undoable* u: undoables) {
+			if (u->undoRtti() != RS2::UndoableEntity || !u->isUndone())
+				continue;
+			RS_Entity* e = static_cast<RS_Entity*>(u);
+			memory += (e->isContainer() ? e->countDeep() + 1 : 1) * entityBytes;
+		}
+	}
+	return memory;
 }
 
 std::set<RS_Undoable*> const& RS_UndoCycle::getUndoables() const
@@ -92,6 +199,8 @@ std::ostream& operator << (std::ostream& os,
 		}
 
 	}
+	if (!uc.records.empty())
+		os << " records: " << uc.records.size();
 
 	return os;
 }
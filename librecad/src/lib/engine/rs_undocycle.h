@@ -30,16 +30,28 @@
 #define RS_UNDOLISTITEM_H
 
 #include <iosfwd>
+#include <memory>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include "rs_entity.h"
 #include "rs_undoable.h"
+#include "lc_undorecord.h"
+
+class RS_EntityContainer;
 
 /**
  * An Undo Cycle represents an action that was triggered and can
  * be undone. It stores all the pointers to the Undoables affected by
  * the action. Undoables are entities in a container that can be
- * created and deleted.
+ * created and deleted. Entities changed in place are stored as
+ * LC_UndoRecord entries instead, which are owned by the cycle.
+ *
+ * Once compacted, a cycle takes the entities it made undone out of their
+ * containers and owns them until it puts them back, so live containers
+ * only hold active entities. Entities are put back at their former index,
+ * which holds since the undo list restores the containers in reverse.
  *
  * Undo Cycles are stored within classes derrived from RS_Undo.
  *
@@ -54,6 +66,10 @@ public:
      * @param type Type of undo item.
      */
 	RS_UndoCycle(/*RS2::UndoType type*/)=default;
+    //! deletes the detached entities
+    ~RS_UndoCycle();
+    RS_UndoCycle(RS_UndoCycle const&) = delete;
+    RS_UndoCycle& operator = (RS_UndoCycle const&) = delete;
 
     /**
      * Adds an Undoable to this Undo Cycle. Every Cycle can contain one or
@@ -67,7 +83,12 @@ public:
     void removeUndoable(RS_Undoable* u);
 
     /**
-     * Return number of undoables in cycle
+     * Adds a record of an in place change, the cycle takes ownership.
+     */
+    void addUndoRecord(LC_UndoRecord* r);
+
+    /**
+     * Return number of undoables and records in cycle
      */
     size_t size(void);
 
@@ -75,6 +96,22 @@ public:
     //! change undo state of all undoable in the current cycle
     void changeUndoState();
 
+    /**
+     * Detaches the undone entities of the cycle from now on, after every
+     * change of the undo state. Must be called right after the cycle was
+     * added or changed, before any other change of the containers.
+     */
+    void compact();
+    bool isCompact() const;
+    //! entities detached by this cycle
+    std::vector<RS_Entity*> getDetachedEntities() const;
+
+    /**
+     * Estimated memory in bytes kept only for undo, i.e. by undone
+     * entities and records.
+     */
+    size_t memoryUsage();
+
     friend std::ostream& operator << (std::ostream& os, RS_UndoCycle& uc);
 
     friend class RS_Undo;
@@ -82,10 +119,29 @@ public:
     std::set<RS_Undoable*> const& getUndoables() const;
 
 private:
+    void detachUndone();
+    void attachDetached();
+
+    //! entities detached from one container, with their former index
+    struct Detached {
+        RS_EntityContainer* container;
+        std::vector<std::pair<int, RS_Entity*>> entities;
+    };
+
     //! Undo type:
     //RS2::UndoType type;
     //! List of entity id's that were affected by this action
     std::set<RS_Undoable*> undoables;
+    //! in place changes, in the order they were made
+    std::vector<std::unique_ptr<LC_UndoRecord>> records;
+    //! true, if the cycle is undone
+    bool undone {false};
+    //! true, if undone entities are detached
+    bool compacted {false};
+    //! entities taken out of their containers
+    std::vector<Detached> detached;
+    //! cached memoryUsage(), 0 if unknown
+    size_t memory {0};
 };
 
 #endif
@@ -0,0 +1,222 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#include "lc_fileimport.h"
+#include "rs_debug.h"
+#include "rs_fileio.h"
+#include "rs_graphic.h"
+
+namespace {
+//! minimum time between two imported() signals
+constexpr std::chrono::milliseconds importedInterval{250};
+//! longest time a visitor waits for the worker to pause
+constexpr std::chrono::milliseconds pauseTimeout{100};
+}
+
+LC_FileImport::Pause::Pause(LC_FileImport* import):
+	import(import)
+	,lock(import->dataMutex, std::defer_lock)
+{
+	++import->pauseRequests;
+	lock.try_lock_for(pauseTimeout);
+}
+
+LC_FileImport::Pause::~Pause()
+{
+	{
+		std::lock_guard<std::mutex> guard(import->pauseMutex);
+		--import->pauseRequests;
+	}
+	import->resumed.notify_all();
+}
+
+bool LC_FileImport::Pause::isPaused() const
+{
+	return lock.owns_lock();
+}
+
+LC_FileImport::LC_FileImport(QObject* parent):
+	QObject(parent)
+{}
+
+LC_FileImport::~LC_FileImport()
+{
+	cancel();
+	wait();
+}
+
+bool LC_FileImport::start(const QString& fileName, RS2::FormatType type)
+{
+	if (worker.joinable()) {
+		return false;
+	}
+	RS_DEBUG->print("LC_FileImport::start: %s", fileName.toLatin1().data());
+
+	this->fileName = fileName;
+	this->type = type;
+	// the graphic reads the settings, which must happen here
+	graphic.reset(new RS_Graphic());
+	graphic->newDoc();
+	cancelled = false;
+	success = false;
+	messages.clear();
+	visited.clear();
+	lastPercent = -1;
+	lastCount = graphic->count();
+	lastImported = std::chrono::steady_clock::now();
+
+	running = true;
+	worker = std::thread(&LC_FileImport::run, this);
+	return true;
+}
+
+void LC_FileImport::cancel()
+{
+	cancelled = true;
+}
+
+bool LC_FileImport::isCancelled() const
+{
+	return cancelled;
+}
+
+bool LC_FileImport::isRunning() const
+{
+	return running;
+}
+
+bool LC_FileImport::wait()
+{
+	if (worker.joinable()) {
+		worker.join();
+	}
+	return success;
+}
+
+const QString& LC_FileImport::getFileName() const
+{
+	return fileName;
+}
+
+QStringList LC_FileImport::getMessages() const
+{
+	return running ? QStringList() : messages;
+}
+
+bool LC_FileImport::takeGraphic(RS_Graphic& target)
+{
+	if (!wait() || !graphic) {
+		return false;
+	}
+	visited.clear();
+	target.takeImport(*graphic, fileName);
+	graphic.reset();
+	return true;
+}
+
+bool LC_FileImport::visitImported(const std::function<void(RS_Entity*)>& visitor, bool all)
+{
+	if (!graphic) {
+		return false;
+	}
+	Pause pause(this);
+	if (!pause.isPaused()) {
+		return false;
+	}
+	if (all) {
+		visited.clear();
+	}
+	for (RS_Entity* e: *graphic) {
+		if (visited.insert(e).second) {
+			visitor(e);
+		}
+	}
+	return true;
+}
+
+bool LC_FileImport::getImportedBorders(RS_Vector& vMin, RS_Vector& vMax)
+{
+	if (!graphic) {
+		return false;
+	}
+	Pause pause(this);
+	if (!pause.isPaused()) {
+		return false;
+	}
+	vMin = graphic->getMin();
+	vMax = graphic->getMax();
+	return vMin.valid && vMax.valid && vMin.x <= vMax.x && vMin.y <= vMax.y;
+}
+
+void LC_FileImport::run()
+{
+	std::unique_lock<std::timed_mutex> lock(dataMutex);
+	workerLock = &lock;
+
+	bool const ok = RS_FileIO::instance()->fileImport(*graphic, fileName, type,
+		[this](qint64 done, qint64 total) {
+			return reportProgress(done, total);
+		},
+		[this](const QString& message) {
+			messages << message;
+		});
+	success = ok && !cancelled;
+	RS_DEBUG->print("LC_FileImport::run: %s: %s", fileName.toLatin1().data(),
+					success ? "OK" : "failed");
+
+	workerLock = nullptr;
+	lock.unlock();
+	running = false;
+	emit finished(success);
+}
+
+bool LC_FileImport::reportProgress(qint64 done, qint64 total)
+{
+	int const percent = total > 0 ? int(100 * done / total) : 0;
+	if (percent != lastPercent) {
+		lastPercent = percent;
+		emit progress(percent);
+	}
+
+	auto const now = std::chrono::steady_clock::now();
+	if (graphic->count() != lastCount && now - lastImported >= importedInterval) {
+		lastCount = graphic->count();
+		lastImported = now;
+		emit imported();
+	}
+
+	// let visitors in, the graphic is consistent between records
+	if (pauseRequests > 0) {
+		workerLock->unlock();
+		{
+			std::unique_lock<std::mutex> guard(pauseMutex);
+			resumed.wait(guard, [this]() {
+				return pauseRequests == 0;
+			});
+		}
+		workerLock->lock();
+	}
+	return !cancelled;
+}
@@ -0,0 +1,164 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#ifndef LC_FILEIMPORT_H
+#define LC_FILEIMPORT_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <QObject>
+#include <QStringList>
+#include "rs.h"
+
+class RS_Entity;
+class RS_Graphic;
+class RS_Vector;
+
+/**
+ * \brief Imports a file on a worker thread.
+ *
+ * The file is read into a graphic of its own, which is moved into the
+ * target graphic by takeGraphic() once the import finished. Until then
+ * the entities imported so far can be visited, for showing the drawing
+ * while it is read: the worker pauses between records for visitors.
+ *
+ * Signals are emitted by the worker thread, receivers in other threads
+ * get them queued.
+ */
+class LC_FileImport: public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit LC_FileImport(QObject* parent = nullptr);
+	//! cancels the import and waits for the worker
+	~LC_FileImport() override;
+
+	/**
+	 * Starts importing fileName. Formats with experimental support are not
+	 * confirmed by the user, see RS_FileIO::confirmImport().
+	 *
+	 * @return false, if an import was started already
+	 */
+	bool start(const QString& fileName, RS2::FormatType type = RS2::FormatUnknown);
+	//! cancels the import, which then fails
+	void cancel();
+	bool isCancelled() const;
+	bool isRunning() const;
+
+	/**
+	 * Blocks until the import is finished.
+	 * @return true, if the file was imported
+	 */
+	bool wait();
+
+	const QString& getFileName() const;
+	//! messages of the import for the user, after it finished
+	QStringList getMessages() const;
+
+	/**
+	 * Moves the imported drawing into graphic, which is cleared first.
+	 * Waits for the import to finish.
+	 *
+	 * @return false, if the import failed, graphic is unchanged then
+	 */
+	bool takeGraphic(RS_Graphic& graphic);
+
+	/**
+	 * Calls visitor for the top level entities imported so far, which were
+	 * not visited before, or with all set for all of them. The import is
+	 * paused meanwhile, visitor must not modify the entities.
+	 *
+	 * @return false, if the worker did not pause in time, no entity was
+	 *         visited then
+	 */
+	bool visitImported(const std::function<void(RS_Entity*)>& visitor, bool all);
+
+	/**
+	 * Gets the borders of the entities imported so far.
+	 * @return false, if the worker did not pause in time or the borders
+	 *         are not valid yet
+	 */
+	bool getImportedBorders(RS_Vector& vMin, RS_Vector& vMax);
+
+signals:
+	void progress(int percent);
+	//! entities were imported since the last signal
+	void imported();
+	void finished(bool success);
+
+private:
+	/**
+	 * Pauses the worker while it exists, if the worker pauses in time.
+	 */
+	class Pause
+	{
+	public:
+		explicit Pause(LC_FileImport* import);
+		~Pause();
+		bool isPaused() const;
+
+	private:
+		LC_FileImport* import;
+		std::unique_lock<std::timed_mutex> lock;
+	};
+
+	void run();
+	//! called by the worker between records, false to cancel
+	bool reportProgress(qint64 done, qint64 total);
+
+	QString fileName;
+	RS2::FormatType type{RS2::FormatUnknown};
+	std::unique_ptr<RS_Graphic> graphic;
+	std::thread worker;
+
+	//! held by the worker while it imports, visitors take it while it pauses
+	std::timed_mutex dataMutex;
+	std::unique_lock<std::timed_mutex>* workerLock{nullptr};
+	std::mutex pauseMutex;
+	std::condition_variable resumed;
+	std::atomic<int> pauseRequests{0};
+
+	std::atomic<bool> cancelled{false};
+	std::atomic<bool> running{false};
+	bool success{false};
+	QStringList messages;
+
+	//! worker state for throttling the signals
+	int lastPercent{-1};
+	unsigned int lastCount{0};
+	std::chrono::steady_clock::time_point lastImported;
+
+	//! entities passed to visitors
+	std::unordered_set<RS_Entity*> visited;
+};
+
+#endif // LC_FILEIMPORT_H
@@ -50,6 +50,24 @@
  */
 bool RS_FileIO::fileImport(RS_Graphic& graphic, const QString& file,
         RS2::FormatType type) {
+    if (!confirmImport(file))
+        return false;
+    return fileImport(graphic, file, type, RS_FilterInterface::ProgressHandler(),
+                      RS_FilterInterface::MessageHandler());
+}
+
+/**
+ * Calls the import method of the filter responsible for the format
+ * of the given file.
+ *
+ * @param progress receives the progress, may cancel the import
+ * @param messages receives the messages for the user, the command line
+ *        if not set
+ */
+bool RS_FileIO::fileImport(RS_Graphic& graphic, const QString& file,
+        RS2::FormatType type,
+        const RS_FilterInterface::ProgressHandler& progress,
+        const RS_FilterInterface::MessageHandler& messages) {
 
     RS_DEBUG->print("Trying to import file '%s'...", file.toLatin1().data());
 
@@ -64,15 +82,8 @@ bool RS_FileIO::fileImport(RS_Graphic& graphic, const QString& file,
     if (RS2::FormatUnknown != t) {
 		std::unique_ptr<RS_FilterInterface>&& filter(getImportFilter(file, t));
 		if (filter){
-#ifdef DWGSUPPORT
-            if (file.endsWith(".dwg",Qt::CaseInsensitive)){
-                QMessageBox::StandardButton sel = QMessageBox::warning(qApp->activeWindow(), QObject::tr("Warning"),
-                                                  QObject::tr("experimental, save your work first.\nContinue?"),
-                                                  QMessageBox::Ok|QMessageBox::Cancel, QMessageBox::NoButton);
-                if (sel == QMessageBox::Cancel)
-                    return false;
-            }
-#endif
+            filter->setProgressHandler(progress);
+            filter->setMessageHandler(messages);
             return filter->fileImport(graphic, file, t);
         }
         RS_DEBUG->print(RS_Debug::D_WARNING,
@@ -88,6 +99,21 @@ bool RS_FileIO::fileImport(RS_Graphic& graphic, const QString& file,
     return false;
 }
 
+bool RS_FileIO::confirmImport(const QString& file) {
+#ifdef DWGSUPPORT
+    if (file.endsWith(".dwg",Qt::CaseInsensitive)){
+        QMessageBox::StandardButton sel = QMessageBox::warning(qApp->activeWindow(), QObject::tr("Warning"),
+                                          QObject::tr("experimental, save your work first.\nContinue?"),
+                                          QMessageBox::Ok|QMessageBox::Cancel, QMessageBox::NoButton);
+        if (sel == QMessageBox::Cancel)
+            return false;
+    }
+#else
+    Q_UNUSED(file)
+#endif
+    return true;
+}
+
 
 /** \brief extension2Type convert extension to file format type
  * \param file type
@@ -67,6 +67,20 @@ public:
 
     bool fileImport(RS_Graphic& graphic, const QString& file,
 		RS2::FormatType type = RS2::FormatUnknown);
+	/**
+	 * Imports file without asking the user, see confirmImport(). Safe to
+	 * call from a worker thread, as long as no other thread uses graphic.
+	 */
+	bool fileImport(RS_Graphic& graphic, const QString& file,
+		RS2::FormatType type,
+		const RS_FilterInterface::ProgressHandler& progress,
+		const RS_FilterInterface::MessageHandler& messages);
+	/**
+	 * Asks the user to confirm the import of a format with experimental
+	 * support. Must be called on the GUI thread.
+	 * @return false, if the user declined
+	 */
+	static bool confirmImport(const QString& file);
 		
     bool fileExport(RS_Graphic& graphic, const QString& file,
 		RS2::FormatType type = RS2::FormatUnknown);
@@ -133,7 +133,7 @@ bool RS_FilterDXFRW::fileImport(RS_Graphic& g, const QString& file, RS2::FormatT
             dwgr.setDebug(DRW::DEBUG);
         bool success = dwgr.read(this, true);
         RS_DEBUG->print("RS_FilterDXFRW::fileImport: reading DWG file: OK");
-        RS_DIALOGFACTORY->commandMessage(QObject::tr("Opened dwg file version %1.").arg(printDwgVersion(dwgr.getVersion())));
+        commandMessage(QObject::tr("Opened dwg file version %1.").arg(printDwgVersion(dwgr.getVersion())));
         int  lastError = dwgr.getError();
         if (success==false) {
             printDwgError(lastError);
@@ -169,6 +169,13 @@ bool RS_FilterDXFRW::fileImport(RS_Graphic& g, const QString& file, RS2::FormatT
     RS_DEBUG->print("RS_FilterDXFRW::fileImport: updating inserts");
     graphic->updateInserts();
 
+    const LC_LookupStats& layerStats = graphic->getLayerList()->getLookupStats();
+    const LC_LookupStats& blockStats = graphic->getBlockList()->getLookupStats();
+    RS_DEBUG->print("RS_FilterDXFRW::fileImport: layer lookups: %llu, found: %llu, names compared: %llu",
+                    layerStats.lookups, layerStats.hits, layerStats.comparisons);
+    RS_DEBUG->print("RS_FilterDXFRW::fileImport: block lookups: %llu, found: %llu, names compared: %llu",
+                    blockStats.lookups, blockStats.hits, blockStats.comparisons);
+
     RS_DEBUG->print("RS_FilterDXFRW::fileImport OK");
 
     return true;
@@ -1379,6 +1386,7 @@ bool RS_FilterDXFRW::fileExport(RS_Graphic& g, const QString& file, RS2::FormatT
     }
 
     dxfW = new dxfRW(QFile::encodeName(file));
+    dxfW->setBufferedWrite(bufferedWrite);
     bool success = dxfW->write(this, exportVersion, false); //ascii
 //    bool success = dxf->write(this, exportVersion, true); //binary
     delete dxfW;
@@ -1499,6 +1507,7 @@ void RS_FilterDXFRW::writeBlocks() {
         block.flags = 1;//flag for unnamed block
         dxfW->writeBlock(&block);
         RS_EntityContainer *ct = (RS_EntityContainer *)it.key();
+        ct->ensureUpdated();
         for (RS_Entity* e=ct->firstEntity(RS2::ResolveNone);
              e; e=ct->nextEntity(RS2::ResolveNone)) {
             if ( !(e->getFlag(RS2::FlagUndone)) ) {
@@ -3171,6 +3180,25 @@ void RS_FilterDXFRW::addPlotSettings(const DRW_PlotSettings *data) {
                         data->marginRight, data->marginBottom);
 }
 
+/**
+ * Passes the progress of reading on to the progress handler.
+ */
+bool RS_FilterDXFRW::progress(unsigned long long done, unsigned long long total) {
+    return reportProgress((qint64) done, (qint64) total);
+}
+
+/**
+ * Shows a message of the import on the command line or passes it on to
+ * the message handler, if any.
+ */
+void RS_FilterDXFRW::commandMessage(const QString& message) {
+    if (messageHandler) {
+        messageHandler(message);
+    } else {
+        RS_DIALOGFACTORY->commandMessage(message);
+    }
+}
+
 /**
  * Converts a line type name (e.g. "CONTINUOUS") into a RS2::LineType
  * object.
@@ -3961,51 +3989,51 @@ QString RS_FilterDXFRW::printDwgVersion(int v){
 void RS_FilterDXFRW::printDwgError(int le){
     switch (le) {
     case DRW::BAD_UNKNOWN:
-        RS_DIALOGFACTORY->commandMessage(QObject::tr("unknown error opening dwg file"));
+        commandMessage(QObject::tr("unknown error opening dwg file"));
         RS_DEBUG->print("RS_FilterDXFRW::printDwgError: DRW::BAD_UNKNOWN");
         break;
     case DRW::BAD_OPEN:
-        RS_DIALOGFACTORY->commandMessage(QObject::tr("can't open this dwg file"));
+        commandMessage(QObject::tr("can't open this dwg file"));
         RS_DEBUG->print("RS_FilterDXFRW::printDwgError: DRW::BAD_OPEN");
         break;
     case DRW::BAD_VERSION:
-        RS_DIALOGFACTORY->commandMessage(QObject::tr("unsupported dwg version"));
+        commandMessage(QObject::tr("unsupported dwg version"));
         RS_DEBUG->print("RS_FilterDXFRW::printDwgError: DRW::BAD_VERSION");
         break;
     case DRW::BAD_READ_METADATA:
-        RS_DIALOGFACTORY->commandMessage(QObject::tr("error reading file metadata in dwg file"));
+        commandMessage(QObject::tr("error reading file metadata in dwg file"));
         RS_DEBUG->print("RS_FilterDXFRW::printDwgError: DRW::BAD_READ_FILE_HEADER");
         break;
     case DRW::BAD_READ_FILE_HEADER:
-        RS_DIALOGFACTORY->commandMessage(QObject::tr("error reading file header in dwg file"));
+        commandMessage(QObject::tr("error reading file header in dwg file"));
         RS_DEBUG->print("RS_FilterDXFRW::printDwgError: DRW::BAD_READ_FILE_HEADER");
         break;
     case DRW::BAD_READ_HEADER:
-        RS_DIALOGFACTORY->commandMessage(QObject::tr("error reading header vars in dwg file"));
+        commandMessage(QObject::tr("error reading header vars in dwg file"));
         RS_DEBUG->print("RS_FilterDXFRW::printDwgError: DRW::BAD_READ_HEADER");
         break;
     case DRW::BAD_READ_CLASSES:
-        RS_DIALOGFACTORY->commandMessage(QObject::tr("error reading classes in dwg file"));
+        commandMessage(QObject::tr("error reading classes in dwg file"));
         RS_DEBUG->print("RS_FilterDXFRW::printDwgError: DRW::BAD_READ_CLASSES");
         break;
     case DRW::BAD_READ_HANDLES:
-        RS_DIALOGFACTORY->commandMessage(QObject::tr("error reading offsets in dwg file"));
+        commandMessage(QObject::tr("error reading offsets in dwg file"));
         RS_DEBUG->print("RS_FilterDXFRW::printDwgError: DRW::BAD_READ_OFFSETS");
         break;
     case DRW::BAD_READ_TABLES:
-        RS_DIALOGFACTORY->commandMessage(QObject::tr("error reading tables in dwg file"));
+        commandMessage(QObject::tr("error reading tables in dwg file"));
         RS_DEBUG->print("RS_FilterDXFRW::printDwgError: DRW::BAD_READ_TABLES");
         break;
     case DRW::BAD_READ_BLOCKS:
-        RS_DIALOGFACTORY->commandMessage(QObject::tr("error reading blocks in dwg file"));
+        commandMessage(QObject::tr("error reading blocks in dwg file"));
         RS_DEBUG->print("RS_FilterDXFRW::printDwgError: DRW::BAD_READ_OFFSETS");
         break;
     case DRW::BAD_READ_ENTITIES:
-        RS_DIALOGFACTORY->commandMessage(QObject::tr("error reading entities in dwg file"));
+        commandMessage(QObject::tr("error reading entities in dwg file"));
         RS_DEBUG->print("RS_FilterDXFRW::printDwgError: DRW::BAD_READ_ENTITIES");
         break;
     case DRW::BAD_READ_OBJECTS:
-        RS_DIALOGFACTORY->commandMessage(QObject::tr("error reading objects in dwg file"));
+        commandMessage(QObject::tr("error reading objects in dwg file"));
         RS_DEBUG->print("RS_FilterDXFRW::printDwgError: DRW::BAD_READ_OBJECTS");
         break;
     default:
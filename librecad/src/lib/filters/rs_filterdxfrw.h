@@ -124,8 +124,12 @@ public:
 
     virtual void addPlotSettings(const DRW_PlotSettings* data);
 
+    virtual bool progress(unsigned long long done, unsigned long long total);
+
     // Export:
     virtual bool fileExport(RS_Graphic& g, const QString& file, RS2::FormatType type);
+    /** Selects the buffered (default) or the plain ASCII DXF writer. */
+    void setBufferedWrite(bool b) {bufferedWrite = b;}
 
     virtual void writeHeader(DRW_Header& data);
     virtual void writeEntities();
@@ -195,6 +199,7 @@ public:
 private:
     void prepareBlocks();
     void writeEntity(RS_Entity* e);
+    void commandMessage(const QString& message);
 #ifdef DWGSUPPORT
     void printDwgError(int le);
     QString printDwgVersion(int v);
@@ -227,6 +232,8 @@ private:
     dxfRW *dxfW;
     /** If saved version are 2004 or above can save color in RGB value. */
     bool exactColor;
+    /** Write ASCII DXF through the buffered writer of libdxfrw. */
+    bool bufferedWrite {true};
     /** hash of block containers and handleBlock numbers to read dwg files */
     QHash<int, RS_EntityContainer*> blockHash;
     /** Pointer to entity container to store possible orphan entities like paper space */
@@ -28,6 +28,7 @@
 #ifndef RS_FILTERINTERFACE_H
 #define RS_FILTERINTERFACE_H
 
+#include <functional>
 #include "rs_graphic.h"
 
 /**
@@ -40,6 +41,16 @@
  */
 class RS_FilterInterface {
 public:
+    /**
+     * Receives the progress of an import, the work done so far out of
+     * total. Returns false to cancel the import.
+     */
+    typedef std::function<bool(qint64 done, qint64 total)> ProgressHandler;
+    /**
+     * Receives the messages of an import for the user.
+     */
+    typedef std::function<void(const QString& message)> MessageHandler;
+
     /**
      * Constructor.
      */
@@ -81,6 +92,33 @@ public:
     virtual bool fileExport(RS_Graphic& g, const QString& file, RS2::FormatType type) = 0;
 
     static RS_FilterInterface * createFilter(){return NULL;}
+
+    /**
+     * Sets the receiver of the import progress. Filters without progress
+     * reports ignore it.
+     */
+    void setProgressHandler(const ProgressHandler& handler) {
+        progressHandler = handler;
+    }
+
+    /**
+     * Sets the receiver of the messages of an import. Without one,
+     * messages go to the command line.
+     */
+    void setMessageHandler(const MessageHandler& handler) {
+        messageHandler = handler;
+    }
+
+protected:
+    /**
+     * @return false, if the import is to be cancelled
+     */
+    bool reportProgress(qint64 done, qint64 total) const {
+        return !progressHandler || progressHandler(done, total);
+    }
+
+    ProgressHandler progressHandler;
+    MessageHandler messageHandler;
 };
 
 #endif
@@ -0,0 +1,440 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <utility>
+
+#include <QApplication>
+#include <QEvent>
+#include <QPainter>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+
+#include "lc_tilerenderer.h"
+#include "lc_spatialindex.h"
+#include "rs_entitycontainer.h"
+#include "rs_graphic.h"
+#include "rs_graphicview.h"
+#include "rs_painterqt.h"
+#include "rs_units.h"
+
+namespace {
+//! tiles per worker thread, some slack for tiles with more entities
+constexpr int tilesPerThread = 2;
+//! margin in pixels around tiles, covers handles and antialiasing
+constexpr int tileMargin = 8;
+//! widest line width in mm, lines stick out of their borders by half of it
+constexpr double maxLineWidth = 2.11;
+
+/**
+ * @return true, if the receiver of event might change the view or a
+ * drawing, or draw entities itself
+ */
+bool interrupts(QObject* watched, const QEvent* event)
+{
+	const RS_GraphicView* watchedView = dynamic_cast<RS_GraphicView*>(watched);
+	switch (event->type()) {
+	case QEvent::Paint:
+		// views stop the renders of other views before they draw
+		// entities themselves, see LC_TileRenderer::interruptOthers()
+	case QEvent::UpdateRequest:
+	case QEvent::UpdateLater:
+	case QEvent::LayoutRequest:
+	case QEvent::Polish:
+	case QEvent::PolishRequest:
+		return false;
+	case QEvent::MouseMove:
+	case QEvent::HoverMove:
+	case QEvent::HoverEnter:
+	case QEvent::HoverLeave:
+	case QEvent::Enter:
+	case QEvent::Leave:
+	case QEvent::ToolTip:
+	case QEvent::StatusTip:
+		// views snap to the entities below the cursor
+		return watchedView != nullptr;
+	case QEvent::Timer:
+		// timers of widgets blink cursors or scroll, QTimer and other
+		// objects call slots
+		return watchedView || !watched->isWidgetType();
+	default:
+		return true;
+	}
+}
+}
+
+struct LC_TileRenderer::Job {
+	struct Tile {
+		size_t index;
+		QImage image;
+		//! false, if the render was cancelled while drawing the tile
+		bool complete;
+	};
+
+	//! collectTiles() drops the tiles of stopped renders
+	int generation = 0;
+	std::mutex mutex;
+	std::condition_variable changed;
+	std::vector<Tile> finished;
+	int pending = 0;
+};
+
+namespace {
+/**
+ * Draws the entities of one tile into an image of the tile's size.
+ */
+class TileTask: public QRunnable
+{
+public:
+	TileTask(RS_GraphicView* view, LC_TileRenderer* renderer,
+			 std::shared_ptr<LC_RenderGuard> guard,
+			 std::shared_ptr<LC_TileRenderer::Job> job,
+			 size_t index, const QRect& tile,
+			 std::vector<RS_Entity*>&& entities,
+			 bool antialiasing, RS2::DrawingMode mode):
+		view(view)
+	  ,renderer(renderer)
+	  ,guard(std::move(guard))
+	  ,job(std::move(job))
+	  ,index(index)
+	  ,tile(tile)
+	  ,entities(std::move(entities))
+	  ,antialiasing(antialiasing)
+	  ,mode(mode)
+	{}
+
+	void run() override
+	{
+		QImage image(tile.size(), QImage::Format_ARGB32_Premultiplied);
+		image.fill(Qt::transparent);
+		if (!guard->isCancelled()) {
+			RS_PainterQt painter(&image);
+			if (antialiasing) {
+				painter.setRenderHint(QPainter::Antialiasing);
+			}
+			painter.setDrawingMode(mode);
+			painter.setDrawSelectedOnly(false);
+			painter.setRenderGuard(guard.get());
+			painter.translate(-tile.x(), -tile.y());
+			view->drawSelectedLast(&painter, entities, guard.get());
+			painter.end();
+		}
+		bool const complete = !guard->isCancelled();
+
+		// the renderer waits for pending tiles before it is destroyed, so
+		// it exists until pending is decremented
+		std::lock_guard<std::mutex> lock(job->mutex);
+		job->finished.push_back({index, std::move(image), complete});
+		QMetaObject::invokeMethod(renderer, "collectTiles", Qt::QueuedConnection,
+								  Q_ARG(int, job->generation));
+		--job->pending;
+		job->changed.notify_all();
+	}
+
+private:
+	RS_GraphicView* view;
+	LC_TileRenderer* renderer;
+	std::shared_ptr<LC_RenderGuard> guard;
+	std::shared_ptr<LC_TileRenderer::Job> job;
+	size_t index;
+	QRect tile;
+	std::vector<RS_Entity*> entities;
+	bool antialiasing;
+	RS2::DrawingMode mode;
+};
+}
+
+//! locks shared by the renders of one drawing
+struct LC_RenderGuard::Locks {
+	std::array<std::mutex, lockCount> entities;
+};
+
+namespace {
+//! letters of fonts are shared by all drawings
+std::recursive_mutex blockLock;
+//! renderers of all views, used on the GUI thread only
+std::vector<LC_TileRenderer*> renderers;
+}
+
+LC_RenderGuard::LC_RenderGuard(const RS_EntityContainer* root):
+	root(root)
+  ,locks(locksOf(root))
+{}
+
+std::shared_ptr<LC_RenderGuard::Locks> LC_RenderGuard::locksOf(const RS_EntityContainer* root)
+{
+	static std::mutex mutex;
+	static std::map<const RS_EntityContainer*, std::weak_ptr<Locks>> shared;
+	std::lock_guard<std::mutex> lock(mutex);
+	for (auto it = shared.begin(); it != shared.end();) {
+		if (it->second.expired()) {
+			it = shared.erase(it);
+		} else {
+			++it;
+		}
+	}
+	std::shared_ptr<Locks> ret = shared[root].lock();
+	if (!ret) {
+		ret = std::make_shared<Locks>();
+		shared[root] = ret;
+	}
+	return ret;
+}
+
+void LC_RenderGuard::cancel()
+{
+	cancelled = true;
+	// waits for the entities being drawn, the workers check the flag
+	// with the lock of an entity held
+	for (std::mutex& m: locks->entities) {
+		std::lock_guard<std::mutex> lock(m);
+	}
+}
+
+bool LC_RenderGuard::isCancelled() const
+{
+	return cancelled;
+}
+
+std::unique_lock<std::mutex> LC_RenderGuard::lock(const RS_Entity* e)
+{
+	const RS_Entity* top = e;
+	while (top->getParent() && top->getParent() != root) {
+		top = top->getParent();
+	}
+	size_t const index = (reinterpret_cast<std::uintptr_t>(top) / sizeof(void*)) % lockCount;
+	return std::unique_lock<std::mutex>(locks->entities[index]);
+}
+
+std::unique_lock<std::recursive_mutex> LC_RenderGuard::lockBlocks()
+{
+	return std::unique_lock<std::recursive_mutex>(blockLock);
+}
+
+LC_TileRenderer::LC_TileRenderer(RS_GraphicView* view):
+	view(view)
+{
+	renderers.push_back(this);
+}
+
+LC_TileRenderer::~LC_TileRenderer()
+{
+	renderers.erase(std::find(renderers.begin(), renderers.end(), this));
+	stop();
+	// the workers of stopped renders call back into the renderer
+	for (auto const& stopped: draining) {
+		std::unique_lock<std::mutex> lock(stopped->mutex);
+		stopped->changed.wait(lock, [&stopped]() {
+			return stopped->pending == 0;
+		});
+	}
+}
+
+bool LC_TileRenderer::isUseful() const
+{
+	RS_EntityContainer* container = view->getContainer();
+	return container
+			&& QThread::idealThreadCount() > 1
+			&& (int) container->count() >= LC_SpatialIndex::minimumEntities()
+			&& view->getWidth() > 0 && view->getHeight() > 0;
+}
+
+bool LC_TileRenderer::isRunning() const
+{
+	return running;
+}
+
+const QImage& LC_TileRenderer::image() const
+{
+	return result;
+}
+
+std::vector<QRect> LC_TileRenderer::tiles() const
+{
+	int const w = view->getWidth();
+	int const h = view->getHeight();
+	int const count = tilesPerThread * std::max(QThread::idealThreadCount(), 1);
+
+	// tiles about square
+	int const columns = std::max(1, (int) std::lround(std::sqrt(double(count) * w / h)));
+	int const rows = std::max(1, (count + columns - 1) / columns);
+
+	std::vector<QRect> ret;
+	for (int r = 0; r < rows; ++r) {
+		for (int c = 0; c < columns; ++c) {
+			QRect const tile(QPoint(c * w / columns, r * h / rows),
+							 QPoint((c + 1) * w / columns - 1, (r + 1) * h / rows - 1));
+			if (tile.isValid()) {
+				ret.push_back(tile);
+			}
+		}
+	}
+	return ret;
+}
+
+void LC_TileRenderer::start(bool antialiasing, RS2::DrawingMode mode, bool resume)
+{
+	stop();
+
+	QPoint const currentOffset(view->getOffsetX(), view->getOffsetY());
+	QSize const size(view->getWidth(), view->getHeight());
+	resume = resume && factor.valid && factor == view->getFactor()
+			&& offset == currentOffset && result.size() == size
+			&& this->antialiasing == antialiasing && this->mode == mode;
+	if (!resume) {
+		factor = view->getFactor();
+		offset = currentOffset;
+		this->antialiasing = antialiasing;
+		this->mode = mode;
+		rects = tiles();
+		done.assign(rects.size(), false);
+		result = QImage(size, QImage::Format_ARGB32_Premultiplied);
+		result.fill(Qt::transparent);
+	}
+
+	draining.erase(std::remove_if(draining.begin(), draining.end(),
+								  [](const std::shared_ptr<Job>& stopped) {
+		std::lock_guard<std::mutex> lock(stopped->mutex);
+		return stopped->pending == 0;
+	}), draining.end());
+
+	RS_EntityContainer* container = view->getContainer();
+	guard = std::make_shared<LC_RenderGuard>(container);
+	job = std::make_shared<Job>();
+	job->generation = ++generation;
+	running = true;
+	qApp->installEventFilter(this);
+
+	// entities whose lines reach into a tile
+	double uf = 1.0;
+	if (RS_Graphic* graphic = container->getGraphic()) {
+		uf = RS_Units::convert(1.0, RS2::Millimeter, graphic->getUnit());
+	}
+	int const margin = tileMargin + (int) std::ceil(view->toGuiDX(maxLineWidth * uf) / 2.);
+
+	// look up all entities before any worker starts, the workers only
+	// read the entity tree
+	std::vector<std::pair<size_t, std::vector<RS_Entity*>>> entities;
+	for (size_t i = 0; i < rects.size(); ++i) {
+		if (done[i]) {
+			continue;
+		}
+		const QRect& tile = rects[i];
+		RS_Vector const v1 = view->toGraph(tile.left() - margin, tile.bottom() + 1 + margin);
+		RS_Vector const v2 = view->toGraph(tile.right() + 1 + margin, tile.top() - margin);
+		entities.emplace_back(i, container->getEntitiesInWindow(v1, v2));
+	}
+
+	job->pending = (int) entities.size();
+	for (auto& tile: entities) {
+		QThreadPool::globalInstance()->start(new TileTask(view, this, guard, job, tile.first,
+														  rects[tile.first], std::move(tile.second),
+														  antialiasing, mode));
+	}
+	if (entities.empty()) {
+		// all tiles were drawn before the render was interrupted
+		QMetaObject::invokeMethod(this, "collectTiles", Qt::QueuedConnection,
+								  Q_ARG(int, generation));
+	}
+}
+
+void LC_TileRenderer::stop()
+{
+	if (!running) {
+		return;
+	}
+	// no entity is drawn once cancel() returns, the workers skip the rest
+	// of their tiles in the background
+	guard->cancel();
+	if (!takeTiles()) {
+		draining.push_back(job);
+	}
+
+	running = false;
+	qApp->removeEventFilter(this);
+	guard.reset();
+	job.reset();
+}
+
+void LC_TileRenderer::interruptOthers(const LC_TileRenderer* renderer)
+{
+	for (LC_TileRenderer* other: renderers) {
+		if (other != renderer && other->isRunning()) {
+			other->stop();
+			emit other->interrupted();
+		}
+	}
+}
+
+bool LC_TileRenderer::takeTiles()
+{
+	std::vector<Job::Tile> finished;
+	bool complete = false;
+	{
+		std::lock_guard<std::mutex> lock(job->mutex);
+		finished = std::move(job->finished);
+		job->finished.clear();
+		complete = job->pending == 0;
+	}
+
+	QPainter painter(&result);
+	painter.setCompositionMode(QPainter::CompositionMode_Source);
+	for (const Job::Tile& tile: finished) {
+		if (tile.complete) {
+			painter.drawImage(rects[tile.index].topLeft(), tile.image);
+			done[tile.index] = true;
+		}
+	}
+	return complete;
+}
+
+void LC_TileRenderer::collectTiles(int generation)
+{
+	// calls queued by the workers of a stopped render are dropped
+	if (!running || generation != this->generation || !takeTiles()) {
+		return;
+	}
+	running = false;
+	qApp->removeEventFilter(this);
+	guard.reset();
+	job.reset();
+	emit finished();
+}
+
+bool LC_TileRenderer::eventFilter(QObject* watched, QEvent* event)
+{
+	// the queued calls of the workers go through
+	if (running && !qobject_cast<LC_TileRenderer*>(watched)
+			&& interrupts(watched, event)) {
+		stop();
+		emit interrupted();
+	}
+	return false;
+}
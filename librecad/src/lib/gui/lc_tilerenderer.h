@@ -0,0 +1,177 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#ifndef LC_TILERENDERER_H
+#define LC_TILERENDERER_H
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <QImage>
+#include <QObject>
+#include <QPoint>
+#include <QRect>
+#include "rs.h"
+#include "rs_vector.h"
+
+class QEvent;
+class RS_Entity;
+class RS_EntityContainer;
+class RS_GraphicView;
+
+/**
+ * \brief Guards the entity tree while worker threads draw it.
+ *
+ * Entities may update internal caches while they are drawn, so an entity
+ * of the drawing is never drawn by two threads at once: drawing locks the
+ * top level entity it belongs to. The locks are shared by the renders of
+ * all views of a drawing. The guard also carries the cancel flag of a
+ * render.
+ */
+class LC_RenderGuard
+{
+public:
+	explicit LC_RenderGuard(const RS_EntityContainer* root);
+
+	//! no entity is drawn by the workers anymore, once cancel() returns
+	void cancel();
+	bool isCancelled() const;
+
+	//! locks the top level entity of e for drawing
+	std::unique_lock<std::mutex> lock(const RS_Entity* e);
+	/**
+	 * Locks the entities of all blocks for drawing, they are shared by
+	 * instanced inserts and the letters of fonts by all drawings. Taken
+	 * with the lock of a top level entity held, never the other way round.
+	 */
+	std::unique_lock<std::recursive_mutex> lockBlocks();
+
+private:
+	static constexpr size_t lockCount = 64;
+	struct Locks;
+	//! locks of the renders of root, created on demand
+	static std::shared_ptr<Locks> locksOf(const RS_EntityContainer* root);
+
+	const RS_EntityContainer* root;
+	std::atomic<bool> cancelled{false};
+	std::shared_ptr<Locks> locks;
+};
+
+/**
+ * \brief Renders the drawing of a graphic view in parallel.
+ *
+ * The view is split into tiles, which are drawn into QImages on the
+ * threads of the global QThreadPool. The entities of every tile are
+ * looked up before the workers start, so the workers only read the
+ * entity tree. start() returns right away, the finished tiles are handed
+ * back to the GUI thread by queued calls and composited into image().
+ *
+ * The event loop keeps running meanwhile. Before an event, whose receiver
+ * might change the view or a drawing or draw entities itself, the render
+ * is stopped and interrupted() is emitted. Stopping waits for the entities
+ * being drawn only, the workers skip the rest of their tiles in the
+ * background. Finished tiles are kept, a render resumed for the same view
+ * only draws the missing tiles.
+ */
+class LC_TileRenderer: public QObject
+{
+	Q_OBJECT
+
+public:
+	//! tiles of one render, shared by the workers and the GUI thread
+	struct Job;
+
+	explicit LC_TileRenderer(RS_GraphicView* view);
+	//! stops the render in progress
+	~LC_TileRenderer() override;
+
+	//! true, if rendering in parallel is worthwhile for the view
+	bool isUseful() const;
+
+	/**
+	 * Starts drawing the entities of the view into image(), a render in
+	 * progress is stopped first. finished() is emitted once all tiles are
+	 * drawn.
+	 *
+	 * @param resume keep the tiles of an interrupted render of the same
+	 *        view, the caller knows that the drawing did not change since
+	 */
+	void start(bool antialiasing, RS2::DrawingMode mode, bool resume);
+	/**
+	 * Cancels the render in progress, if any. Returns once no worker
+	 * draws an entity, the tiles of the render finished later are dropped.
+	 */
+	void stop();
+	bool isRunning() const;
+	/**
+	 * Stops the renders of all other views and emits their interrupted().
+	 * Called before a view draws entities on the GUI thread, which would
+	 * race with the workers.
+	 */
+	static void interruptOthers(const LC_TileRenderer* renderer);
+
+	//! drawing of the last render, complete once finished() was emitted
+	const QImage& image() const;
+
+signals:
+	//! all tiles of the render are drawn into image()
+	void finished();
+	//! the render was stopped for an event, see start() for resuming it
+	void interrupted();
+
+protected:
+	bool eventFilter(QObject* watched, QEvent* event) override;
+
+private slots:
+	//! composites the tiles of the render generation into image()
+	void collectTiles(int generation);
+
+private:
+	std::vector<QRect> tiles() const;
+	//! moves the finished tiles of job into result, true if none is pending
+	bool takeTiles();
+
+	RS_GraphicView* view;
+	bool running = false;
+	//! counts the renders, see collectTiles()
+	int generation = 0;
+	std::shared_ptr<LC_RenderGuard> guard;
+	std::shared_ptr<Job> job;
+	//! stopped renders, whose workers are not done yet
+	std::vector<std::shared_ptr<Job>> draining;
+
+	//! view the tiles were drawn for
+	RS_Vector factor{false};
+	QPoint offset;
+	bool antialiasing = false;
+	RS2::DrawingMode mode = RS2::ModeFull;
+	std::vector<QRect> rects;
+	std::vector<bool> done;
+	QImage result;
+};
+
+#endif // LC_TILERENDERER_H
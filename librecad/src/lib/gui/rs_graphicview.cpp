@@ -27,6 +27,7 @@
 
 #include<climits>
 #include<cmath>
+#include<algorithm>
 
 #include <QApplication>
 #include <QDesktopWidget>
@@ -42,6 +43,7 @@
 #include "rs_graphic.h"
 #include "rs_grid.h"
 #include "rs_painter.h"
+#include "rs_insert.h"
 #include "rs_mtext.h"
 #include "rs_text.h"
 #include "rs_settings.h"
@@ -49,11 +51,50 @@
 #include "rs_layer.h"
 #include "rs_math.h"
 #include "rs_debug.h"
+#include "rs_units.h"
+#include "lc_spatialindex.h"
+#include "lc_tilerenderer.h"
 
 #ifdef EMU_C99
 #include "emu_c99.h"
 #endif
 
+namespace {
+//! dirty areas are aligned to tiles of this size in pixels
+constexpr int dirtyTileSize = 64;
+//! margin in pixels around dirty entities, covers handles and antialiasing
+constexpr int dirtyMargin = 8;
+//! above this number of dirty areas the whole drawing is redrawn
+constexpr int maxDirtyAreas = 32;
+
+/**
+ * Sets the pen width factor of a painter for the entities drawn within
+ * the scope, unless an outer scope did already.
+ */
+class PenWidthFactorScope {
+public:
+	PenWidthFactorScope(RS_Painter* painter, const RS_GraphicView* view):
+		painter(painter)
+	  , owner(painter->getPenWidthFactor() <= 0.)
+	{
+		if (owner) {
+			painter->setPenWidthFactor(view->getPenWidthFactor());
+		}
+	}
+
+	~PenWidthFactorScope()
+	{
+		if (owner) {
+			painter->setPenWidthFactor(0.);
+		}
+	}
+
+private:
+	RS_Painter* painter;
+	bool const owner;
+};
+}
+
 /**
  * Constructor.
  */
@@ -78,6 +119,13 @@ RS_GraphicView::RS_GraphicView(QWidget* parent, Qt::WindowFlags f)
     setHandleColor(QColor(RS_SETTINGS->readEntry("/handle", Colors::handle)));
     setEndHandleColor(QColor(RS_SETTINGS->readEntry("/end_handle", Colors::end_handle)));
     RS_SETTINGS->endGroup();
+
+    RS_SETTINGS->beginGroup("/Appearance");
+    setLodThresholds(RS_SETTINGS->readNumEntry("/LodThreshold", lodThreshold),
+                     RS_SETTINGS->readNumEntry("/LodHatchThreshold", hatchLodThreshold),
+                     RS_SETTINGS->readNumEntry("/LodTextThreshold", textLodThreshold));
+    RS_EntityContainer::setLazyUpdates(RS_SETTINGS->readNumEntry("/LazyRegeneration", 1));
+    RS_SETTINGS->endGroup();
 }
 
 RS_GraphicView::~RS_GraphicView()
@@ -358,7 +406,7 @@ void RS_GraphicView::zoomIn(double f, const RS_Vector& center) {
 	//adjustOffsetControls();
 	//adjustZoomControls();
 	// updateGrid();
-	redraw();
+	redraw(RS2::RedrawView);
 }
 
 
@@ -372,7 +420,7 @@ void RS_GraphicView::zoomInX(double f) {
 	adjustOffsetControls();
 	adjustZoomControls();
 	// updateGrid();
-	redraw();
+	redraw(RS2::RedrawView);
 }
 
 
@@ -386,7 +434,7 @@ void RS_GraphicView::zoomInY(double f) {
 	adjustOffsetControls();
 	adjustZoomControls();
 	//    updateGrid();
-	redraw();
+	redraw(RS2::RedrawView);
 }
 
 
@@ -419,7 +467,7 @@ void RS_GraphicView::zoomOutX(double f) {
 	adjustOffsetControls();
 	adjustZoomControls();
 	//    updateGrid();
-	redraw();
+	redraw(RS2::RedrawView);
 }
 
 
@@ -438,7 +486,7 @@ void RS_GraphicView::zoomOutY(double f) {
 	adjustOffsetControls();
 	adjustZoomControls();
 	//    updateGrid();
-	redraw();
+	redraw(RS2::RedrawView);
 }
 
 /**
@@ -750,7 +798,7 @@ void RS_GraphicView::zoomWindow(RS_Vector v1, RS_Vector v2,
 	adjustZoomControls();
 	//    updateGrid();
 
-	redraw();
+	redraw(RS2::RedrawView);
 }
 
 
@@ -769,7 +817,7 @@ void RS_GraphicView::zoomPan(int dx, int dy) {
 	//adjustZoomControls();
 	//    updateGrid();
 
-	redraw();
+	redraw(RS2::RedrawView);
 }
 
 
@@ -796,7 +844,7 @@ void RS_GraphicView::zoomScroll(RS2::Direction direction) {
 	adjustZoomControls();
 	//    updateGrid();
 
-	redraw();
+	redraw(RS2::RedrawView);
 }
 
 
@@ -927,7 +975,9 @@ void RS_GraphicView::drawLayer1(RS_Painter *painter) {
 
 void RS_GraphicView::drawLayer2(RS_Painter *painter)
 {
-	drawEntity(painter, container);	//	Draw all entities.
+	//	Draw all entities in a single run, selected entities are
+	//	collected and drawn on top of the others.
+	drawSelectedLast(painter, {container});
 
 	//	If not in print preview, draw the absolute zero reference.
 	//	----------------------------------------------------------
@@ -935,6 +985,138 @@ void RS_GraphicView::drawLayer2(RS_Painter *painter)
 		drawAbsoluteZero(painter);
 }
 
+/**
+ * Redraws the part of the drawing within area (screen coordinates).
+ * Only entities overlapping the area are drawn, clipped to the area.
+ * The area is expected to be cleared by the caller.
+ */
+void RS_GraphicView::drawLayer2(RS_Painter *painter, const QRect& area)
+{
+	painter->setClipRect(area.x(), area.y(), area.width(), area.height());
+
+	RS_Vector const v1 = toGraph(area.left(), area.bottom() + 1);
+	RS_Vector const v2 = toGraph(area.right() + 1, area.top());
+	drawSelectedLast(painter, container->getEntitiesInWindow(v1, v2));
+
+	if (!isPrintPreview())
+		drawAbsoluteZero(painter);
+
+	painter->resetClipping();
+}
+
+void RS_GraphicView::drawSelectedLast(RS_Painter* painter, const std::vector<RS_Entity*>& entities,
+									  LC_RenderGuard* guard)
+{
+	auto draw = [this, painter, guard](RS_Entity* e) {
+		if (guard) {
+			// checked with the lock held, see LC_RenderGuard::cancel()
+			auto lock = guard->lock(e);
+			if (guard->isCancelled()) {
+				return;
+			}
+			drawEntity(painter, e);
+		} else {
+			drawEntity(painter, e);
+		}
+	};
+
+	PenWidthFactorScope const penWidthFactor(painter, this);
+	std::vector<RS_Entity*>& deferred = painter->getDeferredEntities();
+	painter->setSelectionPass(RS_Painter::SelectionPass::CollectSelected);
+	deferred.clear();
+	for (RS_Entity* e: entities) {
+		draw(e);
+	}
+
+	painter->setSelectionPass(RS_Painter::SelectionPass::DrawDeferred);
+	for (RS_Entity* e: deferred) {
+		draw(e);
+	}
+	deferred.clear();
+	painter->setSelectionPass(RS_Painter::SelectionPass::None);
+}
+
+bool RS_GraphicView::addDirtyArea(RS_Entity* e)
+{
+	RS_Vector vMin, vMax;
+	if (!e || !container || !LC_SpatialIndex::getExtent(e, vMin, vMax)) {
+		return false;
+	}
+
+	// line width on screen, as in setPenForEntity()
+	double uf = 1.0;
+	if (RS_Graphic* graphic = container->getGraphic()) {
+		uf = RS_Units::convert(1.0, RS2::Millimeter, graphic->getUnit());
+	}
+	int const width = std::max(static_cast<int>(e->getPen(true).getWidth()), 0);
+	double const margin = dirtyMargin + toGuiDX(width / 100.0 * uf);
+
+	double const x1 = toGuiX(vMin.x) - margin;
+	double const x2 = toGuiX(vMax.x) + margin;
+	double const y1 = toGuiY(vMax.y) - margin;
+	double const y2 = toGuiY(vMin.y) + margin;
+	if (x2 < 0. || y2 < 0. || x1 > getWidth() || y1 > getHeight()) {
+		// not visible, nothing to redraw
+		return true;
+	}
+
+	return addDirtyArea(QRect(QPoint(int(std::max(x1, 0.)), int(std::max(y1, 0.))),
+							  QPoint(int(std::min(x2, double(getWidth()))),
+									 int(std::min(y2, double(getHeight()))))));
+}
+
+bool RS_GraphicView::addDirtyArea(const QRect& rect)
+{
+	QRect const view(0, 0, getWidth(), getHeight());
+	if (!rect.intersects(view)) {
+		return true;
+	}
+
+	auto tile = [](int v) {
+		return (v / dirtyTileSize) * dirtyTileSize;
+	};
+	QRect const visible = rect.intersected(view);
+	QRect area = QRect(QPoint(tile(visible.left()), tile(visible.top())),
+					   QPoint(tile(visible.right()) + dirtyTileSize - 1,
+							  tile(visible.bottom()) + dirtyTileSize - 1))
+			.intersected(view);
+
+	// merge overlapping areas, unless the merged area would cover much
+	// more than both, e.g. for the two strips uncovered by a diagonal pan.
+	// Overlapping areas are fine, each one is cleared and redrawn.
+	auto size = [](const QRect& r) {
+		return r.width() * r.height();
+	};
+	for (int i = 0; i < dirtyAreas.size(); ) {
+		QRect const& other = dirtyAreas.at(i);
+		QRect const merged = area.united(other);
+		if (other.intersects(area) && size(merged) <= size(area) + size(other)) {
+			dirtyAreas.removeAt(i);
+			area = merged;
+			i = 0;
+		} else {
+			++i;
+		}
+	}
+	dirtyAreas.append(area);
+
+	if (dirtyAreas.size() > maxDirtyAreas) {
+		return false;
+	}
+	int pixels = 0;
+	for (const QRect& r: dirtyAreas) {
+		pixels += size(r);
+	}
+	return 2 * pixels < view.width() * view.height();
+}
+
+QList<QRect> RS_GraphicView::takeDirtyAreas()
+{
+	QList<QRect> ret;
+	ret.swap(dirtyAreas);
+	return ret;
+}
+
 
 void RS_GraphicView::drawLayer3(RS_Painter *painter) {
 	// drawing zero points:
@@ -971,8 +1153,11 @@ void RS_GraphicView::setPenForEntity(RS_Painter *painter,RS_Entity *e)
 							   RS2::Width00, RS2::SolidLine));
 	}
 
-	// Getting pen from entity (or layer)
-	RS_Pen pen = e->getPen(true);
+	// Getting pen from entity (or layer), entities of instanced inserts
+	// are resolved as their copies in the insert would be
+	const RS_Painter::Instance* instance = painter->getInstance();
+	RS_Pen pen = instance ? RS_Insert::getInstancePen(e, instance->pen, instance->layer)
+						  : e->getResolvedPen();
 
 	int w = pen.getWidth();
 	if (w<0) {
@@ -987,23 +1172,14 @@ void RS_GraphicView::setPenForEntity(RS_Painter *painter,RS_Entity *e)
 	// ------------------------------------------------------------
 	if (!draftMode)
 	{
-		double	uf = 1.0;	// Unit factor.
-		double	wf = 1.0;	// Width factor.
-
-		RS_Graphic* graphic = container->getGraphic();
-
-        if (graphic)
+		// looked up once per paint, see drawSelectedLast()
+		double	factor = painter->getPenWidthFactor();
+		if (factor <= 0.)
 		{
-			uf = RS_Units::convert(1.0, RS2::Millimeter, graphic->getUnit());
-
-			if (	(isPrinting() || isPrintPreview()) &&
-					graphic->getPaperScale() > RS_TOLERANCE )
-			{
-				wf = 1.0 / graphic->getPaperScale();
-			}
+			factor = getPenWidthFactor();
 		}
 
-		pen.setScreenWidth(toGuiDX(w / 100.0 * uf * wf));
+		pen.setScreenWidth(toGuiDX(w * factor));
 	}
 	else
 	{
@@ -1043,13 +1219,13 @@ void RS_GraphicView::setPenForEntity(RS_Painter *painter,RS_Entity *e)
 	}
 
 	// this entity is selected:
-	if (e->isSelected()) {
+	if (e->isSelected() || (instance && instance->selected)) {
 		pen.setLineType(RS2::DotLine);
 		pen.setColor(selectedColor);
 	}
 
 	// this entity is highlighted:
-	if (e->isHighlighted()) {
+	if (e->isHighlighted() || (instance && instance->highlighted)) {
 		pen.setColor(highlightedColor);
 	}
 
@@ -1062,6 +1238,28 @@ void RS_GraphicView::setPenForEntity(RS_Painter *painter,RS_Entity *e)
 }
 
 
+double RS_GraphicView::getPenWidthFactor() const
+{
+	double	uf = 1.0;	// Unit factor.
+	double	wf = 1.0;	// Width factor.
+
+	RS_Graphic* graphic = container ? container->getGraphic() : nullptr;
+
+	if (graphic)
+	{
+		uf = RS_Units::convert(1.0, RS2::Millimeter, graphic->getUnit());
+
+		if (	(isPrinting() || isPrintPreview()) &&
+				graphic->getPaperScale() > RS_TOLERANCE )
+		{
+			wf = 1.0 / graphic->getPaperScale();
+		}
+	}
+
+	return uf * wf / 100.0;
+}
+
+
 /**
  * Draws an entity. Might be recursively called e.g. for polylines.
  * If the class wide painter is nullptr a new painter will be created
@@ -1071,23 +1269,22 @@ void RS_GraphicView::setPenForEntity(RS_Painter *painter,RS_Entity *e)
  *        lines e.g. in splines).
  * @param db Double buffering on (recommended) / off
  */
-void RS_GraphicView::drawEntity(RS_Entity* /*e*/, double& /*patternOffset*/) {
-	RS_DEBUG->print("RS_GraphicView::drawEntity(RS_Entity*,patternOffset) not supported anymore");
-	// RVT_PORT this needs to be optimized
-	// One way to do is to send a RS2::RedrawSelected, then the draw routine will only draw all selected entities
-	// Dis-advantage is that we still need to iterate over all entities, but
-	// this might be very fast
-	// For now we just redraw the drawing until we are going to optimize drawing
-	redraw(RS2::RedrawDrawing);
-}
-void RS_GraphicView::drawEntity(RS_Entity* /*e*/ /*patternOffset*/) {
-	RS_DEBUG->print("RS_GraphicView::drawEntity(RS_Entity*,patternOffset) not supported anymore");
-	// RVT_PORT this needs to be optimized
-	// One way to do is to send a RS2::RedrawSelected, then the draw routine will only draw all selected entities
-	// Dis-advantage is that we still need to iterate over all entities, but
-	// this might be very fast
-	// For now we just redraw the drawing until we are going to optimize drawing
-	redraw(RS2::RedrawDrawing);
+void RS_GraphicView::drawEntity(RS_Entity* e, double& /*patternOffset*/) {
+	drawEntity(e);
+}
+void RS_GraphicView::drawEntity(RS_Entity* e) {
+	// the whole drawing is redrawn after a bulk edit
+	if (isBulkEdit()) {
+		return;
+	}
+	// The entity is not drawn directly, the area it covers is marked
+	// dirty and redrawn with everything else in it on the next paint.
+	if (addDirtyArea(e)) {
+		redraw(RS2::RedrawDirtyAreas);
+	} else {
+		dirtyAreas.clear();
+		redraw(RS2::RedrawDrawing);
+	}
 }
 void RS_GraphicView::drawEntity(RS_Painter *painter, RS_Entity* e) {
 	double offset(0.);
@@ -1100,6 +1297,7 @@ void RS_GraphicView::drawEntity(RS_Painter *painter, RS_Entity* e, double& patte
 	if (!e) {
 		return;
 	}
+	PenWidthFactorScope const penWidthFactor(painter, this);
 
 	// entity is not visible:
 	if (!e->isVisible()) {
@@ -1112,8 +1310,9 @@ void RS_GraphicView::drawEntity(RS_Painter *painter, RS_Entity* e, double& patte
         return;
 	}
 
-    // test if the entity is in the viewport
-    if (!isPrinting() &&
+    // test if the entity is in the viewport, entities of instanced
+    // inserts are in block coordinates, the insert tests its cells
+    if (!isPrinting() && !painter->getInstance() &&
         e->rtti() != RS2::EntityGraphic &&
         e->rtti() != RS2::EntityLine &&
        (toGuiX(e->getMax().x)<0 || toGuiX(e->getMin().x)>getWidth() ||
@@ -1121,11 +1320,20 @@ void RS_GraphicView::drawEntity(RS_Painter *painter, RS_Entity* e, double& patte
         return;
     }
 
+	// selected entities are drawn later, no need to set their pen now
+	if (painter->getSelectionPass() == RS_Painter::SelectionPass::CollectSelected
+			&& e->isSelected()) {
+		painter->getDeferredEntities().push_back(e);
+		return;
+	}
+
 	// set pen (color):
 	setPenForEntity(painter, e );
 
 	//RS_DEBUG->print("draw plain");
-	if (isDraftMode()) {
+	if (drawReduced(painter, e)) {
+		// too small for details
+	} else if (isDraftMode()) {
         switch(e->rtti()){
         case RS2::EntityMText:
         case RS2::EntityText:
@@ -1184,7 +1392,7 @@ void RS_GraphicView::drawEntityPlain(RS_Painter *painter, RS_Entity* e, double&
 		return;
 	}
 
-	if (!e->isContainer() && (e->isSelected()!=painter->shouldDrawSelected())) {
+	if (!e->isContainer() && skipForSelection(painter, e)) {
 		return;
 	}
 
@@ -1196,24 +1404,98 @@ void RS_GraphicView::drawEntityPlain(RS_Painter *painter, RS_Entity* e) {
 		return;
 	}
 
-	if (!e->isContainer() && (e->isSelected()!=painter->shouldDrawSelected())) {
+	if (!e->isContainer() && skipForSelection(painter, e)) {
 		return;
 	}
 	double patternOffset(0.);
 	e->draw(painter, this, patternOffset);
 }
+
+bool RS_GraphicView::skipForSelection(RS_Painter* painter, RS_Entity* e) {
+	switch (painter->getSelectionPass()) {
+	case RS_Painter::SelectionPass::CollectSelected:
+		if (e->isSelected()) {
+			painter->getDeferredEntities().push_back(e);
+			return true;
+		}
+		return false;
+	case RS_Painter::SelectionPass::DrawDeferred:
+		return false;
+	default: {
+		const RS_Painter::Instance* instance = painter->getInstance();
+		bool const selected = e->isSelected() || (instance && instance->selected);
+		return selected!=painter->shouldDrawSelected();
+	}
+	}
+}
+
+bool RS_GraphicView::drawReduced(RS_Painter* painter, RS_Entity* e) {
+	if (isPrinting() || isPrintPreview()) {
+		return false;
+	}
+
+	int threshold = lodThreshold;
+	switch (e->rtti()) {
+	case RS2::EntityHatch:
+		threshold = hatchLodThreshold;
+		break;
+	case RS2::EntityText:
+	case RS2::EntityMText:
+		threshold = textLodThreshold;
+		break;
+	case RS2::EntityGraphic:
+	case RS2::EntityConstructionLine:
+	case RS2::EntityPoint:
+	case RS2::EntityLine:
+		// nothing to gain
+		return false;
+	default:
+		break;
+	}
+	if (threshold <= 0) {
+		return false;
+	}
+
+	RS_Vector const vMin = e->getMin();
+	RS_Vector const vMax = e->getMax();
+	if (vMin.x > vMax.x || vMin.y > vMax.y) {
+		return false;
+	}
+	double scale = 1.;
+	if (const RS_Painter::Instance* instance = painter->getInstance()) {
+		scale = instance->scale;
+	}
+	double const w = toGuiDX(vMax.x - vMin.x) * scale;
+	double const h = toGuiDY(vMax.y - vMin.y) * scale;
+	if (std::max(w, h) >= threshold) {
+		return false;
+	}
+
+	// containers are reduced as a whole
+	if (skipForSelection(painter, e)) {
+		return true;
+	}
+	// a patterned hatch gets the box as well, its pattern is noise at
+	// this size but the area stays visible
+	if (w < 1. && h < 1.) {
+		RS_Vector const c = toGui((vMin + vMax) * 0.5);
+		painter->drawLine(c, c + RS_Vector(1., 0.));
+	} else {
+		painter->drawRect(toGui(vMin), toGui(vMax));
+	}
+	return true;
+}
+
 /**
  * Deletes an entity with the background color.
  * Might be recursively called e.g. for polylines.
  */
 void RS_GraphicView::deleteEntity(RS_Entity* e) {
 
-	// RVT_PORT When we delete a single entity, we can do this but we need to remove this then also from containerEntities
-	RS_DEBUG->print("RS_GraphicView::deleteEntity will for now redraw the whole screen instead of just deleting the entity");
+	// marks the area covered by e before it gets removed or modified
 	setDeleteMode(true);
 	drawEntity(e);
 	setDeleteMode(false);
-	redraw(RS2::RedrawDrawing);
 }
 
 
@@ -1866,6 +2148,11 @@ bool RS_GraphicView::isPrinting() const{
 	return printing;
 }
 
+bool RS_GraphicView::isBulkEdit() const{
+	RS_Document* doc = container ? container->getDocument() : nullptr;
+	return doc && doc->isBulkEdit();
+}
+
 bool RS_GraphicView::isDraftMode() const{
 	return draftMode;
 }
@@ -1886,3 +2173,21 @@ bool RS_GraphicView::isPanning() const {
 void RS_GraphicView::setPanning(bool state) {
     panning = state;
 }
+
+void RS_GraphicView::setLodThresholds(int general, int hatch, int text) {
+	lodThreshold = std::max(general, 0);
+	hatchLodThreshold = std::max(hatch, 0);
+	textLodThreshold = std::max(text, 0);
+}
+
+int RS_GraphicView::getLodThreshold() const {
+	return lodThreshold;
+}
+
+int RS_GraphicView::getHatchLodThreshold() const {
+	return hatchLodThreshold;
+}
+
+int RS_GraphicView::getTextLodThreshold() const {
+	return textLodThreshold;
+}
@@ -36,6 +36,9 @@
 #include <QMap>
 #include <tuple>
 #include <memory>
+#include <QList>
+#include <QRect>
+#include <vector>
 #include <QAction>
 
 
@@ -45,6 +48,7 @@ class RS_ActionInterface;
 class RS_EventHandler;
 class RS_CommandEvent;
 class RS_Grid;
+class LC_RenderGuard;
 struct RS_LineTypePattern;
 
 
@@ -264,6 +268,7 @@ public:
 	virtual void drawWindow_DEPRECATED(RS_Vector v1, RS_Vector v2);
 	virtual void drawLayer1(RS_Painter *painter);
 	virtual void drawLayer2(RS_Painter *painter);
+	virtual void drawLayer2(RS_Painter *painter, const QRect& area);
 	virtual void drawLayer3(RS_Painter *painter);
 	virtual void deleteEntity(RS_Entity* e);
 	virtual void drawEntity(RS_Painter *painter, RS_Entity* e, double& patternOffset);
@@ -273,6 +278,11 @@ public:
 	virtual void drawEntityPlain(RS_Painter *painter, RS_Entity* e);
 	virtual void drawEntityPlain(RS_Painter *painter, RS_Entity* e, double& patternOffset);
 	virtual void setPenForEntity(RS_Painter *painter, RS_Entity* e );
+	/**
+	 * @return factor from pen widths (1/100 mm) to drawing units, pen
+	 * widths are scaled by the paper scale on print and print preview
+	 */
+	double getPenWidthFactor() const;
     virtual RS_Vector getMousePosition() const = 0;
 
 	virtual const RS_LineTypePattern* getPattern(RS2::LineType t);
@@ -355,6 +365,13 @@ public:
 		 */
 	bool isPrinting() const;
 
+	/**
+		 * @retval true The document of this view is in a bulk edit, the
+		 *         drawing is redrawn when it ends.
+		 * @retval false Otherwise.
+		 */
+	bool isBulkEdit() const;
+
 	/**
 		 * @retval true Draft mode is on for this view (all lines with 1 pixel / no style scaling).
 		 * @retval false Otherwise.
@@ -373,7 +390,37 @@ public:
     bool isPanning() const;
     void setPanning(bool state);
 
+	/**
+	 * Level of detail: entities with a screen extent below the threshold
+	 * (in pixels) are drawn as a dot or box only. Hatches and texts have
+	 * their own thresholds, 0 always draws in full detail.
+	 */
+	void setLodThresholds(int general, int hatch, int text);
+	int getLodThreshold() const;
+	int getHatchLodThreshold() const;
+	int getTextLodThreshold() const;
+
+	/**
+	 * @return the areas (screen coordinates) of the drawing to redraw
+	 * on RS2::RedrawDirtyAreas and clears them.
+	 */
+	QList<QRect> takeDirtyAreas();
+
+	/**
+	 * Draws entities of the drawing, selected ones on top of the others.
+	 * With a guard, as used by LC_TileRenderer on worker threads, drawing
+	 * stops once the guard is cancelled and every entity is drawn while
+	 * holding the guard's lock for it.
+	 */
+	void drawSelectedLast(RS_Painter* painter, const std::vector<RS_Entity*>& entities,
+						  LC_RenderGuard* guard = nullptr);
+
 protected:
+	/**
+	 * @brief addDirtyArea marks area (screen coordinates) for redrawing
+	 * @return false, if the whole drawing needs to be redrawn instead
+	 */
+	bool addDirtyArea(const QRect& area);
 
     RS_EntityContainer* container{nullptr}; // Holds a pointer to all the enties
     RS_EventHandler* eventHandler;
@@ -453,6 +500,34 @@ private:
 
     bool panning;
 
+	/**
+	 * @brief skipForSelection whether e is not to be drawn in the current pass,
+	 * selected entities are deferred when collecting
+	 */
+	bool skipForSelection(RS_Painter* painter, RS_Entity* e);
+
+	//! level of detail thresholds in pixels
+	int lodThreshold=0;
+	int hatchLodThreshold=0;
+	int textLodThreshold=4;
+	/**
+	 * @brief drawReduced draws e as a dot or box, if it is below
+	 * the level of detail threshold of its type
+	 * @return false, if e needs to be drawn in full detail
+	 */
+	bool drawReduced(RS_Painter* painter, RS_Entity* e);
+
+	/**
+	 * Areas of the drawing changed by drawEntity() and deleteEntity()
+	 * since the last redraw, aligned to tiles of the view.
+	 */
+	QList<QRect> dirtyAreas;
+	/**
+	 * @brief addDirtyArea marks the area covered by e for redrawing
+	 * @return false, if the whole drawing needs to be redrawn instead
+	 */
+	bool addDirtyArea(RS_Entity* e);
+
 signals:
     void relative_zero_changed(const RS_Vector&);
     void previous_zoom_state(bool);
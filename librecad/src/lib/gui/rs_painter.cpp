@@ -153,6 +153,37 @@ void RS_Painter::drawHandle(const RS_Vector& p, const RS_Color& c, int size) {
     fillRect((int)(p.x-size), (int)(p.y-size), 2*size, 2*size, c);
 }
 
+void RS_Painter::pushInstance(Instance instance) {
+	if (!instances.empty()) {
+		const Instance& outer = instances.back();
+		RS_Vector const axisX = outer.axisX*instance.axisX.x + outer.axisY*instance.axisX.y;
+		RS_Vector const axisY = outer.axisX*instance.axisY.x + outer.axisY*instance.axisY.y;
+		instance.origin = mapInstance(instance.origin);
+		instance.axisX = axisX;
+		instance.axisY = axisY;
+		instance.scale *= outer.scale;
+	}
+	instances.push_back(instance);
+	setInstanceTransform(&instances.back());
+}
+
+void RS_Painter::popInstance() {
+	instances.pop_back();
+	setInstanceTransform(instances.empty() ? nullptr : &instances.back());
+}
+
+const RS_Painter::Instance* RS_Painter::getInstance() const {
+	return instances.empty() ? nullptr : &instances.back();
+}
+
+RS_Vector RS_Painter::mapInstance(const RS_Vector& p) const {
+	if (instances.empty()) {
+		return p;
+	}
+	const Instance& i = instances.back();
+	return i.origin + i.axisX*p.x + i.axisY*p.y;
+}
+
 int RS_Painter::toScreenX(double x) const {
 	return RS_Math::round(offset.x + x);
 }
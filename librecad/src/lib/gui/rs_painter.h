@@ -28,10 +28,14 @@
 #ifndef RS_PAINTER_H
 #define RS_PAINTER_H
 
+#include <vector>
 #include "rs_vector.h"
+#include "rs_pen.h"
 
+class LC_RenderGuard;
 class RS_Color;
-class RS_Pen;
+class RS_Entity;
+class RS_Layer;
 class QPainterPath;
 class QRectF;
 class QPolygon;
@@ -73,6 +77,81 @@ public:
         return drawSelectedEntities;
     }
 
+    /**
+     * Passes for drawing the selected entities on top of all others in
+     * one run over the drawing, see RS_GraphicView::drawLayer2(). Kept
+     * with the painter, so several painters can draw at the same time.
+     */
+    enum class SelectionPass {
+        None,            //!< filter by shouldDrawSelected()
+        CollectSelected, //!< defer selected entities
+        DrawDeferred     //!< draw the deferred entities
+    };
+
+    void setSelectionPass(SelectionPass pass) {
+        selectionPass = pass;
+    }
+
+    SelectionPass getSelectionPass() const {
+        return selectionPass;
+    }
+
+    //! selected entities deferred in SelectionPass::CollectSelected
+    std::vector<RS_Entity*>& getDeferredEntities() {
+        return deferredEntities;
+    }
+
+    /**
+     * A block drawn for an instanced insert, see RS_Insert::draw(). The
+     * entities of the block are drawn in screen coordinates of the block,
+     * which the painter maps into the insert by
+     * p' = origin + p.x * axisX + p.y * axisY.
+     */
+    struct Instance {
+        RS_Vector origin;
+        RS_Vector axisX;
+        RS_Vector axisY;
+        //! length scale of the mapping
+        double scale = 1.;
+        //! resolved pen and layer of the insert
+        RS_Pen pen;
+        RS_Layer* layer = nullptr;
+        bool selected = false;
+        bool highlighted = false;
+    };
+
+    //! starts drawing an instance, within the current instance if any
+    void pushInstance(Instance instance);
+    void popInstance();
+    //! @return the innermost instance being drawn or nullptr
+    const Instance* getInstance() const;
+    //! maps coordinates of the innermost instance to the screen
+    RS_Vector mapInstance(const RS_Vector& p) const;
+
+    /**
+     * Guard of the render the painter is used for, if the drawing is
+     * rendered by several threads.
+     */
+    void setRenderGuard(LC_RenderGuard* guard) {
+        renderGuard = guard;
+    }
+
+    LC_RenderGuard* getRenderGuard() const {
+        return renderGuard;
+    }
+
+    /**
+     * Pen widths (1/100 mm) to drawing units, looked up once by the
+     * graphic view for all entities of a paint. 0 while not painting.
+     */
+    void setPenWidthFactor(double factor) {
+        penWidthFactor = factor;
+    }
+
+    double getPenWidthFactor() const {
+        return penWidthFactor;
+    }
+
     /**
      * @return Current drawing mode.
      */
@@ -153,6 +232,9 @@ public:
 	int toScreenY(double y) const;
 
 protected:
+    //! applies the mapping of instance, nullptr if no instance is drawn
+    virtual void setInstanceTransform(const Instance* /*instance*/) {}
+
     /**
      * Current drawing mode.
      */
@@ -165,6 +247,13 @@ protected:
     // When set to true, only selected entities should be drawn
     bool drawSelectedEntities;
 
+    SelectionPass selectionPass{SelectionPass::None};
+    std::vector<RS_Entity*> deferredEntities;
+
+    std::vector<Instance> instances;
+    LC_RenderGuard* renderGuard = nullptr;
+    double penWidthFactor = 0.;
+
 
 };
 
@@ -418,7 +418,8 @@ void RS_PainterQt::drawImg(QImage& img, const RS_Vector& pos,
     wm.translate(pos.x, pos.y);
     wm.rotate(RS_Math::rad2deg(-angle));
     wm.scale(factor.x, factor.y);
-    setWorldMatrix(wm);
+    // combined, the painter may be translated to a tile of the view
+    setWorldMatrix(wm, true);
 
 
     drawImage(0,-img.height(), img);
@@ -518,13 +519,35 @@ void RS_PainterQt::setPen(const RS_Pen& pen) {
     if (drawingMode==RS2::ModeBW) {
         lpen.setColor(RS_Color(0,0,0));
     }
-    QPen p(lpen.getColor(), RS_Math::round(lpen.getScreenWidth()),
+    // widths are in pixels, instances are drawn scaled
+    double width = RS_Math::round(lpen.getScreenWidth());
+    if (const Instance* instance = getInstance()) {
+        width /= instance->scale;
+    }
+    QPen p(lpen.getColor(), width,
 		   rsToQtLineType(lpen.getLineType()));
     p.setJoinStyle(Qt::RoundJoin);
     p.setCapStyle(Qt::RoundCap);
     QPainter::setPen(p);
 }
 
+void RS_PainterQt::setInstanceTransform(const Instance* instance) {
+    if (instance) {
+        if (!instanceTransformed) {
+            instanceBase = worldTransform();
+            instanceTransformed = true;
+        }
+        setWorldTransform(QTransform(instance->axisX.x, instance->axisX.y,
+                                     instance->axisY.x, instance->axisY.y,
+                                     instance->origin.x, instance->origin.y)
+                          * instanceBase);
+    } else if (instanceTransformed) {
+        setWorldTransform(instanceBase);
+        instanceTransformed = false;
+    }
+    setPen(lpen);
+}
+
 void RS_PainterQt::setPen(const RS_Color& color) {
     if (drawingMode==RS2::ModeBW) {
         lpen.setColor(RS_Color(0,0,0));
@@ -29,6 +29,7 @@
 #define RS_PAINTERQT_H
 
 #include <QPainter>
+#include <QTransform>
 
 #include "rs_painter.h"
 #include "rs_pen.h"
@@ -108,7 +109,12 @@ public:
     virtual void resetClipping();
 
 protected:
+    void setInstanceTransform(const Instance* instance) override;
+
     RS_Pen lpen;
+    //! world transformation before the first instance was drawn
+    QTransform instanceBase;
+    bool instanceTransformed = false;
     long rememberX; // Used for the moment because QPainter doesn't support moveTo anymore, thus we need to remember ourselves the moveTo positions
     long rememberY;
 };
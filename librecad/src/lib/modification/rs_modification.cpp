@@ -47,6 +47,7 @@
 #include "rs_debug.h"
 #include "rs_dialogfactory.h"
 #include "lc_undosection.h"
+#include "lc_undorecord.h"
 
 #ifdef EMU_C99
 #include "emu_c99.h"
@@ -167,7 +168,7 @@ bool RS_Modification::changeAttributes(
     }
 
     LC_UndoSection  undo(document);
-    QList<RS_Entity*> clones;
+    std::unique_ptr<LC_UndoAttributes> attributes(new LC_UndoAttributes);
     QSet<RS_Block*> blocks;
 
     for (auto en: *cont) {
@@ -179,11 +180,16 @@ bool RS_Modification::changeAttributes(
             blocks << bl;
         }
 
-        RS_Entity* cl = en->clone();
-        RS_Pen pen = cl->getPen(false);
+        RS_Pen const oldPen = en->getPen(false);
+        RS_Layer* const oldLayer = en->getLayer(false);
+        RS_Pen pen = oldPen;
+
+        if (graphicView) {
+            graphicView->deleteEntity(en);
+        }
 
         if (data.changeLayer==true) {
-            cl->setLayer(data.layer);
+            en->setLayer(data.layer);
         }
 
         if (data.changeColor==true) {
@@ -195,21 +201,18 @@ bool RS_Modification::changeAttributes(
         if (data.changeWidth==true) {
             pen.setWidth(data.pen.getWidth());
         }
-        cl->setPen(pen);
+        en->setPen(pen);
+        en->setSelected(false);
 
         if (graphicView) {
-            graphicView->deleteEntity(en);
+            graphicView->drawEntity(en);
         }
 
-        en->setSelected(false);
-        cl->setSelected(false);
-
-        clones << cl;
-
-        if (!graphic) continue;
+        attributes->addEntity(en, oldPen, oldLayer);
+    }
 
-        en->setUndoState(true);
-        graphic->addUndoable(en);
+    if (!attributes->isEmpty()) {
+        undo.addUndoRecord(attributes.release());
     }
 
     for (auto bl: blocks.values()) {
@@ -220,18 +223,6 @@ bool RS_Modification::changeAttributes(
         changeAttributes(data, (RS_EntityContainer*)bl);
     }
 
-    for (auto cl: clones) {
-        cont->addEntity(cl);
-
-        if (graphicView) {;
-            graphicView->drawEntity(cl);
-        }
-
-        if (graphic) {
-            graphic->addUndoable(cl);
-        }
-    }
-
     if (graphic) {
         graphic->updateInserts();
     }
@@ -1586,6 +1577,16 @@ bool RS_Modification::move(RS_MoveData& data) {
         return false;
     }
 
+    if (data.number==0) {
+        std::unique_ptr<LC_UndoTransform> transform(new LC_UndoTransform);
+        transform->move(data.offset);
+        // since 2.0.4.0: keep selection
+        if (transformSelected(std::move(transform), data.useCurrentLayer,
+                              data.useCurrentAttributes, true)) {
+            return true;
+        }
+    }
+
 	std::vector<RS_Entity*> addList;
 
     // Create new entities
@@ -1689,6 +1690,15 @@ bool RS_Modification::rotate(RS_RotateData& data) {
         return false;
     }
 
+    if (data.number==0) {
+        std::unique_ptr<LC_UndoTransform> transform(new LC_UndoTransform);
+        transform->rotate(data.center, data.angle);
+        if (transformSelected(std::move(transform), data.useCurrentLayer,
+                              data.useCurrentAttributes, false)) {
+            return true;
+        }
+    }
+
 	std::vector<RS_Entity*> addList;
 
     // Create new entities
@@ -1738,6 +1748,16 @@ bool RS_Modification::scale(RS_ScaleData& data) {
         return false;
     }
 
+    // non-isotropic scaling replaces circles and arcs, which needs clones
+    if (data.number==0 && fabs(data.factor.x - data.factor.y) <= RS_TOLERANCE) {
+        std::unique_ptr<LC_UndoTransform> transform(new LC_UndoTransform);
+        transform->scale(data.referencePoint, data.factor);
+        if (transformSelected(std::move(transform), data.useCurrentLayer,
+                              data.useCurrentAttributes, false)) {
+            return true;
+        }
+    }
+
 	std::vector<RS_Entity*> selectedList,addList;
 
 	for(auto ec: *container){
@@ -1817,6 +1837,15 @@ bool RS_Modification::mirror(RS_MirrorData& data) {
         return false;
     }
 
+    if (!data.copy) {
+        std::unique_ptr<LC_UndoTransform> transform(new LC_UndoTransform);
+        transform->mirror(data.axisPoint1, data.axisPoint2);
+        if (transformSelected(std::move(transform), data.useCurrentLayer,
+                              data.useCurrentAttributes, false)) {
+            return true;
+        }
+    }
+
 	std::vector<RS_Entity*> addList;
 
     // Create new entities
@@ -1865,6 +1894,18 @@ bool RS_Modification::rotate2(RS_Rotate2Data& data) {
         return false;
     }
 
+    if (data.number==0) {
+        std::unique_ptr<LC_UndoTransform> transform(new LC_UndoTransform);
+        transform->rotate(data.center1, data.angle1);
+        RS_Vector center2 = data.center2;
+        center2.rotate(data.center1, data.angle1);
+        transform->rotate(center2, data.angle2);
+        if (transformSelected(std::move(transform), data.useCurrentLayer,
+                              data.useCurrentAttributes, false)) {
+            return true;
+        }
+    }
+
 	std::vector<RS_Entity*> addList;
 
     // Create new entities
@@ -1918,6 +1959,16 @@ bool RS_Modification::moveRotate(RS_MoveRotateData& data) {
         return false;
     }
 
+    if (data.number==0) {
+        std::unique_ptr<LC_UndoTransform> transform(new LC_UndoTransform);
+        transform->move(data.offset);
+        transform->rotate(data.referencePoint + data.offset, data.angle);
+        if (transformSelected(std::move(transform), data.useCurrentLayer,
+                              data.useCurrentAttributes, false)) {
+            return true;
+        }
+    }
+
 	std::vector<RS_Entity*> addList;
 
     // Create new entities
@@ -2011,6 +2062,60 @@ void RS_Modification::deselectOriginals(bool remove)
 
 
 
+bool RS_Modification::transformSelected(std::unique_ptr<LC_UndoTransform> transform,
+                                        bool useCurrentLayer, bool useCurrentAttributes,
+                                        bool keepSelection)
+{
+    for (auto e: *container) {
+        if (e && e->isSelected()) {
+            if (!LC_UndoTransform::canRestore(e)) {
+                return false;
+            }
+            transform->addEntity(e);
+        }
+    }
+    if (transform->getEntities().empty()) {
+        return true;
+    }
+
+    LC_UndoSection undo( document, handleUndo);
+    transform->redo();
+
+    std::unique_ptr<LC_UndoAttributes> attributes;
+    if (useCurrentLayer || useCurrentAttributes) {
+        attributes.reset(new LC_UndoAttributes);
+    }
+    for (RS_Entity* e: transform->getEntities()) {
+        if (attributes) {
+            RS_Pen const oldPen = e->getPen(false);
+            RS_Layer* const oldLayer = e->getLayer(false);
+            if (useCurrentLayer) {
+                e->setLayerToActive();
+            }
+            if (useCurrentAttributes) {
+                e->setPenToActive();
+            }
+            attributes->addEntity(e, oldPen, oldLayer);
+            if (e->rtti()==RS2::EntityInsert) {
+                static_cast<RS_Insert*>(e)->update();
+            }
+        }
+        e->setSelected(keepSelection);
+    }
+
+    undo.addUndoRecord(transform.release());
+    if (attributes) {
+        undo.addUndoRecord(attributes.release());
+    }
+
+    if (graphicView) {
+        graphicView->redraw(RS2::RedrawDrawing);
+    }
+    return true;
+}
+
+
+
 /**
  * Adds the given entities to the container and draws the entities if
  * there's a graphic view available.
@@ -3028,6 +3133,39 @@ static void update_exploded_children_recursively(
 }
 
 
+/**
+ * Instanced inserts and texts hold no entities of their own (texts hold
+ * glyphs), creates them for ec and, if resolved, for the inserts and
+ * texts within ec.
+ */
+static void materialize_recursively(RS_EntityContainer* ec,
+        RS2::ResolveLevel rl) {
+
+    switch (ec->rtti()) {
+    case RS2::EntityInsert:
+        static_cast<RS_Insert*>(ec)->materialize();
+        break;
+    case RS2::EntityText:
+        static_cast<RS_Text*>(ec)->materialize();
+        break;
+    case RS2::EntityMText:
+        static_cast<RS_MText*>(ec)->materialize();
+        break;
+    default:
+        break;
+    }
+    ec->ensureUpdated();
+    if (rl==RS2::ResolveNone) {
+        return;
+    }
+    for (RS_Entity* e: *ec) {
+        if (e->isContainer()) {
+            materialize_recursively(static_cast<RS_EntityContainer*>(e), rl);
+        }
+    }
+}
+
+
 /**
  * Removes the selected entity containers and adds the entities in them as
  * new single entities.
@@ -3095,6 +3233,8 @@ bool RS_Modification::explode(const bool remove /*= true*/)
                     break;
                 }
 
+                materialize_recursively(ec, rl);
+
                 for (RS_Entity* e2 = ec->firstEntity(rl); e2;
                         e2 = ec->nextEntity(rl)) {
 
@@ -3189,6 +3329,9 @@ bool RS_Modification::explodeTextIntoLetters(RS_MText* text, std::vector<RS_Enti
 
     if(text->isLocked() || ! text->isVisible()) return false;
 
+    // letters as inserts of the letter blocks:
+    text->materialize();
+
     // iterate though lines:
 	for(auto e2: *text){
 
@@ -3253,6 +3396,9 @@ bool RS_Modification::explodeTextIntoLetters(RS_Text* text, std::vector<RS_Entit
 
     if(text->isLocked() || ! text->isVisible()) return false;
 
+    // letters as inserts of the letter blocks:
+    text->materialize();
+
     // iterate though letters:
 	for(auto e2: *text){
 
@@ -27,10 +27,12 @@
 #ifndef RS_MODIFICATION_H
 #define RS_MODIFICATION_H
 
+#include <memory>
 #include "rs_vector.h"
 #include "rs_pen.h"
 #include <QHash>
 
+class LC_UndoTransform;
 class RS_AtomicEntity;
 class RS_Entity;
 class RS_EntityContainer;
@@ -294,6 +296,15 @@ public:
 
 private:
     void deselectOriginals(bool remove);
+	/**
+	 * Transforms the selected entities in place. The undo cycle stores
+	 * the data of the entities instead of clones.
+	 * @return false, if an entity can't be restored in place and the
+	 * entities are left untouched, see LC_UndoTransform::canRestore()
+	 */
+	bool transformSelected(std::unique_ptr<LC_UndoTransform> transform,
+						   bool useCurrentLayer, bool useCurrentAttributes,
+						   bool keepSelection);
 	void addNewEntities(std::vector<RS_Entity*>& addList);
 	bool explodeTextIntoLetters(RS_MText* text, std::vector<RS_Entity*>& addList);
 	bool explodeTextIntoLetters(RS_Text* text, std::vector<RS_Entity*>& addList);
@@ -33,6 +33,40 @@
 #include "rs_graphic.h"
 #include "rs_layer.h"
 
+namespace {
+/**
+ * Whether line intersects an entity of ec. Sub-entities whose borders lie
+ * apart from the line are skipped, as long as their borders are kept up
+ * to date.
+ */
+bool isIntersected(const RS_Line& line, RS_EntityContainer* ec)
+{
+    RS_Vector const vLow = RS_Vector::minimum(line.getStartpoint(), line.getEndpoint());
+    RS_Vector const vHigh = RS_Vector::maximum(line.getStartpoint(), line.getEndpoint());
+
+    ec->ensureUpdated();
+    for (RS_Entity* e: *ec) {
+        bool const bordersValid = e->isVisible() && !e->isConstruction()
+                && !(e->getLayer() && e->getLayer()->isFrozen());
+        if (bordersValid
+                && (e->getMin().x > vHigh.x + RS_TOLERANCE
+                    || e->getMax().x < vLow.x - RS_TOLERANCE
+                    || e->getMin().y > vHigh.y + RS_TOLERANCE
+                    || e->getMax().y < vLow.y - RS_TOLERANCE)) {
+            continue;
+        }
+        if (e->isContainer()) {
+            if (isIntersected(line, static_cast<RS_EntityContainer*>(e))) {
+                return true;
+            }
+        } else if (RS_Information::getIntersection(&line, e, true).hasValid()) {
+            return true;
+        }
+    }
+    return false;
+}
+}
+
 
 
 /**
@@ -154,36 +188,20 @@ void RS_Selection::selectIntersected(const RS_Vector& v1, const RS_Vector& v2,
 	RS_Line line{v1, v2};
     bool inters;
 
-	for(auto e: *container){
-    //for (unsigned i=0; i<container->count(); ++i) {
-        //RS_Entity* e = container->entityAt(i);
+    // only entities overlapping the bounding box of the line can
+    // intersect it
+    RS_Vector const margin{RS_TOLERANCE, RS_TOLERANCE};
+    for (RS_Entity* e: container->getEntitiesInWindow(
+             RS_Vector::minimum(v1, v2) - margin,
+             RS_Vector::maximum(v1, v2) + margin)) {
 
         if (e && e->isVisible()) {
 
-            inters = false;
-
             // select containers / groups:
             if (e->isContainer()) {
-                RS_EntityContainer* ec = (RS_EntityContainer*)e;
-
-                for (RS_Entity* e2=ec->firstEntity(RS2::ResolveAll); e2;
-                        e2=ec->nextEntity(RS2::ResolveAll)) {
-
-                    RS_VectorSolutions sol =
-                        RS_Information::getIntersection(&line, e2, true);
-
-                    if (sol.hasValid()) {
-                        inters = true;
-                    }
-                }
+                inters = isIntersected(line, static_cast<RS_EntityContainer*>(e));
             } else {
-
-                RS_VectorSolutions sol =
-                    RS_Information::getIntersection(&line, e, true);
-
-                if (sol.hasValid()) {
-                    inters = true;
-                }
+                inters = RS_Information::getIntersection(&line, e, true).hasValid();
             }
 
             if (inters) {
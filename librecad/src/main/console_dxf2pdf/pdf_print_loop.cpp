@@ -26,6 +26,7 @@
 
 #include "rs.h"
 #include "rs_graphic.h"
+#include "lc_fileimport.h"
 #include "rs_painterqt.h"
 #include "lc_printing.h"
 #include "rs_staticgraphicview.h"
@@ -174,7 +175,13 @@ static bool openDocAndSetGraphic(RS_Document** doc, RS_Graphic** graphic,
 {
     *doc = new RS_Graphic();
 
-    if (!(*doc)->open(dxfFile, RS2::FormatUnknown)) {
+    // same import as the GUI, reads the file on a worker thread
+    LC_FileImport import;
+    import.start(dxfFile);
+    bool const success = import.takeGraphic(*static_cast<RS_Graphic*>(*doc));
+    for (const QString& message: import.getMessages())
+        qDebug() << message;
+    if (!success) {
         qDebug() << "ERROR: Failed to open document" << dxfFile;
         delete *doc;
         return false;
@@ -105,7 +105,7 @@
 #include "colorwizard.h"
 #include "lc_penwizard.h"
 #include "textfileviewer.h"
-#include "lc_undosection.h"
+#include "lc_bulkedit.h"
 
 #include <boost/version.hpp>
 
@@ -693,7 +693,8 @@ void QC_ApplicationWindow::execPlug() {
 //create document interface instance
     Doc_plugin_interface pligundoc(currdoc, w->getGraphicView(), this);
 //execute plugin
-    LC_UndoSection undo(currdoc);
+    // one undo step, updates and redraws are done once the plugin is finished
+    LC_BulkEdit bulkEdit(currdoc);
     plugin->execComm(&pligundoc, this, action->data().toString());
 //TODO call update view
 w->getGraphicView()->redraw();
@@ -794,6 +795,27 @@ void QC_ApplicationWindow::setUndoEnable(bool enable){
     }
 }
 
+/**
+ * Compacts the undo lists of all documents from the event loop. Undo
+ * cycles may end while a container is iterated, their undone entities
+ * can't be detached right away.
+ */
+void QC_ApplicationWindow::scheduleUndoCompaction(){
+    if (undoCompactionScheduled) return;
+    undoCompactionScheduled = true;
+    QTimer::singleShot(0, this, SLOT(slotCompactUndo()));
+}
+
+void QC_ApplicationWindow::slotCompactUndo(){
+    undoCompactionScheduled = false;
+    for (QMdiSubWindow* sw: mdiAreaCAD->subWindowList()) {
+        QC_MDIWindow* m = qobject_cast<QC_MDIWindow*>(sw);
+        if (m && m->getDocument()) {
+            m->getDocument()->compactUndone();
+        }
+    }
+}
+
 void QC_ApplicationWindow::setRedoEnable(bool enable){
     redoEnable=enable;
     if(redoButton){
@@ -849,6 +871,9 @@ void QC_ApplicationWindow::initSettings()
     settings.endGroup();
 
     a_map["ViewDraft"]->setChecked(settings.value("Appearance/DraftMode", 0).toBool());
+
+    RS_Undo::setLimits(settings.value("Defaults/MaxUndoSteps", 0).toInt(),
+                       settings.value("Defaults/MaxUndoMemory", 1024).toInt());
 }
 
 
@@ -1728,8 +1753,6 @@ void QC_ApplicationWindow::
 {
     RS_DEBUG->print("QC_ApplicationWindow::slotFileOpen(..)");
 
-    QSettings settings;
-
     QApplication::setOverrideCursor( QCursor(Qt::WaitCursor) );
 
     if ( QFileInfo(fileName).exists())
@@ -1766,10 +1789,14 @@ void QC_ApplicationWindow::
             maximized=activedMdiSubWindow->isMaximized();
         }
 
-        // open the file in the new view:
+        // open the file in the new view, in the background:
+        connect(w, SIGNAL(signalFileOpenProgress(QString,int)),
+                this, SLOT(slotFileOpenProgress(QString,int)));
+        connect(w, SIGNAL(signalFileOpened(QC_MDIWindow*,QString,bool,bool)),
+                this, SLOT(slotFileOpened(QC_MDIWindow*,QString,bool,bool)));
         bool success=false;
         if(QFileInfo(fileName).exists())
-            success=w->slotFileOpen(fileName, type);
+            success=w->startFileOpen(fileName, type);
         if (!success) {
                // error
                QApplication::restoreOverrideCursor();
@@ -1799,81 +1826,125 @@ void QC_ApplicationWindow::
                return;
         }
 
-		slotWindowActivated(w);
-
-        RS_DEBUG->print("QC_ApplicationWindow::slotFileOpen: open file: OK");
+        w->setWindowTitle(format_filename_caption(fileName) + "[*]");
+        statusBar()->showMessage(tr("Loading document: %1").arg(fileName));
+	} else {
+		QG_DIALOGFACTORY->commandMessage(tr("File '%1' does not exist. Opening aborted").arg(fileName));
+        statusBar()->showMessage(tr("Opening aborted"), 2000);
+    }
 
-        RS_DEBUG->print("QC_ApplicationWindow::slotFileOpen: update recent file menu: 1");
+    QApplication::restoreOverrideCursor();
+    RS_DEBUG->print("QC_ApplicationWindow::slotFileOpen(..) OK");
+}
 
-        // update recent files menu:
-        recentFiles->add(fileName);
-        openedFiles.push_back(fileName);
-        layerWidget->slotUpdateLayerList();
-        auto graphic = w->getGraphic();
-        if (graphic)
-        {
-            if (int objects_removed = graphic->clean())
-            {
-                auto msg = QObject::tr("Invalid objects removed:");
-                commandWidget->appendHistory(msg + " " + QString::number(objects_removed));
-            }
-            emit(gridChanged(graphic->isGridOn()));
-        }
+/**
+ * Shows the progress of opening a file in the status bar.
+ */
+void QC_ApplicationWindow::slotFileOpenProgress(const QString& fileName, int percent)
+{
+    statusBar()->showMessage(tr("Loading document: %1 (%2%)").arg(fileName).arg(percent));
+}
 
-        recentFiles->updateRecentFilesMenu();
+/**
+ * Called when opening a file in the background finished. Closes the
+ * window of the file again, if opening failed.
+ */
+void QC_ApplicationWindow::slotFileOpened(QC_MDIWindow* w, const QString& fileName,
+                                          bool success, bool cancelled)
+{
+    RS_DEBUG->print("QC_ApplicationWindow::slotFileOpened(..)");
 
-        RS_DEBUG->print("QC_ApplicationWindow::slotFileOpen: set caption");
+    QSettings settings;
 
+    if (!success) {
+        if (cancelled) {
+            statusBar()->showMessage(tr("Opening aborted"), 2000);
+        } else {
+            QString msg=tr("Cannot open the file\n%1\nPlease "
+                           "check its existence and permissions.")
+                    .arg(fileName);
+            commandWidget->appendHistory(msg);
+            statusBar()->clearMessage();
+            QMessageBox::information(this, QMessageBox::tr("Warning"),
+                                     msg,
+                                     QMessageBox::Ok);
+        }
+        //file opening failed, clean up QC_MDIWindow and QMdiSubWindow
+        if (window_list.contains(w))
+            doClose(w); //force closing, without asking user for confirmation
+        return;
+    }
 
-                /*	Format and set caption.
-                 *	----------------------- */
-        w->setWindowTitle(format_filename_caption(fileName) + "[*]");
+    if (mdiAreaCAD->activeSubWindow() == w) {
+        activedMdiSubWindow = nullptr; //to relink the widgets to the read document
+        slotWindowActivated(w);
+    }
 
-		if (mdiAreaCAD->viewMode() == QMdiArea::TabbedView) {
-			QList<QTabBar *> tabBarList = mdiAreaCAD->findChildren<QTabBar*>();
-			QTabBar *tabBar = tabBarList.at(0);
-			if (tabBar) {
-				tabBar->setExpanding(false);
-				tabBar->setTabToolTip(tabBar->currentIndex(), fileName);
-			}
-		}
-		else
-			doArrangeWindows(RS2::CurrentMode);
+    RS_DEBUG->print("QC_ApplicationWindow::slotFileOpened: open file: OK");
 
-		RS_SETTINGS->beginGroup("/CADPreferences");
-		if (RS_SETTINGS->readNumEntry("/AutoZoomDrawing"))
-			w->getGraphicView()->zoomAuto(false);
-		RS_SETTINGS->endGroup();
+    RS_DEBUG->print("QC_ApplicationWindow::slotFileOpened: update recent file menu: 1");
 
-        if (settings.value("Appearance/DraftMode", 0).toBool())
+    // update recent files menu:
+    recentFiles->add(fileName);
+    openedFiles.push_back(fileName);
+    layerWidget->slotUpdateLayerList();
+    auto graphic = w->getGraphic();
+    if (graphic)
+    {
+        if (int objects_removed = graphic->clean())
         {
-            QString draft_string = " ["+tr("Draft Mode")+"]";
-            w->getGraphicView()->setDraftMode(true);
-            w->getGraphicView()->redraw();
-            QString title = w->windowTitle();
-            w->setWindowTitle(title + draft_string);
+            auto msg = QObject::tr("Invalid objects removed:");
+            commandWidget->appendHistory(msg + " " + QString::number(objects_removed));
         }
+        emit(gridChanged(graphic->isGridOn()));
+    }
 
-        RS_DEBUG->print("QC_ApplicationWindow::slotFileOpen: set caption: OK");
+    recentFiles->updateRecentFilesMenu();
 
-        RS_DEBUG->print("QC_ApplicationWindow::slotFileOpen: update coordinate widget");
-        // update coordinate widget format:
-        RS_DIALOGFACTORY->updateCoordinateWidget(RS_Vector(0.0,0.0),
-                RS_Vector(0.0,0.0),
-                true);
-        RS_DEBUG->print("QC_ApplicationWindow::slotFileOpen: update coordinate widget: OK");
+    RS_DEBUG->print("QC_ApplicationWindow::slotFileOpened: set caption");
 
-        QString message=tr("Loaded document: ")+fileName;
-        commandWidget->appendHistory(message);
-        statusBar()->showMessage(message, 2000);
 
-	} else {
-		QG_DIALOGFACTORY->commandMessage(tr("File '%1' does not exist. Opening aborted").arg(fileName));
-        statusBar()->showMessage(tr("Opening aborted"), 2000);
+            /*	Format and set caption.
+             *	----------------------- */
+    w->setWindowTitle(format_filename_caption(fileName) + "[*]");
+
+	if (mdiAreaCAD->viewMode() == QMdiArea::TabbedView) {
+		QList<QTabBar *> tabBarList = mdiAreaCAD->findChildren<QTabBar*>();
+		QTabBar *tabBar = tabBarList.at(0);
+		if (tabBar) {
+			tabBar->setExpanding(false);
+			tabBar->setTabToolTip(tabBar->currentIndex(), fileName);
+		}
+	}
+	else
+		doArrangeWindows(RS2::CurrentMode);
+
+	RS_SETTINGS->beginGroup("/CADPreferences");
+	if (RS_SETTINGS->readNumEntry("/AutoZoomDrawing"))
+		w->getGraphicView()->zoomAuto(false);
+	RS_SETTINGS->endGroup();
+
+    if (settings.value("Appearance/DraftMode", 0).toBool())
+    {
+        QString draft_string = " ["+tr("Draft Mode")+"]";
+        w->getGraphicView()->setDraftMode(true);
+        w->getGraphicView()->redraw();
+        QString title = w->windowTitle();
+        w->setWindowTitle(title + draft_string);
     }
 
-    QApplication::restoreOverrideCursor();
-    RS_DEBUG->print("QC_ApplicationWindow::slotFileOpen(..) OK");
+    RS_DEBUG->print("QC_ApplicationWindow::slotFileOpened: set caption: OK");
+
+    RS_DEBUG->print("QC_ApplicationWindow::slotFileOpened: update coordinate widget");
+    // update coordinate widget format:
+    RS_DIALOGFACTORY->updateCoordinateWidget(RS_Vector(0.0,0.0),
+            RS_Vector(0.0,0.0),
+            true);
+    RS_DEBUG->print("QC_ApplicationWindow::slotFileOpened: update coordinate widget: OK");
+
+    QString message=tr("Loaded document: ")+fileName;
+    commandWidget->appendHistory(message);
+    statusBar()->showMessage(message, 2000);
 }
 
 void QC_ApplicationWindow::slotFileOpen(const QString& fileName) {
@@ -2769,6 +2840,14 @@ void QC_ApplicationWindow::slotOptionsGeneral() {
 
     RS_SETTINGS->beginGroup("/Appearance");
     int antialiasing = RS_SETTINGS->readNumEntry("/Antialiasing");
+    int lod = RS_SETTINGS->readNumEntry("/LodThreshold", 0);
+    int hatchLod = RS_SETTINGS->readNumEntry("/LodHatchThreshold", 0);
+    int textLod = RS_SETTINGS->readNumEntry("/LodTextThreshold", 4);
+    RS_SETTINGS->endGroup();
+
+    RS_SETTINGS->beginGroup("/Defaults");
+    RS_Undo::setLimits(RS_SETTINGS->readNumEntry("/MaxUndoSteps", 0),
+                       RS_SETTINGS->readNumEntry("/MaxUndoMemory", 1024));
     RS_SETTINGS->endGroup();
 
     QList<QMdiSubWindow*> windows = mdiAreaCAD->subWindowList();
@@ -2786,7 +2865,8 @@ void QC_ApplicationWindow::slotOptionsGeneral() {
                 gv->setHandleColor(handleColor);
                 gv->setEndHandleColor(endHandleColor);
                 gv->setAntialiasing(antialiasing?true:false);
-                gv->redraw(RS2::RedrawGrid);
+                gv->setLodThresholds(lod, hatchLod, textLod);
+                gv->redraw(RS2::RedrawAll);
             }
         }
     }
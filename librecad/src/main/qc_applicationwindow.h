@@ -92,6 +92,7 @@ public:
     virtual void keyPressEvent(QKeyEvent* e) override;
     void setRedoEnable(bool enable);
     void setUndoEnable(bool enable);
+    void scheduleUndoCompaction();
     bool loadStyleSheet(QString path);
 
     bool eventFilter(QObject *obj, QEvent *event) override;
@@ -147,6 +148,11 @@ public slots:
     void slotFileOpen(const QString& fileName, RS2::FormatType type);
     void slotFileOpen(const QString& fileName); // Assume Unknown type
     void slotFileOpenRecent(QAction* action);
+    /** shows the progress of opening a file in the background */
+    void slotFileOpenProgress(const QString& fileName, int percent);
+    /** finishes opening a file in the background */
+    void slotFileOpened(QC_MDIWindow* w, const QString& fileName,
+                        bool success, bool cancelled);
     /** saves a document */
     void slotFileSave();
     /** saves a document under a different filename*/
@@ -179,6 +185,8 @@ public slots:
     void slotViewStatusBar(bool toggle);
 
     void slotOptionsGeneral();
+    //! compacts the undo lists, see scheduleUndoCompaction()
+    void slotCompactUndo();
 
     void slotImportBlock();
 
@@ -398,6 +406,7 @@ private:
     bool previousZoomEnable{false};
     bool undoEnable{false};
     bool redoEnable{false};
+    bool undoCompactionScheduled{false};
 
     // --- Lists ---
     QList<QC_PluginInterface*> loadedPlugins;
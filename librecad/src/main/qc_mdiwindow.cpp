@@ -47,6 +47,9 @@
 #include "rs_pen.h"
 #include "qg_graphicview.h"
 #include "rs_debug.h"
+#include "rs_dialogfactory.h"
+#include "rs_fileio.h"
+#include "lc_fileimport.h"
 
 int QC_MDIWindow::idCounter = 0;
 
@@ -106,6 +109,7 @@ QC_MDIWindow::QC_MDIWindow(RS_Document* doc, QWidget* parent, Qt::WindowFlags wf
 QC_MDIWindow::~QC_MDIWindow()
 {
     RS_DEBUG->print("~QC_MDIWindow");
+    deleteFileImport();
 	if(!(graphicView && graphicView->isCleanUp())){
 
 		//do not clear layer/block lists, if application is being closed
@@ -359,6 +363,101 @@ bool QC_MDIWindow::slotFileOpen(const QString& fileName, RS2::FormatType type) {
     return ret;
 }
 
+/**
+ * Starts opening the given file in this MDI window. The file is read in the
+ * background while the view shows what was read so far.
+ * signalFileOpened() is emitted when done.
+ *
+ * @return false, if opening the file did not start
+ */
+bool QC_MDIWindow::startFileOpen(const QString& fileName, RS2::FormatType type) {
+
+    RS_DEBUG->print("QC_MDIWindow::startFileOpen");
+
+    if (!getGraphic() || fileName.isEmpty() || fileImport
+            || !RS_FileIO::confirmImport(fileName)) {
+        RS_DEBUG->print("QC_MDIWindow::startFileOpen: cancelled");
+        return false;
+    }
+    document->newDoc();
+
+    fileImport = new LC_FileImport(this);
+    connect(fileImport, SIGNAL(progress(int)), this, SLOT(slotFileImportProgress(int)));
+    connect(fileImport, SIGNAL(finished(bool)), this, SLOT(slotFileImportFinished(bool)));
+    if (!fileImport->start(fileName, type)) {
+        deleteFileImport();
+        return false;
+    }
+
+    // the document stays empty until the file is read
+    graphicView->setEnabled(false);
+    graphicView->setFileImport(fileImport);
+    return true;
+}
+
+/**
+ * Cancels opening a file in the background, signalFileOpened() is emitted
+ * with the import failed.
+ */
+void QC_MDIWindow::cancelFileOpen() {
+    if (fileImport) {
+        fileImport->cancel();
+    }
+}
+
+bool QC_MDIWindow::isFileOpening() const {
+    return fileImport != nullptr;
+}
+
+void QC_MDIWindow::slotFileImportProgress(int percent) {
+    if (fileImport) {
+        emit signalFileOpenProgress(fileImport->getFileName(), percent);
+    }
+}
+
+void QC_MDIWindow::slotFileImportFinished(bool success) {
+
+    RS_DEBUG->print("QC_MDIWindow::slotFileImportFinished");
+    if (!fileImport) return;
+
+    bool const cancelled = fileImport->isCancelled();
+    QString const fileName = fileImport->getFileName();
+    success = success && !cancelled && fileImport->takeGraphic(*getGraphic());
+    if (!cancelled) {
+        for (const QString& message: fileImport->getMessages()) {
+            RS_DIALOGFACTORY->commandMessage(message);
+        }
+    }
+    deleteFileImport();
+
+    if (success) {
+        if (fileName.endsWith(".lff") || fileName.endsWith(".cxf")) {
+            drawChars();
+            graphicView->zoomAuto(false);
+        } else
+            graphicView->redraw();
+    } else {
+        RS_DEBUG->print("QC_MDIWindow::slotFileImportFinished: failed");
+    }
+
+    emit signalFileOpened(this, fileName, success, cancelled);
+}
+
+/**
+ * Detaches the view from the file opened in the background and deletes the
+ * import, which cancels it if still running.
+ */
+void QC_MDIWindow::deleteFileImport() {
+    if (!fileImport) return;
+    if (graphicView) {
+        graphicView->setFileImport(nullptr);
+        graphicView->setEnabled(true);
+    }
+    fileImport->disconnect(this);
+    delete fileImport;
+    fileImport = nullptr;
+}
+
 void QC_MDIWindow::slotZoomAuto() {
 	if(graphicView){
         if(graphicView->isPrintPreview()){
@@ -410,6 +509,12 @@ bool QC_MDIWindow::slotFileSave(bool &cancelled, bool isAutoSave) {
     bool ret = false;
     cancelled = false;
 
+    if (fileImport) {
+        // nothing to save before the file is read
+        cancelled = true;
+        return true;
+    }
+
 	if (document) {
         document->setGraphicView(graphicView);
         if (isAutoSave) {
@@ -446,6 +551,11 @@ bool QC_MDIWindow::slotFileSaveAs(bool &cancelled) {
     cancelled = false;
     RS2::FormatType t = RS2::FormatDXFRW;
 
+    if (fileImport) {
+        cancelled = true;
+        return true;
+    }
+
     QG_FileDialog dlg(this);
     QString fn = dlg.getSaveFile(&t);
 	if (document && !fn.isEmpty()) {
@@ -40,6 +40,7 @@ class RS_Pen;
 class QMdiArea;
 class RS_EventHandler;
 class QCloseEvent;
+class LC_FileImport;
 
 /**
  * MDI document window. Contains a document and a view (window).
@@ -64,6 +65,8 @@ public slots:
     void slotFileNew();
     bool slotFileNewTemplate(const QString& fileName, RS2::FormatType type);
     bool slotFileOpen(const QString& fileName, RS2::FormatType type);
+    bool startFileOpen(const QString& fileName, RS2::FormatType type);
+    void cancelFileOpen();
     bool slotFileSave(bool &cancelled, bool isAutoSave=false);
     bool slotFileSaveAs(bool &cancelled);
     void slotFilePrint();
@@ -112,14 +115,29 @@ public:
 
     bool has_children();
 
+    /** @return true, while a file is opened in the background */
+    bool isFileOpening() const;
+
 signals:
     void signalClosing(QC_MDIWindow*);
+    void signalFileOpenProgress(const QString& fileName, int percent);
+    /**
+     * Emitted when opening a file in the background finished.
+     * The document is unchanged, if success is false.
+     */
+    void signalFileOpened(QC_MDIWindow*, const QString& fileName,
+                          bool success, bool cancelled);
 
 protected:
     void closeEvent(QCloseEvent*);
 
+private slots:
+    void slotFileImportProgress(int percent);
+    void slotFileImportFinished(bool success);
+
 private:
     void drawChars();
+    void deleteFileImport();
 
 private:
     /** window ID */
@@ -142,6 +160,8 @@ private:
      */
     QC_MDIWindow* parentWindow{nullptr};
     QMdiArea* cadMdiArea;
+    /** File opened in the background or NULL */
+    LC_FileImport* fileImport{nullptr};
 };
 
 
@@ -182,6 +182,7 @@ HEADERS += \
     lib/engine/rs_variable.h \
     lib/engine/rs_variabledict.h \
     lib/engine/rs_vector.h \
+    lib/fileio/lc_fileimport.h \
     lib/fileio/rs_fileio.h \
     lib/filters/rs_filtercxf.h \
     lib/filters/rs_filterdxfrw.h \
@@ -217,6 +218,17 @@ HEADERS += \
     actions/lc_actionfileexportmakercam.h \
     lib/engine/lc_rect.h \
     lib/engine/lc_undosection.h \
+    lib/engine/lc_bulkedit.h \
+    lib/engine/lc_undorecord.h \
+    lib/engine/lc_spatialindex.h \
+    lib/engine/lc_lookupstats.h \
+    lib/engine/lc_userdefvars.h \
+    lib/engine/lc_entitypool.h \
+    lib/engine/lc_regeneration.h \
+    lib/engine/lc_glyphcache.h \
+    lib/engine/lc_textglyph.h \
+    lib/engine/lc_hatchscanline.h \
+    lib/gui/lc_tilerenderer.h \
     lib/printing/lc_printing.h \
     actions/lc_actiondrawlinepolygon3.h \
     main/lc_application.h
@@ -274,6 +286,7 @@ SOURCES += \
     lib/engine/rs_utility.cpp \
     lib/engine/rs_variabledict.cpp \
     lib/engine/rs_vector.cpp \
+    lib/fileio/lc_fileimport.cpp \
     lib/fileio/rs_fileio.cpp \
     lib/filters/rs_filtercxf.cpp \
     lib/filters/rs_filterdxfrw.cpp \
@@ -307,6 +320,16 @@ SOURCES += \
     lib/engine/rs_flags.cpp \
     lib/engine/lc_rect.cpp \
     lib/engine/lc_undosection.cpp \
+    lib/engine/lc_bulkedit.cpp \
+    lib/engine/lc_undorecord.cpp \
+    lib/engine/lc_spatialindex.cpp \
+    lib/engine/lc_userdefvars.cpp \
+    lib/engine/lc_entitypool.cpp \
+    lib/engine/lc_regeneration.cpp \
+    lib/engine/lc_glyphcache.cpp \
+    lib/engine/lc_textglyph.cpp \
+    lib/engine/lc_hatchscanline.cpp \
+    lib/gui/lc_tilerenderer.cpp \
     lib/engine/rs.cpp \
     lib/printing/lc_printing.cpp \
     actions/lc_actiondrawlinepolygon3.cpp \
@@ -1,9 +1,23 @@
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 #include <fstream>
+#include <map>
+#include <random>
+#include <vector>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#include <QApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
 #include <QMenuBar>
+#include <QPointer>
 #include "lc_simpletests.h"
 #include "qc_applicationwindow.h"
+#include "qc_mdiwindow.h"
 #include "rs_graphic.h"
 #include "rs_math.h"
 #include "rs_arc.h"
@@ -26,6 +40,8 @@
 #include "rs_layer.h"
 #include "rs_graphicview.h"
 #include "rs_debug.h"
+#include "rs_filterdxfrw.h"
+#include "lc_entitypool.h"
 
 LC_SimpleTests::LC_SimpleTests(QWidget *parent):
 	QObject(parent)
@@ -109,6 +125,26 @@ LC_SimpleTests::LC_SimpleTests(QWidget *parent):
 		connect(action, SIGNAL(triggered()),
 				this, SLOT(slotTestResize1024()));
 		testMenu->addAction(action);
+
+		action = new QAction("Pen Cache", this);
+		connect(action, SIGNAL(triggered()),
+				this, SLOT(slotTestPenCache()));
+		testMenu->addAction(action);
+
+		action = new QAction("Intersection Cache", this);
+		connect(action, SIGNAL(triggered()),
+				this, SLOT(slotTestIntersectionCache()));
+		testMenu->addAction(action);
+
+		action = new QAction("Benchmark DXF Save", this);
+		connect(action, SIGNAL(triggered()),
+				this, SLOT(slotBenchmarkDxfSave()));
+		testMenu->addAction(action);
+
+		action = new QAction("Benchmark Entity Memory", this);
+		connect(action, SIGNAL(triggered()),
+				this, SLOT(slotBenchmarkEntityMemory()));
+		testMenu->addAction(action);
 }
 
 /**
@@ -968,6 +1004,9 @@ void LC_SimpleTests::slotTestUnicode() {
 	auto appWin= QC_ApplicationWindow::getAppWindow();
 
 	appWin->slotFileOpen("./fonts/unicode.cxf", RS2::FormatCXF);
+	// the file is read in the background
+	for (QPointer<QC_MDIWindow> w = appWin->getMDIWindow(); w && w->isFileOpening(); )
+		qApp->processEvents(QEventLoop::WaitForMoreEvents);
 	RS_Document* d =appWin->getDocument();
 	if (d) {
 		RS_Graphic* graphic = (RS_Graphic*)d;
@@ -1103,3 +1142,268 @@ void LC_SimpleTests::slotTestResize1024() {
 	QC_ApplicationWindow::getAppWindow()->update();
 	RS_DEBUG->print("%s\n: end\n", __func__);
 }
+
+/**
+ * Testing function: checks that the pens resolved for drawing are reused
+ * by the next redraw, and only resolved again for the entities affected
+ * by a change. Prints the results to stdout.
+ */
+void LC_SimpleTests::slotTestPenCache() {
+	RS_DEBUG->print("%s\n: begin\n", __func__);
+
+	RS_Graphic graphic;
+	graphic.addLayer(new RS_Layer("a"));
+	graphic.addLayer(new RS_Layer("b"));
+	RS_Pen const byLayer(RS_Color(RS2::FlagByLayer), RS2::WidthByLayer, RS2::LineByLayer);
+	RS_Pen const byBlock(RS_Color(RS2::FlagByBlock), RS2::WidthByBlock, RS2::LineByBlock);
+
+	auto addLine = [&byLayer](RS_EntityContainer* container, const QString& layer, double y) {
+		RS_Line* line = new RS_Line{container, {0., y}, {10., y}};
+		container->addEntity(line);
+		line->setLayer(layer);
+		line->setPen(byLayer);
+		return line;
+	};
+	std::vector<RS_Entity*> onA, onB;
+	for (int i=0; i<10; ++i) {
+		onA.push_back(addLine(&graphic, "a", i));
+		onB.push_back(addLine(&graphic, "b", i));
+	}
+	RS_Block* block = new RS_Block(&graphic, RS_BlockData("block", {0., 0.}, false));
+	graphic.addBlock(block);
+	RS_Entity* inBlock = addLine(block, "a", 0.);
+	inBlock->setPen(byBlock);
+
+	std::vector<RS_Entity*> all(onA);
+	all.insert(all.end(), onB.begin(), onB.end());
+	all.push_back(inBlock);
+	// resolves the pens as a redraw does, counts the pens which were kept
+	auto redraw = [&all]() {
+		size_t kept = 0;
+		for (RS_Entity* e: all) {
+			if (e->isResolvedPenCached()) ++kept;
+			e->getResolvedPen();
+		}
+		return kept;
+	};
+	auto check = [](const char* what, size_t kept, size_t expected) {
+		std::cout << "Pen Cache: " << what << ": " << kept << " of the pens kept, "
+				  << (kept == expected ? "ok" : "FAILED") << std::endl;
+	};
+
+	redraw();
+	check("second redraw", redraw(), all.size());
+	addLine(&graphic, "b", 10.);
+	check("entity added", redraw(), all.size());
+	graphic.findLayer("a")->setPen(RS_Pen(RS_Color(255, 0, 0), RS2::Width01, RS2::SolidLine));
+	// the line in the block is on layer a
+	check("pen of layer a set", redraw(), onB.size());
+	block->setPen(RS_Pen(RS_Color(0, 255, 0), RS2::Width02, RS2::DashLine));
+	check("pen of block set", redraw(), all.size() - 1);
+	onB.front()->setPen(RS_Pen(RS_Color(0, 0, 255), RS2::Width03, RS2::SolidLine));
+	check("pen of entity set", redraw(), all.size() - 1);
+	bool const upToDate = onB.front()->getResolvedPen().getColor() == RS_Color(0, 0, 255);
+	std::cout << "Pen Cache: resolved pen up to date: "
+			  << (upToDate ? "ok" : "FAILED") << std::endl;
+
+	RS_DEBUG->print("%s\n: end\n", __func__);
+}
+
+/**
+ * Testing function: checks that cached intersections follow in place
+ * edits of an entity and of the block of an insert.
+ */
+void LC_SimpleTests::slotTestIntersectionCache() {
+	RS_DEBUG->print("%s\n: begin\n", __func__);
+
+	RS_Graphic graphic;
+	graphic.addEntity(new RS_Line{&graphic, {0., 0.}, {20., 0.}});
+	RS_Line* crossing = new RS_Line{&graphic, {5., -5.}, {5., 5.}};
+	graphic.addEntity(crossing);
+	RS_Block* block = new RS_Block(&graphic, RS_BlockData("block", {0., 0.}, false));
+	graphic.addBlock(block);
+	RS_Line* inBlock = new RS_Line{block, {15., -5.}, {15., 5.}};
+	block->addEntity(inBlock);
+	RS_Insert* insert = new RS_Insert(&graphic,
+									  RS_InsertData("block", {0., 0.}, {1., 1.}, 0.,
+													1, 1, {0., 0.}, nullptr, RS2::NoUpdate));
+	graphic.addEntity(insert);
+	// intersections are cached with the copies of the block entities
+	insert->materialize();
+	insert->update();
+
+	// the horizontal line stays the closest entity
+	auto check = [&graphic](const char* what, const RS_Vector& coord, const RS_Vector& expected) {
+		RS_Vector const found = graphic.getNearestIntersection(coord, nullptr);
+		bool const ok = found.valid && found.distanceTo(expected) < RS_TOLERANCE;
+		std::cout << "Intersection Cache: " << what << ": " << found
+				  << (ok ? " ok" : " FAILED") << std::endl;
+	};
+
+	check("line", {6.9, 0.05}, {5., 0.});
+	crossing->move({2., 0.});
+	check("line moved in place", {6.9, 0.05}, {7., 0.});
+	check("insert", {12.9, 0.05}, {15., 0.});
+	inBlock->move({-2., 0.});
+	insert->update();
+	check("block edited in place", {12.9, 0.05}, {13., 0.});
+
+	RS_DEBUG->print("%s\n: end\n", __func__);
+}
+
+/**
+ * Benchmark: saves a synthetic drawing of lines, circles and arcs with
+ * random coordinates through the plain and the buffered ASCII DXF writer
+ * and prints the throughput to stdout.
+ */
+void LC_SimpleTests::slotBenchmarkDxfSave() {
+	RS_DEBUG->print("%s\n: begin\n", __func__);
+
+	const int count = 200000;
+	std::mt19937 gen(1);
+	auto rnd = [&gen](double a, double b) {
+		return std::uniform_real_distribution<double>(a, b)(gen);
+	};
+	RS_Graphic graphic;
+	for (int i=0; i<count; ++i) {
+		RS_Vector const p{rnd(-1e4, 1e4), rnd(-1e4, 1e4)};
+		switch (i % 4) {
+		case 0:
+			graphic.addEntity(new RS_Circle{&graphic, {p, rnd(0.1, 100.)}});
+			break;
+		case 1:
+			graphic.addEntity(new RS_Arc{&graphic, {p, rnd(0.1, 100.),
+											  rnd(0., M_PI), rnd(M_PI, 2.*M_PI), false}});
+			break;
+		default:
+			graphic.addEntity(new RS_Line{&graphic, p, p + RS_Vector{rnd(-100., 100.),
+																	 rnd(-100., 100.)}});
+		}
+	}
+
+	const QString file = QDir::temp().filePath("lc_benchmark_save.dxf");
+	for (bool buffered: {false, true}) {
+		// best of three runs
+		qint64 best = -1;
+		for (int run=0; run<3; ++run) {
+			RS_FilterDXFRW filter;
+			filter.setBufferedWrite(buffered);
+			QElapsedTimer timer;
+			timer.start();
+			if (!filter.fileExport(graphic, file, RS2::FormatDXFRW)) {
+				std::cout << "Benchmark DXF Save: can't write " << file.toStdString() << std::endl;
+				return;
+			}
+			qint64 const elapsed = timer.elapsed();
+			if (best < 0 || elapsed < best) best = elapsed;
+		}
+		double const mb = QFileInfo(file).size() / (1024. * 1024.);
+		std::cout << (buffered ? "buffered" : "plain   ") << " writer: "
+				  << count << " entities, " << mb << " MB in " << best << " ms, "
+				  << mb * 1000. / std::max<qint64>(best, 1) << " MB/s" << std::endl;
+	}
+	QFile::remove(file);
+	RS_DEBUG->print("%s\n: end\n", __func__);
+}
+
+namespace {
+//! bytes in use on the heap, -1 if unknown
+long long heapInUse() {
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+	struct mallinfo2 const info = mallinfo2();
+	return (long long) (info.uordblks + info.hblkhd);
+#elif defined(__GLIBC__)
+	struct mallinfo const info = mallinfo();
+	return (long long) info.uordblks + info.hblkhd;
+#else
+	return -1;
+#endif
+}
+
+//! RS_Entity's members around the user variables, before and after the compaction
+struct LegacyEntityVars {
+	bool updateEnabled;
+	std::map<QString, QString> varList;
+	unsigned long long penVersion;
+};
+struct CompactEntityVars {
+	bool updateEnabled;
+	LC_UserDefVars varList;
+	unsigned long long penVersion;
+};
+
+/**
+ * Bytes every entity took before the compaction: 3D borders (minV, maxV)
+ * and a std::map of user variables in every entity.
+ */
+std::size_t const legacyEntityExtra = 2 * (sizeof(RS_Vector) - 2 * sizeof(double))
+		+ sizeof(LegacyEntityVars) - sizeof(CompactEntityVars);
+
+/**
+ * Prints the bytes per entity before and after the compaction: count
+ * blocks of the old entity size from the general heap (as entities were
+ * allocated before LC_EntityPool) against count entities created through
+ * create from the pool. The pooled entities are appended to pooled and
+ * kept alive, so freed slots don't hide the cost of the next kind.
+ */
+template<class T, class Create>
+void measureEntityMemory(const char* name, int count, Create create,
+						 std::vector<RS_Entity*>& pooled) {
+	std::size_t const legacySize = sizeof(T) + legacyEntityExtra;
+	std::vector<void*> blocks;
+	blocks.reserve(count);
+
+	long long heapBefore = heapInUse();
+	for (int i=0; i<count; ++i)
+		blocks.push_back(::operator new(legacySize));
+	long long const legacy = heapInUse() - heapBefore;
+	for (void* p: blocks)
+		::operator delete(p);
+	blocks.clear();
+
+	std::size_t const reservedBefore = LC_EntityPool::reservedBytes();
+	heapBefore = heapInUse();
+	for (int i=0; i<count; ++i)
+		pooled.push_back(new T(create(i)));
+	long long const pool = heapInUse() - heapBefore;
+	std::size_t const reserved = LC_EntityPool::reservedBytes() - reservedBefore;
+
+	std::cout << name << ": sizeof " << legacySize << " -> " << sizeof(T)
+			  << ", slot " << LC_EntityPool::slotSize(sizeof(T)) << " bytes";
+	if (legacy >= 0) {
+		std::cout << ", heap " << double(legacy) / count << " -> "
+				  << double(pool) / count << " bytes/entity";
+	} else {
+		std::cout << ", pool chunks " << double(reserved) / count << " bytes/entity";
+	}
+	std::cout << std::endl;
+}
+}
+
+/**
+ * Benchmark: memory taken by lines, arcs and inserts in the old layout on
+ * the general heap and in the compact layout from the entity pool, printed
+ * to stdout. Heap usage is only known with glibc.
+ */
+void LC_SimpleTests::slotBenchmarkEntityMemory() {
+	RS_DEBUG->print("%s\n: begin\n", __func__);
+
+	const int count = 200000;
+	std::vector<RS_Entity*> pooled;
+	pooled.reserve(3 * count);
+
+	measureEntityMemory<RS_Line>("line  ", count, [](int i) {
+		return RS_Line{nullptr, {double(i), 0.}, {i + 1., 1.}};
+	}, pooled);
+	measureEntityMemory<RS_Arc>("arc   ", count, [](int i) {
+		return RS_Arc{nullptr, {{double(i), 0.}, 1., 0., M_PI, false}};
+	}, pooled);
+	measureEntityMemory<RS_Insert>("insert", count, [](int i) {
+		return RS_Insert{nullptr, {"block", {double(i), 0.}, {1., 1.}, 0.,
+								   1, 1, {0., 0.}, nullptr, RS2::NoUpdate}};
+	}, pooled);
+
+	for (RS_Entity* e: pooled)
+		delete e;
+	RS_DEBUG->print("%s\n: end\n", __func__);
+}
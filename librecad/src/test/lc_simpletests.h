@@ -42,5 +42,13 @@ public slots:
 	void slotTestResize800();
 	/** resizes window to 640x480 for screen shots */
 	void slotTestResize1024();
+	/** checks that resolved pens are kept across redraws */
+	void slotTestPenCache();
+	/** checks that cached intersections follow in place edits */
+	void slotTestIntersectionCache();
+	/** compares DXF save throughput of the buffered and the plain writer */
+	void slotBenchmarkDxfSave();
+	/** compares the memory of entities from the heap and the entity pool */
+	void slotBenchmarkEntityMemory();
 };
 #endif // LC_SIMPLETESTS_H
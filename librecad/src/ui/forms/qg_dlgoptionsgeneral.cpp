@@ -139,6 +139,11 @@ void QG_DlgOptionsGeneral::init()
     // preview:
 	initComboBox(cbMaxPreview, RS_SETTINGS->readEntry("/MaxPreview", "100"));
 
+    // level of detail:
+    sbLodThreshold->setValue(RS_SETTINGS->readNumEntry("/LodThreshold", 0));
+    sbHatchLodThreshold->setValue(RS_SETTINGS->readNumEntry("/LodHatchThreshold", 0));
+    sbTextLodThreshold->setValue(RS_SETTINGS->readNumEntry("/LodTextThreshold", 4));
+
     RS_SETTINGS->endGroup();
 
     RS_SETTINGS->beginGroup("Colors");
@@ -178,6 +183,9 @@ void QG_DlgOptionsGeneral::init()
     cbUnit->setCurrentIndex( cbUnit->findText(QObject::tr( RS_SETTINGS->readEntry("/Unit", def_unit).toUtf8().data() )) );
     // Auto save timer
     cbAutoSaveTime->setValue(RS_SETTINGS->readNumEntry("/AutoSaveTime", 5));
+    // undo limits
+    sbMaxUndoSteps->setValue(RS_SETTINGS->readNumEntry("/MaxUndoSteps", 0));
+    sbMaxUndoMemory->setValue(RS_SETTINGS->readNumEntry("/MaxUndoMemory", 1024));
     cbAutoBackup->setChecked(RS_SETTINGS->readNumEntry("/AutoBackupDocument", 1));
     cbUseQtFileOpenDialog->setChecked(RS_SETTINGS->readNumEntry("/UseQtFileOpenDialog", 1));
     cbWheelScrollInvertH->setChecked(RS_SETTINGS->readNumEntry("/WheelScrollInvertH", 0));
@@ -251,6 +259,9 @@ void QG_DlgOptionsGeneral::ok()
         RS_SETTINGS->writeEntry("/cursor_hiding", cursor_hiding_checkbox->isChecked());
         RS_SETTINGS->writeEntry("/Antialiasing", cb_antialiasing->isChecked()?1:0);
         RS_SETTINGS->writeEntry("/ScrollBars", scrollbars_check_box->isChecked()?1:0);
+        RS_SETTINGS->writeEntry("/LodThreshold", sbLodThreshold->value());
+        RS_SETTINGS->writeEntry("/LodHatchThreshold", sbHatchLodThreshold->value());
+        RS_SETTINGS->writeEntry("/LodTextThreshold", sbTextLodThreshold->value());
         RS_SETTINGS->endGroup();
 
         RS_SETTINGS->beginGroup("Colors");
@@ -278,6 +289,8 @@ void QG_DlgOptionsGeneral::ok()
         RS_SETTINGS->writeEntry("/Unit",
             RS_Units::unitToString( RS_Units::stringToUnit( cbUnit->currentText() ), false/*untr.*/) );
         RS_SETTINGS->writeEntry("/AutoSaveTime", cbAutoSaveTime->value() );
+        RS_SETTINGS->writeEntry("/MaxUndoSteps", sbMaxUndoSteps->value());
+        RS_SETTINGS->writeEntry("/MaxUndoMemory", sbMaxUndoMemory->value());
         RS_SETTINGS->writeEntry("/AutoBackupDocument", cbAutoBackup->isChecked() ? 1 : 0);
         RS_SETTINGS->writeEntry("/UseQtFileOpenDialog", cbUseQtFileOpenDialog->isChecked() ? 1 : 0);
         RS_SETTINGS->writeEntry("/WheelScrollInvertH", cbWheelScrollInvertH->isChecked() ? 1 : 0);
@@ -31,6 +31,9 @@
 #include <QMenu>
 #include <QDebug>
 #include <QNativeGestureEvent>
+#include <QTimer>
+
+#include <cstdlib>
 
 #include "rs_actionzoomin.h"
 #include "rs_actionzoompan.h"
@@ -50,6 +53,8 @@
 #include "rs_modification.h"
 #include "rs_debug.h"
 #include "rs_graphic.h"
+#include "lc_tilerenderer.h"
+#include "lc_fileimport.h"
 
 #ifdef Q_OS_WIN32
 #define CURSOR_SIZE 16
@@ -68,6 +73,7 @@ QG_GraphicView::QG_GraphicView(QWidget* parent, Qt::WindowFlags f, RS_Document*
     ,curSelect(new QCursor(QPixmap(":ui/cur_select_bmp.png"), CURSOR_SIZE, CURSOR_SIZE))
     ,curMagnifier(new QCursor(QPixmap(":ui/cur_glass_bmp.png"), CURSOR_SIZE, CURSOR_SIZE))
     ,curHand(new QCursor(QPixmap(":ui/cur_hand_bmp.png"), CURSOR_SIZE, CURSOR_SIZE))
+    ,tileRenderer(new LC_TileRenderer(this))
     ,redrawMethod(RS2::RedrawAll)
     ,isSmoothScrolling(false)
 {
@@ -90,6 +96,13 @@ QG_GraphicView::QG_GraphicView(QWidget* parent, Qt::WindowFlags f, RS_Document*
     // SourceForge issue 45 (Left-mouse drag shrinks window)
     setAttribute(Qt::WA_NoMousePropagation);
 
+    zoomTimer = new QTimer(this);
+    zoomTimer->setSingleShot(true);
+    zoomTimer->setInterval(150);
+    connect(zoomTimer, SIGNAL(timeout()), this, SLOT(slotRefineZoom()));
+    connect(tileRenderer.get(), SIGNAL(finished()), this, SLOT(slotRenderFinished()));
+    connect(tileRenderer.get(), SIGNAL(interrupted()), this, SLOT(slotRenderInterrupted()));
+
     view_rect = LC_Rect(toGraph(0, 0), toGraph(getWidth(), getHeight()));
 }
 
@@ -99,6 +112,8 @@ QG_GraphicView::QG_GraphicView(QWidget* parent, Qt::WindowFlags f, RS_Document*
  * Destructor
  */
 QG_GraphicView::~QG_GraphicView() {
+	// waits for the workers of stopped renders as well
+	tileRenderer.reset();
 	cleanUp();
 }
 
@@ -237,6 +252,13 @@ void QG_GraphicView::updateGridStatusWidget(const QString& text)
  * Redraws the widget.
  */
 void QG_GraphicView::redraw(RS2::RedrawMethod method) {
+        if (isBulkEdit()) {
+            // changes of the drawing are redrawn once the bulk edit ends
+            method = (RS2::RedrawMethod) (method & ~(RS2::RedrawDrawing | RS2::RedrawDirtyAreas));
+            if (RS2::RedrawNone == method) {
+                return;
+            }
+        }
         redrawMethod=(RS2::RedrawMethod ) (redrawMethod | method);
         update(); // Paint when reeady to pain
 //	repaint(); //Paint immediate
@@ -545,7 +567,7 @@ void QG_GraphicView::wheelEvent(QWheelEvent *e) {
                                                              *container, *this));
                 }
             }
-            redraw();
+            redraw(RS2::RedrawView);
         }
         e->accept();
         return;
@@ -666,7 +688,7 @@ void QG_GraphicView::wheelEvent(QWheelEvent *e) {
 												));
 		}
     }
-    redraw();
+    redraw(RS2::RedrawView);
 
     QMouseEvent* event = new QMouseEvent(QEvent::MouseMove,
                                          QPoint(e->x(), e->y()),
@@ -834,7 +856,7 @@ void QG_GraphicView::slotHScrolled(int value) {
     }
     //if (isUpdateEnabled()) {
 //         updateGrid();
-    redraw();
+    redraw(RS2::RedrawView);
 }
 
 
@@ -858,7 +880,7 @@ void QG_GraphicView::slotVScrolled(int value) {
     }
     //if (isUpdateEnabled()) {
   //  updateGrid();
-    redraw();
+    redraw(RS2::RedrawView);
 }
 /**
  * @brief setOffset
@@ -951,12 +973,24 @@ void QG_GraphicView::paintEvent(QPaintEvent *)
 {
 
     // Re-Create or get the layering pixmaps
+    bool const resized = !PixmapLayer2
+            || PixmapLayer2->size() != QSize(getWidth(), getHeight());
     getPixmapForView(PixmapLayer1);
     getPixmapForView(PixmapLayer2);
     getPixmapForView(PixmapLayer3);
+    if (resized)
+    {
+        // nothing to show until the drawing is rendered for the new size
+        PixmapLayer2->fill(Qt::transparent);
+        layer2Factor = RS_Vector(false);
+    }
+
+    // A changed view redraws the grid and overlay, but only moves or
+    // scales the drawing where possible
+    bool const viewChanged = redrawMethod & RS2::RedrawView;
 
     // Draw Layer 1
-    if (redrawMethod & RS2::RedrawGrid)
+    if (redrawMethod & RS2::RedrawGrid || viewChanged)
     {
         PixmapLayer1->fill(background);
         RS_PainterQt painter1(PixmapLayer1.get());
@@ -964,8 +998,51 @@ void QG_GraphicView::paintEvent(QPaintEvent *)
         painter1.end();
     }
 
-    if (redrawMethod & RS2::RedrawDrawing)
+    bool drawAll = redrawMethod & RS2::RedrawDrawing;
+    bool zoomPreview = false;
+    if (!drawAll && (viewChanged || redrawMethod & RS2::RedrawDirtyAreas))
+    {
+        bool const sameOffset = layer2Offset == QPoint(getOffsetX(), getOffsetY());
+        if (!layer2Factor.valid)
+        {
+            drawAll = true;
+        }
+        else if (layer2Factor != getFactor())
+        {
+            // zoomed: show the scaled drawing until the zoom comes to rest.
+            // Dirty areas can not be merged into a scaled drawing.
+            drawAll = redrawMethod & RS2::RedrawDirtyAreas;
+            zoomPreview = !drawAll;
+        }
+        else if (!sameOffset)
+        {
+            // panned: dirty areas of the old position are of no use
+            drawAll = redrawMethod & RS2::RedrawDirtyAreas || !scrollLayer2();
+        }
+    }
+
+    // new entities of an import can be added to a complete drawing only
+    if (importPending && !importDrawn && !zoomPreview)
+        drawAll = true;
+
+    // Layer 2 is out of date until the render in progress is finished. An
+    // interrupted render is resumed, unless the view or the drawing changed.
+    bool resumeRender = false;
+    if ((tileRenderer->isRunning() || renderInterrupted) && !drawAll && !zoomPreview)
+    {
+        drawAll = viewChanged || redrawMethod & RS2::RedrawDirtyAreas;
+        resumeRender = !drawAll && !tileRenderer->isRunning();
+    }
+
+    if ((drawAll || resumeRender) && startRender(resumeRender))
+    {
+        zoomTimer->stop();
+    }
+    else if (drawAll || resumeRender)
     {
+        tileRenderer->stop();
+        LC_TileRenderer::interruptOthers(tileRenderer.get());
+        renderInterrupted = false;
         view_rect = LC_Rect(toGraph(0, 0),
                             toGraph(getWidth(), getHeight()));
         // DRaw layer 2
@@ -978,12 +1055,61 @@ void QG_GraphicView::paintEvent(QPaintEvent *)
         painter2.setDrawingMode(drawingMode);
         painter2.setDrawSelectedOnly(false);
         drawLayer2((RS_Painter*)&painter2);
-        painter2.setDrawSelectedOnly(true);
-        drawLayer2((RS_Painter*)&painter2);
+        drawFileImport((RS_Painter*)&painter2, true);
         painter2.end();
+        takeDirtyAreas();
+        layer2Factor = getFactor();
+        layer2Offset = QPoint(getOffsetX(), getOffsetY());
+        zoomTimer->stop();
+    }
+    else if (zoomPreview)
+    {
+        zoomTimer->start();
+    }
+    else
+    {
+        // Redraw the changed parts of layer 2 only
+        QList<QRect> const areas = takeDirtyAreas();
+        if (!areas.isEmpty())
+        {
+            LC_TileRenderer::interruptOthers(tileRenderer.get());
+            view_rect = LC_Rect(toGraph(0, 0),
+                                toGraph(getWidth(), getHeight()));
+            RS_PainterQt painter2(PixmapLayer2.get());
+            if (antialiasing)
+            {
+                painter2.setRenderHint(QPainter::Antialiasing);
+            }
+            painter2.setDrawingMode(drawingMode);
+            painter2.setDrawSelectedOnly(false);
+            for (const QRect& area: areas)
+            {
+                painter2.setCompositionMode(QPainter::CompositionMode_Source);
+                painter2.QPainter::fillRect(area, Qt::transparent);
+                painter2.setCompositionMode(QPainter::CompositionMode_SourceOver);
+                drawLayer2((RS_Painter*)&painter2, area);
+            }
+            painter2.end();
+        }
+        // a finished render draws all entities of the import
+        if (importPending && !tileRenderer->isRunning())
+        {
+            LC_TileRenderer::interruptOthers(tileRenderer.get());
+            view_rect = LC_Rect(toGraph(0, 0),
+                                toGraph(getWidth(), getHeight()));
+            RS_PainterQt painter2(PixmapLayer2.get());
+            if (antialiasing)
+            {
+                painter2.setRenderHint(QPainter::Antialiasing);
+            }
+            painter2.setDrawingMode(drawingMode);
+            painter2.setDrawSelectedOnly(false);
+            drawFileImport((RS_Painter*)&painter2, false);
+            painter2.end();
+        }
     }
 
-    if (redrawMethod & RS2::RedrawOverlay)
+    if (redrawMethod & RS2::RedrawOverlay || viewChanged)
     {
         PixmapLayer3->fill(Qt::transparent);
         RS_PainterQt painter3(PixmapLayer3.get());
@@ -998,13 +1124,179 @@ void QG_GraphicView::paintEvent(QPaintEvent *)
     // Finally paint the layers back on the screen, bitblk to the rescue!
     RS_PainterQt wPainter(this);
     wPainter.drawPixmap(0,0,*PixmapLayer1);
-    wPainter.drawPixmap(0,0,*PixmapLayer2);
+    if (layer2Factor.valid && (layer2Factor != getFactor()
+                               || layer2Offset != QPoint(getOffsetX(), getOffsetY())))
+    {
+        // map the drawing from the view it was drawn with to the current one
+        RS_Vector const f = getFactor();
+        double const sx = f.x / layer2Factor.x;
+        double const sy = f.y / layer2Factor.y;
+        int const h = getHeight();
+        QRectF const target(getOffsetX() - layer2Offset.x() * sx,
+                            (h - getOffsetY()) - (h - layer2Offset.y()) * sy,
+                            PixmapLayer2->width() * sx,
+                            PixmapLayer2->height() * sy);
+        wPainter.QPainter::drawPixmap(target, *PixmapLayer2, QRectF(PixmapLayer2->rect()));
+    }
+    else
+    {
+        wPainter.drawPixmap(0,0,*PixmapLayer2);
+    }
     wPainter.drawPixmap(0,0,*PixmapLayer3);
     wPainter.end();
 
     redrawMethod=RS2::RedrawNone;
 }
 
+/**
+ * Starts rendering the drawing on worker threads, layer 2 shows the
+ * previous drawing until slotRenderFinished().
+ *
+ * @return false, if the drawing is better drawn on the GUI thread
+ */
+bool QG_GraphicView::startRender(bool resume)
+{
+    if (!tileRenderer->isUseful())
+        return false;
+
+    view_rect = LC_Rect(toGraph(0, 0),
+                        toGraph(getWidth(), getHeight()));
+    tileRenderer->start(antialiasing, drawingMode, resume);
+    renderInterrupted = false;
+    takeDirtyAreas();
+    return true;
+}
+
+/**
+ * Shows the drawing rendered by the tile renderer.
+ */
+void QG_GraphicView::slotRenderFinished()
+{
+    view_rect = LC_Rect(toGraph(0, 0),
+                        toGraph(getWidth(), getHeight()));
+    PixmapLayer2->fill(Qt::transparent);
+    RS_PainterQt painter2(PixmapLayer2.get());
+    if (antialiasing)
+    {
+        painter2.setRenderHint(QPainter::Antialiasing);
+    }
+    painter2.setDrawingMode(drawingMode);
+    painter2.setDrawSelectedOnly(false);
+    painter2.QPainter::drawImage(0, 0, tileRenderer->image());
+    if (!isPrintPreview())
+        drawAbsoluteZero((RS_Painter*)&painter2);
+    drawFileImport((RS_Painter*)&painter2, true);
+    painter2.end();
+    layer2Factor = getFactor();
+    layer2Offset = QPoint(getOffsetX(), getOffsetY());
+    update();
+}
+
+/**
+ * Resumes the interrupted render with the next paint.
+ */
+void QG_GraphicView::slotRenderInterrupted()
+{
+    renderInterrupted = true;
+    update();
+}
+
+/**
+ * Moves PixmapLayer2 from the offset it was drawn with to the current one
+ * and marks the uncovered strips for redrawing.
+ *
+ * @return false, if the drawing needs to be redrawn completely instead
+ */
+bool QG_GraphicView::scrollLayer2()
+{
+    int const w = getWidth();
+    int const h = getHeight();
+    int const dx = getOffsetX() - layer2Offset.x();
+    int const dy = layer2Offset.y() - getOffsetY();
+    if (std::abs(dx) >= w || std::abs(dy) >= h)
+        return false;
+
+    PixmapLayer2->scroll(dx, dy, PixmapLayer2->rect());
+    layer2Offset = QPoint(getOffsetX(), getOffsetY());
+
+    bool ret = true;
+    if (dx > 0)
+        ret = addDirtyArea(QRect(0, 0, dx, h)) && ret;
+    else if (dx < 0)
+        ret = addDirtyArea(QRect(w + dx, 0, -dx, h)) && ret;
+    if (dy > 0)
+        ret = addDirtyArea(QRect(0, 0, w, dy)) && ret;
+    else if (dy < 0)
+        ret = addDirtyArea(QRect(0, h + dy, w, -dy)) && ret;
+    return ret;
+}
+
+void QG_GraphicView::setFileImport(LC_FileImport* import)
+{
+    if (fileImport)
+        disconnect(fileImport, SIGNAL(imported()), this, SLOT(slotFileImported()));
+    fileImport = import;
+    importDrawn = false;
+    importPending = false;
+    if (fileImport)
+        connect(fileImport, SIGNAL(imported()), this, SLOT(slotFileImported()));
+    redraw(RS2::RedrawDrawing);
+}
+
+/**
+ * Draws the entities of the file import not drawn yet, or all of them.
+ */
+void QG_GraphicView::drawFileImport(RS_Painter* painter, bool all)
+{
+    importPending = false;
+    if (!fileImport)
+        return;
+
+    bool const drawn = fileImport->visitImported([this, painter](RS_Entity* e) {
+        drawEntity(painter, e);
+    }, all);
+    if (all)
+        importDrawn = drawn;
+    else if (!drawn)
+        importPending = true;
+}
+
+/**
+ * Shows new entities of the file import, zooms out while the drawing
+ * grows beyond the view.
+ */
+void QG_GraphicView::slotFileImported()
+{
+    if (!fileImport)
+        return;
+
+    RS_Vector vMin, vMax;
+    if (fileImport->getImportedBorders(vMin, vMax))
+    {
+        LC_Rect const view(toGraph(0, getHeight()), toGraph(getWidth(), 0));
+        if (!view.inArea(LC_Rect(vMin, vMax)))
+        {
+            // some room to grow, zooming redraws everything
+            RS_Vector const margin = (vMax - vMin) * 0.1;
+            zoomWindow(vMin - margin, vMax + margin);
+            return;
+        }
+    }
+    importPending = true;
+    update();
+}
+
+/**
+ * Redraws the drawing once a zoom came to rest. The scaled drawing stays
+ * on screen while the tiles are rendered in the background, small
+ * drawings are redrawn right away.
+ */
+void QG_GraphicView::slotRefineZoom()
+{
+    if (!startRender(false))
+        redraw(RS2::RedrawDrawing);
+}
+
 void QG_GraphicView::setAntialiasing(bool state)
 {
 	antialiasing = state;
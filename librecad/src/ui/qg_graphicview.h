@@ -36,6 +36,9 @@
 class QGridLayout;
 class QLabel;
 class QMenu;
+class QTimer;
+class LC_FileImport;
+class LC_TileRenderer;
 
 class QG_ScrollBar;
 
@@ -103,6 +106,13 @@ public:
     void destroyMenu(const QString& activator);
     void setMenu(const QString& activator, QMenu* menu);
 
+    /**
+     * Shows the entities of a file import in the background along with the
+     * document, which is empty while the file is read. nullptr detaches
+     * the import.
+     */
+    void setFileImport(LC_FileImport* import);
+
 protected:
 	void mousePressEvent(QMouseEvent* e) override;
 	void mouseDoubleClickEvent(QMouseEvent* e) override;
@@ -127,6 +137,10 @@ protected:
 private slots:
     void slotHScrolled(int value);
     void slotVScrolled(int value);
+    void slotRefineZoom();
+    void slotFileImported();
+    void slotRenderFinished();
+    void slotRenderInterrupted();
 
 protected:
     //! Horizontal scrollbar.
@@ -150,6 +164,17 @@ protected:
 	std::unique_ptr<QPixmap> PixmapLayer1;  // Used for grids and absolute 0
     std::unique_ptr<QPixmap> PixmapLayer2;  // Used for the actual CAD drawing
     std::unique_ptr<QPixmap> PixmapLayer3;  // Used for crosshair and actionitems
+
+	//! View factor PixmapLayer2 was drawn with
+	RS_Vector layer2Factor{false};
+	//! View offset PixmapLayer2 was drawn with
+	QPoint layer2Offset;
+	//! Redraws PixmapLayer2 after a zoom, while the zoom shows a scaled preview
+	QTimer* zoomTimer;
+	//! Draws PixmapLayer2 on worker threads
+	std::unique_ptr<LC_TileRenderer> tileRenderer;
+	//! the render of tileRenderer was interrupted and is to be resumed
+	bool renderInterrupted{false};
 	
 	RS2::RedrawMethod redrawMethod;
 		
@@ -159,10 +184,21 @@ protected:
     QMap<QString, QMenu*> menus;
 
 private:
+    bool scrollLayer2();
+    bool startRender(bool resume);
+    void drawFileImport(RS_Painter* painter, bool all);
+
     bool antialiasing{false};
     bool scrollbars{false};
     bool cursor_hiding{false};
 
+    //! file import shown by the view
+    LC_FileImport* fileImport{nullptr};
+    //! PixmapLayer2 shows all entities of fileImport visited so far
+    bool importDrawn{false};
+    //! entities of fileImport wait to be drawn
+    bool importPending{false};
+
 
 signals:
     void xbutton1_released();
@@ -44,6 +44,8 @@
 #include "rs_actionlibraryinsert.h"
 #include "qg_actionhandler.h"
 #include "rs_debug.h"
+#include "rs_graphic.h"
+#include "lc_fileimport.h"
 
 /*
  *  Constructs a QG_LibraryWidget as a child of 'parent', with the
@@ -94,6 +96,7 @@ QG_LibraryWidget::QG_LibraryWidget(QWidget* parent, const char* name, Qt::Window
  */
 QG_LibraryWidget::~QG_LibraryWidget()
 {
+    cancelThumbnails();
     // no need to delete child widgets, Qt does it all for us
 //    delete model; //??????
 /*    QStandardItemModel *model;
@@ -196,6 +199,7 @@ void QG_LibraryWidget::scanTree() {
  * (Re)build dirModel and iconModel from scratch
  */
 void QG_LibraryWidget::buildTree() {
+    cancelThumbnails();
     if (dirModel)
         delete dirModel;
     if (iconModel)
@@ -286,6 +290,7 @@ void QG_LibraryWidget::updatePreview(QModelIndex idx) {
 
     // dir from the point of view of the library browser (e.g. /mechanical/screws)
     QString directory = getItemDir(item); //RLZ change to do-while
+    cancelThumbnails();
     iconModel->clear();
 
     // List of all directories that contain part libraries:
@@ -316,10 +321,68 @@ void QG_LibraryWidget::updatePreview(QModelIndex idx) {
         QIcon icon = getIcon(directory, QFileInfo(itemPathList.at(i)).fileName(), itemPathList.at(i));
         newItem = new QStandardItem(icon, label);
         iconModel->setItem(i, newItem);
+        if (getPathToPixmap(directory, QFileInfo(itemPathList.at(i)).fileName(), itemPathList.at(i)).isEmpty())
+            thumbnails.append({QPersistentModelIndex(newItem->index()), directory, itemPathList.at(i)});
     }
+    // missing thumbnails are created in the background
+    startThumbnail();
     QApplication::restoreOverrideCursor();
 }
 
+/**
+ * Starts reading the DXF file of the next thumbnail to create.
+ */
+void QG_LibraryWidget::startThumbnail() {
+    while (!thumbnailImport && !thumbnails.isEmpty()) {
+        if (!thumbnails.front().index.isValid()) {
+            thumbnails.removeFirst();
+            continue;
+        }
+        thumbnailImport = new LC_FileImport(this);
+        connect(thumbnailImport, SIGNAL(finished(bool)), this, SLOT(slotThumbnailImported(bool)));
+        thumbnailImport->start(thumbnails.front().dxfPath);
+    }
+}
+
+/**
+ * Cancels creating thumbnails.
+ */
+void QG_LibraryWidget::cancelThumbnails() {
+    thumbnails.clear();
+    if (thumbnailImport) {
+        thumbnailImport->disconnect(this);
+        delete thumbnailImport;
+        thumbnailImport = nullptr;
+    }
+}
+
+/**
+ * Creates the thumbnail of a DXF file read in the background and shows it.
+ */
+void QG_LibraryWidget::slotThumbnailImported(bool success) {
+    if (!thumbnailImport || thumbnails.isEmpty())
+        return;
+
+    Thumbnail const thumbnail = thumbnails.takeFirst();
+    RS_Graphic graphic;
+    if (success && thumbnailImport->takeGraphic(graphic)) {
+        QString const pngPath = createPixmap(graphic, thumbnail.dir, thumbnail.dxfPath);
+        if (!pngPath.isEmpty() && thumbnail.index.isValid()) {
+            QStandardItem* item = iconModel->itemFromIndex(thumbnail.index);
+            if (item)
+                item->setIcon(QIcon(pngPath));
+        }
+    } else {
+        RS_DEBUG->print(RS_Debug::D_ERROR,
+                        "QG_LibraryWidget::slotThumbnailImported: Cannot open file: '%s'",
+                        thumbnail.dxfPath.toLatin1().data());
+    }
+
+    delete thumbnailImport;
+    thumbnailImport = nullptr;
+    startThumbnail();
+}
+
  //RLZ change to do-while
 /**
  * @return Directory (in terms of the List view) to the given item (e.g. /mechanical/screws)
@@ -395,8 +458,8 @@ QIcon QG_LibraryWidget::getIcon(const QString& dir, const QString& dxfFile,
 
 
 /**
- * @return Path to the thumbnail of the given DXF file. If no thumbnail exists, one is
- * created in the user's home. If no thumbnail can be created, an empty string is returned.
+ * @return Path to the thumbnail of the given DXF file. If no up to date thumbnail
+ * exists, an empty string is returned.
  */
 QString QG_LibraryWidget::getPathToPixmap(const QString& dir,
         const QString& dxfFile,
@@ -442,11 +505,26 @@ QString QG_LibraryWidget::getPathToPixmap(const QString& dir,
         }
     }
 
+    return "";
+}
+
+
+
+/**
+ * Creates the thumbnail of a DXF file in the user's home.
+ *
+ * @param graphic The drawing read from the DXF file
+ * @return Path to the thumbnail or an empty string, if no thumbnail can be created.
+ */
+QString QG_LibraryWidget::createPixmap(RS_Graphic& graphic, const QString& dir,
+                                       const QString& dxfPath) {
+
+    QString iconCacheLocation=QStandardPaths::writableLocation(QStandardPaths::DataLocation) + QDir::separator() + "iconCache" + QDir::separator();
+
     // create all directories needed:
     RS_SYSTEM->createPaths(iconCacheLocation + dir);
 
-//    QString foo=iconCacheLocation + dir + QDir::separator() + fiDxf.baseName() + ".png";
-    pngPath = iconCacheLocation + dir + QDir::separator() + fiDxf.baseName() + ".png";
+    QString pngPath = iconCacheLocation + dir + QDir::separator() + QFileInfo(dxfPath).baseName() + ".png";
 
     QPixmap* buffer = new QPixmap(128,128);
     RS_PainterQt painter(buffer);
@@ -454,39 +532,32 @@ QString QG_LibraryWidget::getPathToPixmap(const QString& dir,
     painter.eraseRect(0,0, 128,128);
 
     RS_StaticGraphicView gv(128,128, &painter);
-    RS_Graphic graphic;
-    if (graphic.open(dxfPath, RS2::FormatUnknown)) {
-        gv.setContainer(&graphic);
-        gv.zoomAuto(false);
-        // gv.drawEntity(&graphic, true);
-
-        for (RS_Entity* e=graphic.firstEntity(RS2::ResolveAll);
-                e; e=graphic.nextEntity(RS2::ResolveAll)) {
-            if (e->rtti() != RS2::EntityHatch){
-                RS_Pen pen = e->getPen();
-                pen.setColor(Qt::black);
-                e->setPen(pen);
-            }
-            gv.drawEntity(&painter, e);
+    gv.setContainer(&graphic);
+    gv.zoomAuto(false);
+    // gv.drawEntity(&graphic, true);
+
+    for (RS_Entity* e=graphic.firstEntity(RS2::ResolveAll);
+            e; e=graphic.nextEntity(RS2::ResolveAll)) {
+        if (e->rtti() != RS2::EntityHatch){
+            RS_Pen pen = e->getPen();
+            pen.setColor(Qt::black);
+            e->setPen(pen);
         }
+        gv.drawEntity(&painter, e);
+    }
 
-        QImageWriter iio;
-        QImage img;
-        img = buffer->toImage();
-        img = img.scaled(64,64, Qt::IgnoreAspectRatio, Qt::SmoothTransformation );
-        // iio.setImage(img);
-        iio.setFileName(pngPath);
-        iio.setFormat("PNG");
-        if (!iio.write(img)) {
-            pngPath = "";
-            RS_DEBUG->print(RS_Debug::D_ERROR,
-                            "QG_LibraryWidget::getPathToPixmap: Cannot write thumbnail: '%s'",
-                            pngPath.toLatin1().data());
-        }
-    } else {
+    QImageWriter iio;
+    QImage img;
+    img = buffer->toImage();
+    img = img.scaled(64,64, Qt::IgnoreAspectRatio, Qt::SmoothTransformation );
+    // iio.setImage(img);
+    iio.setFileName(pngPath);
+    iio.setFormat("PNG");
+    if (!iio.write(img)) {
         RS_DEBUG->print(RS_Debug::D_ERROR,
-                        "QG_LibraryWidget::getPathToPixmap: Cannot open file: '%s'",
-                        dxfPath.toLatin1().data());
+                        "QG_LibraryWidget::createPixmap: Cannot write thumbnail: '%s'",
+                        pngPath.toLatin1().data());
+        pngPath = "";
     }
 
     // GraphicView deletes painter
@@ -28,8 +28,11 @@
 
 #include <QWidget>
 #include <QModelIndex>
+#include <QPersistentModelIndex>
 
+class LC_FileImport;
 class QG_ActionHandler;
+class RS_Graphic;
 class QStandardItemModel;
 class QStandardItem;
 class QTreeView;
@@ -50,6 +53,9 @@ private:
     virtual QString getItemPath( QStandardItem * item );
     virtual QIcon getIcon( const QString & dir, const QString & dxfFile, const QString & dxfPath );
     virtual QString getPathToPixmap( const QString & dir, const QString & dxfFile, const QString & dxfPath );
+    QString createPixmap(RS_Graphic& graphic, const QString& dir, const QString& dxfPath);
+    void startThumbnail();
+    void cancelThumbnails();
 
 public slots:
     virtual void setActionHandler( QG_ActionHandler * ah );
@@ -69,6 +75,9 @@ signals:
 protected slots:
     virtual void languageChange();
 
+private slots:
+    void slotThumbnailImported(bool success);
+
 private:
     QG_ActionHandler* actionHandler;
     QStandardItemModel *dirModel {nullptr};
@@ -77,6 +86,16 @@ private:
     QListView *ivPreview;
     QPushButton *bRefresh;
     QPushButton *bRebuild;
+
+    /** item of the icon view without an up to date thumbnail */
+    struct Thumbnail {
+        QPersistentModelIndex index;
+        QString dir;
+        QString dxfPath;
+    };
+    /** thumbnails to create, the first one is read by thumbnailImport */
+    QList<Thumbnail> thumbnails;
+    LC_FileImport* thumbnailImport {nullptr};
 };
 
 #endif // QG_LIBRARYWIDGET_H